@@ -21,6 +21,7 @@
 #include "scene/integrator.h"
 #include "scene/scene.h"
 #include "session/buffers.h"
+#include "session/merge.h"
 #include "session/session.h"
 
 #include "util/args.h"
@@ -31,6 +32,8 @@
 #include "util/path.h"
 #include "util/progress.h"
 #include "util/string.h"
+#include "util/system.h"
+#include "util/thread.h"
 #include "util/time.h"
 #include "util/transform.h"
 #include "util/unique_ptr.h"
@@ -51,6 +54,7 @@ struct Options {
   Session *session;
   Scene *scene;
   string filepath;
+  vector<string> merge_filepaths;
   int width, height;
   SceneParams scene_params;
   SessionParams session_params;
@@ -58,6 +62,8 @@ struct Options {
   bool show_help, interactive, pause;
   string output_filepath;
   string output_pass;
+  int workers;
+  bool merge;
 } options;
 
 static void session_print(const string &str)
@@ -341,12 +347,110 @@ static void keyboard(unsigned char key)
 
 static int files_parse(int argc, const char *argv[])
 {
-  if (argc > 0)
-    options.filepath = argv[0];
+  if (argc > 0) {
+    if (options.filepath.empty()) {
+      options.filepath = argv[0];
+    }
+    options.merge_filepaths.push_back(argv[0]);
+  }
 
   return 0;
 }
 
+/* Distributed Rendering
+ *
+ * The samples of the frame are split into ranges, each rendered by a separate process. The
+ * images of all processes are merged weighted by their number of samples. Processes on other
+ * machines can render their range with --sample-offset and --samples, and the resulting images
+ * be merged with --merge. */
+
+static bool image_merge(const vector<string> &filepaths)
+{
+  ImageMerger merger;
+  merger.input = filepaths;
+  merger.output = options.output_filepath;
+
+  if (!merger.run()) {
+    fprintf(stderr, "Failed to merge images: %s\n", merger.error.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+static bool render_workers(int argc, const char **argv)
+{
+  const int num_workers = max(min(options.workers, options.session_params.samples), 1);
+  const int num_samples = options.session_params.samples;
+
+  /* Give every worker an equal share of the CPU threads, unless specified. */
+  const int num_threads = (options.session_params.threads > 0) ?
+                              options.session_params.threads :
+                              max(system_cpu_thread_count() / num_workers, 1);
+
+  /* Workers are spawned from threads running on different NUMA nodes, from which they inherit
+   * the processor affinity where supported. */
+  const int num_nodes = system_cpu_num_numa_nodes();
+
+  vector<string> worker_filepaths(num_workers);
+  /* Not a vector of bool, which can't be written from multiple threads. */
+  vector<int> worker_success(num_workers, false);
+  vector<unique_ptr<thread>> worker_threads;
+
+  printf("Rendering %d samples with %d worker processes\n", num_samples, num_workers);
+
+  for (int i = 0; i < num_workers; i++) {
+    const int sample_offset = options.session_params.sample_offset +
+                              (int)((int64_t)num_samples * i / num_workers);
+    const int sample_end = options.session_params.sample_offset +
+                           (int)((int64_t)num_samples * (i + 1) / num_workers);
+
+    worker_filepaths[i] = string_printf("%s.worker%d.exr", options.output_filepath.c_str(), i);
+
+    /* Later options override earlier ones, so the original arguments are passed unchanged. */
+    vector<string> args(argv + 1, argv + argc);
+    args.push_back("--background");
+    args.push_back("--quiet");
+    args.push_back("--workers");
+    args.push_back("1");
+    args.push_back("--threads");
+    args.push_back(string_printf("%d", num_threads));
+    args.push_back("--sample-offset");
+    args.push_back(string_printf("%d", sample_offset));
+    args.push_back("--samples");
+    args.push_back(string_printf("%d", sample_end - sample_offset));
+    args.push_back("--output");
+    args.push_back(worker_filepaths[i]);
+
+    VLOG(1) << "Starting worker " << i << " for samples " << sample_offset << " to "
+            << sample_end;
+
+    worker_threads.push_back(make_unique<thread>(
+        [args, &worker_success, i]() { worker_success[i] = system_call_self(args); },
+        (num_nodes > 1) ? i % num_nodes : -1));
+  }
+
+  bool success = true;
+  for (int i = 0; i < num_workers; i++) {
+    worker_threads[i]->join();
+    if (!worker_success[i] || !path_exists(worker_filepaths[i])) {
+      fprintf(stderr, "Worker %d failed to render\n", i);
+      success = false;
+    }
+  }
+
+  if (success) {
+    printf("Merging images into %s\n", options.output_filepath.c_str());
+    success = image_merge(worker_filepaths);
+  }
+
+  foreach (const string &filepath, worker_filepaths) {
+    path_remove(filepath);
+  }
+
+  return success;
+}
+
 static void options_parse(int argc, const char **argv)
 {
   options.width = 1024;
@@ -356,6 +460,8 @@ static void options_parse(int argc, const char **argv)
   options.quiet = false;
   options.session_params.use_auto_tile = false;
   options.session_params.tile_size = 0;
+  options.workers = 1;
+  options.merge = false;
 
   /* device names */
   string device_names = "";
@@ -400,6 +506,15 @@ static void options_parse(int argc, const char **argv)
              "--samples %d",
              &options.session_params.samples,
              "Number of samples to render",
+             "--sample-offset %d",
+             &options.session_params.sample_offset,
+             "Start rendering from this sample, to render part of the samples",
+             "--workers %d",
+             &options.workers,
+             "Split samples over this number of processes, and merge their images",
+             "--merge",
+             &options.merge,
+             "Merge the given images rendered with different samples, instead of rendering",
              "--output %s",
              &options.output_filepath,
              "File path to write output image",
@@ -415,6 +530,15 @@ static void options_parse(int argc, const char **argv)
              "--tile-size %d",
              &options.session_params.tile_size,
              "Tile size in pixels",
+             "--bvh-cache %s",
+             &options.scene_params.bvh_cache_path,
+             "Directory to cache built BVHs in",
+             "--bvh-cache-size %d",
+             &options.scene_params.bvh_cache_size,
+             "Size limit of the BVH cache directory in megabytes",
+             "--compact-geometry",
+             &options.scene_params.use_compact_geometry,
+             "Store mesh geometry in a compact layout to reduce memory usage (CPU only)",
              "--list-devices",
              &list,
              "List information about all available devices",
@@ -514,6 +638,10 @@ static void options_parse(int argc, const char **argv)
     fprintf(stderr, "No file path specified\n");
     exit(EXIT_FAILURE);
   }
+  else if ((options.merge || options.workers > 1) && options.output_filepath.empty()) {
+    fprintf(stderr, "No output file path specified\n");
+    exit(EXIT_FAILURE);
+  }
 }
 
 CCL_NAMESPACE_END
@@ -526,6 +654,13 @@ int main(int argc, const char **argv)
   path_init();
   options_parse(argc, argv);
 
+  if (options.merge) {
+    return image_merge(options.merge_filepaths) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (options.workers > 1) {
+    return render_workers(argc, argv) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
   if (options.session_params.background) {
 #endif
@@ -48,6 +48,12 @@ void OIIOOutputDriver::write_render_tile(const Tile &tile)
   const int height = tile.size.y;
 
   ImageSpec spec(width, height, 4, TypeDesc::FLOAT);
+  if (tile.num_samples > 0) {
+    /* Same metadata as written by Blender, read when merging images. This is the number of
+     * samples actually rendered, which is lower than requested when rendering stopped early. */
+    const string layer = tile.layer.empty() ? "RenderLayer" : tile.layer;
+    spec.attribute("cycles." + layer + ".samples", string_printf("%d", tile.num_samples));
+  }
   if (!image_output->open(filepath_, spec)) {
     log_("Failed to create image file");
     return;
@@ -28,6 +28,8 @@ class OIIOOutputDriver : public OutputDriver {
  public:
   typedef function<void(const string &)> LogFunction;
 
+  /* The number of rendered samples is stored in the image metadata, so that images rendered
+   * with different sample ranges can be merged. */
   OIIOOutputDriver(const string_view filepath, const string_view pass, LogFunction log);
   virtual ~OIIOOutputDriver();
 
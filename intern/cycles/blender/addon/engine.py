@@ -26,6 +26,10 @@ def _configure_argument_parser():
     parser.add_argument("--cycles-print-stats",
                         help="Print rendering statistics to stderr",
                         action='store_true')
+    parser.add_argument("--cycles-sync-profile",
+                        help="Write the time spent synchronizing and updating every object to a JSON file "
+                             "in the Chrome trace event format. A run of '#' is replaced by the frame number",
+                        default=None)
     parser.add_argument("--cycles-device",
                         help="Set the device to use for Cycles, overriding user preferences and the scene setting."
                              "Valid options are 'CPU', 'CUDA', 'OPTIX', or 'HIP'"
@@ -48,6 +52,10 @@ def _parse_command_line():
         import _cycles
         _cycles.enable_print_stats()
 
+    if args.cycles_sync_profile:
+        import _cycles
+        _cycles.enable_sync_profile(args.cycles_sync_profile)
+
     if args.cycles_device:
         import _cycles
         _cycles.set_device_override(args.cycles_device)
@@ -161,6 +169,23 @@ def view_draw(engine, depsgraph, region, v3d, rv3d):
     _cycles.view_draw(engine.session, depsgraph, v3d, rv3d)
 
 
+def enable_sync_profile(filepath=""):
+    # Collect the time spent synchronizing and updating every object in final renders
+    # from the command line, and optionally write it to a file after every render.
+    import _cycles
+    _cycles.enable_sync_profile(filepath)
+
+
+def sync_profile(engine):
+    # Time spent synchronizing and updating every object in the last final render,
+    # as JSON in the Chrome trace event format, or None if it was not collected.
+    if not engine.session:
+        return None
+
+    import _cycles
+    return _cycles.sync_profile(engine.session)
+
+
 def available_devices():
     import _cycles
     return _cycles.available_devices()
@@ -388,6 +388,13 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default=0.01,
     )
 
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Sample multiple lights more efficiently based on estimated contribution at every shading point. "
+        "Improves noise in scenes with many lights, at the cost of a slightly slower light sampling",
+        default=False,
+    )
+
     use_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
         description="Automatically reduce the number of samples per pixel based on estimated noise level",
@@ -408,6 +415,24 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default=0,
     )
 
+    use_guiding: BoolProperty(
+        name="Path Guiding",
+        description="Learn the distribution of incident light during rendering, and use it to sample bounce directions on surfaces (CPU only)",
+        default=False,
+    )
+    guiding_probability: FloatProperty(
+        name="Guiding Probability",
+        description="Probability of sampling the bounce direction from the learned distribution rather than from the BSDF",
+        min=0.0, max=0.95,
+        default=0.5,
+    )
+    guiding_training_samples: IntProperty(
+        name="Training Samples",
+        description="Number of samples at the start of rendering used to learn the distribution of incident light",
+        min=1, max=1 << 24,
+        default=128,
+    )
+
     use_preview_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
         description="Automatically reduce the number of samples per pixel based on estimated noise level, for viewport renders",
@@ -669,6 +694,20 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default=0,
         min=0, max=16,
     )
+    bvh_cache_path: StringProperty(
+        name="BVH Cache",
+        description="Directory to store built BVHs in, to load them instead of building them again "
+        "in following renders with the same geometry. Only used for the Cycles BVH, not for Embree or OptiX",
+        subtype='DIR_PATH',
+        default="",
+    )
+    bvh_cache_size: IntProperty(
+        name="BVH Cache Size",
+        description="Maximum size of the BVH cache directory in megabytes. The least recently used BVHs are removed first",
+        default=8192,
+        min=16, max=1048576,
+        subtype='UNSIGNED',
+    )
 
     bake_type: EnumProperty(
         name="Bake Type",
@@ -801,6 +840,27 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=8, max=16384,
     )
 
+    use_texture_cache: BoolProperty(
+        name="Use Texture Cache",
+        description="Read image textures from disk on demand, loading only the tiles and mipmap levels needed for rendering. "
+        "Works best with tiled and mipmapped files such as .tx or tiled OpenEXR. Only supported for CPU rendering with SVM",
+        default=False,
+    )
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        description="Maximum memory used by the texture cache, in megabytes",
+        default=4096,
+        min=16, max=1048576,
+        subtype='UNSIGNED',
+    )
+
+    use_compact_geometry: BoolProperty(
+        name="Compact Geometry",
+        description="Store mesh vertices and normals in a more compact layout to reduce memory usage, "
+        "at a small cost in render time. Only supported for CPU rendering",
+        default=False,
+    )
+
     # Various fine-tuning debug flags
 
     def _devices_update_callback(self, context):
@@ -818,6 +878,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_bvh_layouts,
         default='EMBREE',
     )
+    debug_use_cpu_wavefront: BoolProperty(
+        name="Wavefront",
+        description="Trace batches of paths together, executing the same kernel for all paths in a batch",
+        default=False,
+    )
 
     debug_use_cuda_adaptive_compile: BoolProperty(name="Adaptive Compile", default=False)
 
@@ -269,6 +269,31 @@ class CYCLES_RENDER_PT_sampling_render_denoise(CyclesButtonsPanel, Panel):
             col.prop(cscene, "denoising_prefilter", text="Prefilter")
 
 
+class CYCLES_RENDER_PT_sampling_path_guiding(CyclesButtonsPanel, Panel):
+    bl_label = "Path Guiding"
+    bl_parent_id = "CYCLES_RENDER_PT_sampling"
+    bl_options = {'DEFAULT_CLOSED'}
+
+    @classmethod
+    def poll(cls, context):
+        return CyclesButtonsPanel.poll(context) and use_cpu(context)
+
+    def draw_header(self, context):
+        self.layout.prop(context.scene.cycles, "use_guiding", text="")
+
+    def draw(self, context):
+        layout = self.layout
+        layout.use_property_split = True
+        layout.use_property_decorate = False
+
+        cscene = context.scene.cycles
+
+        col = layout.column(align=True)
+        col.active = cscene.use_guiding
+        col.prop(cscene, "guiding_probability", text="Probability")
+        col.prop(cscene, "guiding_training_samples")
+
+
 class CYCLES_RENDER_PT_sampling_advanced(CyclesButtonsPanel, Panel):
     bl_label = "Advanced"
     bl_parent_id = "CYCLES_RENDER_PT_sampling"
@@ -309,6 +334,7 @@ class CYCLES_RENDER_PT_sampling_advanced(CyclesButtonsPanel, Panel):
         col.prop(cscene, "min_light_bounces")
         col.prop(cscene, "min_transparent_bounces")
         col.prop(cscene, "light_sampling_threshold", text="Light Threshold")
+        col.prop(cscene, "use_light_tree")
 
         for view_layer in scene.view_layers:
             if view_layer.samples > 0:
@@ -657,6 +683,17 @@ class CYCLES_RENDER_PT_performance_memory(CyclesButtonsPanel, Panel):
         sub.active = cscene.use_auto_tile
         sub.prop(cscene, "tile_size")
 
+        col = layout.column()
+        col.active = use_cpu(context) and not cscene.shading_system
+        col.prop(cscene, "use_texture_cache")
+        sub = col.column()
+        sub.active = cscene.use_texture_cache
+        sub.prop(cscene, "texture_cache_size")
+
+        col = layout.column()
+        col.active = use_cpu(context)
+        col.prop(cscene, "use_compact_geometry")
+
 
 class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Panel):
     bl_label = "Acceleration Structure"
@@ -689,6 +726,10 @@ class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Pa
         sub = col.column()
         sub.active = not cscene.debug_use_spatial_splits and not use_embree
         sub.prop(cscene, "debug_bvh_time_steps")
+        sub = col.column()
+        sub.active = not use_embree
+        sub.prop(cscene, "bvh_cache_path")
+        sub.prop(cscene, "bvh_cache_size")
 
 
 class CYCLES_RENDER_PT_performance_final_render(CyclesButtonsPanel, Panel):
@@ -1834,6 +1875,7 @@ class CYCLES_RENDER_PT_debug(CyclesDebugButtonsPanel, Panel):
         row.prop(cscene, "debug_use_cpu_avx", toggle=True)
         row.prop(cscene, "debug_use_cpu_avx2", toggle=True)
         col.prop(cscene, "debug_bvh_layout", text="BVH")
+        col.prop(cscene, "debug_use_cpu_wavefront")
 
         col.separator()
 
@@ -2109,6 +2151,7 @@ classes = (
     CYCLES_RENDER_PT_sampling_viewport_denoise,
     CYCLES_RENDER_PT_sampling_render,
     CYCLES_RENDER_PT_sampling_render_denoise,
+    CYCLES_RENDER_PT_sampling_path_guiding,
     CYCLES_RENDER_PT_sampling_advanced,
     CYCLES_RENDER_PT_light_paths,
     CYCLES_RENDER_PT_light_paths_max_bounces,
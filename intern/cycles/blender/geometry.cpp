@@ -19,12 +19,16 @@
 #include "scene/hair.h"
 #include "scene/mesh.h"
 #include "scene/object.h"
+#include "scene/stats.h"
 #include "scene/volume.h"
 
 #include "blender/sync.h"
 #include "blender/util.h"
 
 #include "util/foreach.h"
+#include "util/hash.h"
+#include "util/log.h"
+#include "util/murmurhash.h"
 #include "util/task.h"
 
 CCL_NAMESPACE_BEGIN
@@ -48,6 +52,19 @@ static Geometry::Type determine_geom_type(BObjectInfo &b_ob_info, bool use_parti
   return Geometry::MESH;
 }
 
+static Geometry *create_geometry(Scene *scene, Geometry::Type geom_type)
+{
+  if (geom_type == Geometry::HAIR) {
+    return scene->create_node<Hair>();
+  }
+  else if (geom_type == Geometry::VOLUME) {
+    return scene->create_node<Volume>();
+  }
+  else {
+    return scene->create_node<Mesh>();
+  }
+}
+
 array<Node *> BlenderSync::find_used_shaders(BL::Object &b_ob)
 {
   BL::Material material_override = view_layer.material_override;
@@ -105,15 +122,7 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
   bool sync = true;
   if (geom == NULL) {
     /* Add new geometry if it did not exist yet. */
-    if (geom_type == Geometry::HAIR) {
-      geom = scene->create_node<Hair>();
-    }
-    else if (geom_type == Geometry::VOLUME) {
-      geom = scene->create_node<Volume>();
-    }
-    else {
-      geom = scene->create_node<Mesh>();
-    }
+    geom = create_geometry(scene, geom_type);
     geometry_map.add(key, geom);
   }
   else {
@@ -149,6 +158,13 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
     }
   }
 
+  /* Geometry shared with other keys after deduplication is not synced in place, since the other
+   * keys still use its content. */
+  if (geometry_shared.find(geom) != geometry_shared.end()) {
+    geom = create_geometry(scene, geom_type);
+    geometry_map.assign(key, geom);
+  }
+
   geometry_synced.insert(geom);
 
   geom->name = ustring(b_ob_info.object_data.name().c_str());
@@ -162,6 +178,15 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
 
     progress.set_sync_status("Synchronizing object", b_ob_info.real_object.name());
 
+    scoped_callback_timer timer([this, geom_type, geom](double time) {
+      if (scene->update_stats) {
+        const char *stage = (geom_type == Geometry::HAIR)   ? "Hair Export" :
+                            (geom_type == Geometry::VOLUME) ? "Volume Export" :
+                                                              "Mesh Export";
+        scene->update_stats->timeline.add_entry(stage, geom->name.string(), time);
+      }
+    });
+
     if (geom_type == Geometry::HAIR) {
       Hair *hair = static_cast<Hair *>(geom);
       sync_hair(b_depsgraph, b_ob_info, hair);
@@ -219,6 +244,12 @@ void BlenderSync::sync_geometry_motion(BL::Depsgraph &b_depsgraph,
     if (progress.get_cancel())
       return;
 
+    scoped_callback_timer timer([this, geom](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->timeline.add_entry("Motion Export", geom->name.string(), time);
+      }
+    });
+
 #ifdef WITH_HAIR_NODES
     if (b_ob_info.object_data.is_a(&RNA_Hair) || use_particle_hair) {
 #else
@@ -246,4 +277,152 @@ void BlenderSync::sync_geometry_motion(BL::Depsgraph &b_depsgraph,
   }
 }
 
+/* Geometry Deduplication
+ *
+ * Different datablocks may evaluate to identical meshes, for example when geometry nodes
+ * realize the same asset onto many objects. After syncing, meshes with identical content share
+ * a single geometry, so that it is only stored and built into a BVH once. */
+
+static bool mesh_can_deduplicate(const Geometry *geom)
+{
+  if (geom->geometry_type != Geometry::MESH) {
+    return false;
+  }
+
+  const Mesh *mesh = static_cast<const Mesh *>(geom);
+
+  /* Subdivision is diced per object, and deformation motion is synced per object after this. The
+   * content of geometry with applied transform depends on its object. */
+  return mesh->get_subdivision_type() == Mesh::SUBDIVISION_NONE &&
+         mesh->get_motion_steps() == 0 && !mesh->transform_applied;
+}
+
+static uint hash_data(const void *data, size_t size, uint seed)
+{
+  /* Murmur hash takes an int size, so hash large arrays in chunks. */
+  const uint8_t *bytes = (const uint8_t *)data;
+  const size_t chunk_size = 1 << 30;
+  uint hash = hash_uint2(seed, (uint)size);
+  while (size > 0) {
+    const size_t hash_size = (size < chunk_size) ? size : chunk_size;
+    hash = util_murmur_hash3(bytes, (int)hash_size, hash);
+    bytes += hash_size;
+    size -= hash_size;
+  }
+  return hash;
+}
+
+template<typename T> static uint hash_array(const array<T> &data, uint seed)
+{
+  return hash_data(data.data(), data.size() * sizeof(T), seed);
+}
+
+/* Hash of the topology and the positions, which identifies candidates for deduplication. */
+static uint mesh_content_hash(const Mesh *mesh)
+{
+  uint topology_hash = hash_array(mesh->get_triangles(), 0);
+  topology_hash = hash_array(mesh->get_shader(), topology_hash);
+  topology_hash = hash_array(mesh->get_used_shaders(), topology_hash);
+
+  const uint position_hash = hash_array(mesh->get_verts(), 0);
+
+  return hash_uint2(topology_hash, position_hash);
+}
+
+template<typename T> static bool array_equal(const array<T> &a, const array<T> &b)
+{
+  return a.size() == b.size() &&
+         (a.size() == 0 || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+static bool mesh_content_equal(const Mesh *a, const Mesh *b)
+{
+  if (!(array_equal(a->get_triangles(), b->get_triangles()) &&
+        array_equal(a->get_verts(), b->get_verts()) &&
+        array_equal(a->get_shader(), b->get_shader()) &&
+        array_equal(a->get_smooth(), b->get_smooth()) &&
+        array_equal(a->get_used_shaders(), b->get_used_shaders()))) {
+    return false;
+  }
+
+  /* Attributes are added in the same order for identical data. */
+  const list<Attribute> &attributes_a = a->attributes.attributes;
+  const list<Attribute> &attributes_b = b->attributes.attributes;
+  if (attributes_a.size() != attributes_b.size()) {
+    return false;
+  }
+
+  list<Attribute>::const_iterator it_a = attributes_a.begin();
+  list<Attribute>::const_iterator it_b = attributes_b.begin();
+  for (; it_a != attributes_a.end(); ++it_a, ++it_b) {
+    if (it_a->name != it_b->name || it_a->std != it_b->std || it_a->type != it_b->type ||
+        it_a->element != it_b->element || it_a->flags != it_b->flags ||
+        it_a->buffer != it_b->buffer) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void BlenderSync::deduplicate_geometry()
+{
+  /* Candidates are all geometry which was not deduplicated itself, hashed when it was synced. */
+  unordered_multimap<uint, Mesh *> candidates;
+  for (const pair<Geometry *const, uint> &it : geometry_content_hash) {
+    if (geometry_synced.find(it.first) == geometry_synced.end()) {
+      candidates.insert(std::make_pair(it.second, static_cast<Mesh *>(it.first)));
+    }
+  }
+
+  map<Geometry *, Geometry *> duplicates;
+
+  foreach (Geometry *geom, geometry_synced) {
+    if (!mesh_can_deduplicate(geom)) {
+      geometry_content_hash.erase(geom);
+      continue;
+    }
+
+    Mesh *mesh = static_cast<Mesh *>(geom);
+    const uint hash = mesh_content_hash(mesh);
+
+    Mesh *original = NULL;
+    auto range = candidates.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (mesh_can_deduplicate(it->second) && mesh_content_equal(mesh, it->second)) {
+        original = it->second;
+        break;
+      }
+    }
+
+    if (original) {
+      duplicates[geom] = original;
+      geometry_content_hash.erase(geom);
+    }
+    else {
+      candidates.insert(std::make_pair(hash, mesh));
+      geometry_content_hash[geom] = hash;
+    }
+  }
+
+  if (duplicates.empty()) {
+    return;
+  }
+
+  foreach (Object *object, scene->objects) {
+    map<Geometry *, Geometry *>::iterator it = duplicates.find(object->get_geometry());
+    if (it != duplicates.end()) {
+      object->set_geometry(it->second);
+    }
+  }
+
+  for (const pair<Geometry *const, Geometry *> &it : duplicates) {
+    /* The duplicate is deleted in post_sync, once no key maps to it anymore. */
+    geometry_map.replace(it.first, it.second);
+    geometry_synced.erase(it.first);
+  }
+
+  VLOG(1) << "Deduplicated " << duplicates.size() << " geometries with identical content.";
+}
+
 CCL_NAMESPACE_END
@@ -22,6 +22,7 @@
 #include "scene/geometry.h"
 #include "scene/scene.h"
 
+#include "util/foreach.h"
 #include "util/map.h"
 #include "util/set.h"
 #include "util/vector.h"
@@ -47,6 +48,7 @@ template<typename K, typename T> class id_map {
     for (jt = b_map.begin(); jt != b_map.end(); jt++) {
       nodes.insert(jt->second);
     }
+    nodes.insert(replaced_set.begin(), replaced_set.end());
 
     scene->delete_nodes(nodes);
   }
@@ -109,6 +111,36 @@ template<typename K, typename T> class id_map {
     return recalc;
   }
 
+  /* Map the key to other existing data. Multiple keys may share the same data, data which is
+   * no longer mapped to by any key is deleted in post_sync. */
+  void assign(const K &key, T *data)
+  {
+    typename map<K, T *>::iterator it = b_map.find(key);
+    if (it != b_map.end()) {
+      if (it->second != data) {
+        replaced_set.insert(it->second);
+      }
+      it->second = data;
+    }
+    else {
+      b_map[key] = data;
+    }
+    used(data);
+  }
+
+  /* Map all keys of the data to other existing data. */
+  void replace(T *data, T *new_data)
+  {
+    typename map<K, T *>::iterator jt;
+    for (jt = b_map.begin(); jt != b_map.end(); jt++) {
+      if (jt->second == data) {
+        jt->second = new_data;
+      }
+    }
+    replaced_set.insert(data);
+    used(new_data);
+  }
+
   /* Combined add and update as needed. */
   bool add_or_update(T **r_data, const BL::ID &id)
   {
@@ -160,6 +192,8 @@ template<typename K, typename T> class id_map {
   void post_sync(bool do_delete = true)
   {
     map<K, T *> new_map;
+    set<T *> new_nodes;
+    set<T *> delete_nodes;
     typedef pair<const K, T *> TMapPair;
     typename map<K, T *>::iterator jt;
 
@@ -167,14 +201,30 @@ template<typename K, typename T> class id_map {
       TMapPair &pair = *jt;
 
       if (do_delete && used_set.find(pair.second) == used_set.end()) {
-        scene->delete_node(pair.second);
+        /* Data may be shared by multiple keys, ensure it is only deleted once. */
+        delete_nodes.insert(pair.second);
       }
       else {
         new_map[pair.first] = pair.second;
+        new_nodes.insert(pair.second);
+      }
+    }
+
+    /* Data which was replaced for all of its keys. */
+    if (do_delete) {
+      foreach (T *data, replaced_set) {
+        if (new_nodes.find(data) == new_nodes.end()) {
+          delete_nodes.insert(data);
+        }
       }
     }
 
+    foreach (T *data, delete_nodes) {
+      scene->delete_node(data);
+    }
+
     used_set.clear();
+    replaced_set.clear();
     b_recalc.clear();
     b_map = new_map;
   }
@@ -187,6 +237,7 @@ template<typename K, typename T> class id_map {
  protected:
   map<K, T *> b_map;
   set<T *> used_set;
+  set<T *> replaced_set;
   set<void *> b_recalc;
   Scene *scene;
 };
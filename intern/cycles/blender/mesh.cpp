@@ -23,6 +23,7 @@
 #include "scene/mesh.h"
 #include "scene/object.h"
 #include "scene/scene.h"
+#include "scene/stats.h"
 
 #include "subd/patch.h"
 #include "subd/split.h"
@@ -1014,6 +1015,12 @@ static void create_mesh(Scene *scene,
   /* Create all needed attributes.
    * The calculate functions will check whether they're needed or not.
    */
+  scoped_callback_timer timer([scene, mesh](double time) {
+    if (scene->update_stats) {
+      scene->update_stats->timeline.add_entry("Attribute Copy", mesh->name.string(), time);
+    }
+  });
+
   attr_create_pointiness(scene, mesh, b_mesh, subdivision);
   attr_create_vertex_color(scene, mesh, b_mesh, subdivision);
   attr_create_sculpt_vertex_color(scene, mesh, b_mesh, subdivision);
@@ -1127,6 +1134,7 @@ void BlenderSync::sync_mesh(BL::Depsgraph b_depsgraph, BObjectInfo &b_ob_info, M
   array<Node *> used_shaders = mesh->get_used_shaders();
 
   Mesh new_mesh;
+  new_mesh.name = mesh->name;
   new_mesh.set_used_shaders(used_shaders);
 
   if (view_layer.use_surfaces) {
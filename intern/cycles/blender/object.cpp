@@ -576,6 +576,15 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
     procedural_map.pre_sync();
     particle_system_map.pre_sync();
     motion_times.clear();
+
+    /* Geometry mapped to by multiple keys after deduplication. */
+    set<Geometry *> geometry_used;
+    geometry_shared.clear();
+    for (const pair<const GeometryKey, Geometry *> &it : geometry_map.key_to_scene_data()) {
+      if (!geometry_used.insert(it.second).second) {
+        geometry_shared.insert(it.second);
+      }
+    }
   }
   else {
     geometry_motion_synced.clear();
@@ -671,6 +680,8 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
   progress.set_sync_status("");
 
   if (!cancel && !motion) {
+    deduplicate_geometry();
+
     sync_background_light(b_v3d, use_portal);
 
     /* Handle removed data and modified pointers, as this may free memory, delete Nodes in the
@@ -681,6 +692,21 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
     geometry_map.post_sync();
     particle_system_map.post_sync();
     procedural_map.post_sync();
+
+    /* Forget content hashes of deleted geometry. */
+    set<Geometry *> geometry_live;
+    for (const pair<const GeometryKey, Geometry *> &it : geometry_map.key_to_scene_data()) {
+      geometry_live.insert(it.second);
+    }
+    for (map<Geometry *, uint>::iterator it = geometry_content_hash.begin();
+         it != geometry_content_hash.end();) {
+      if (geometry_live.find(it->first) == geometry_live.end()) {
+        it = geometry_content_hash.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
   }
 
   if (motion)
@@ -81,6 +81,7 @@ static void debug_flags_sync_from_scene(BL::Scene b_scene)
   flags.cpu.sse3 = get_boolean(cscene, "debug_use_cpu_sse3");
   flags.cpu.sse2 = get_boolean(cscene, "debug_use_cpu_sse2");
   flags.cpu.bvh_layout = (BVHLayout)get_enum(cscene, "debug_bvh_layout");
+  flags.cpu.wavefront = get_boolean(cscene, "debug_use_cpu_wavefront");
   /* Synchronize CUDA flags. */
   flags.cuda.adaptive_compile = get_boolean(cscene, "debug_use_cuda_adaptive_compile");
   /* Synchronize OptiX flags. */
@@ -903,6 +904,31 @@ static PyObject *enable_print_stats_func(PyObject * /*self*/, PyObject * /*args*
   Py_RETURN_NONE;
 }
 
+static PyObject *enable_sync_profile_func(PyObject * /*self*/, PyObject *args)
+{
+  const char *filepath = "";
+
+  if (!PyArg_ParseTuple(args, "|s", &filepath)) {
+    return NULL;
+  }
+
+  BlenderSession::use_sync_profile = true;
+  BlenderSession::sync_profile_filepath = filepath;
+  Py_RETURN_NONE;
+}
+
+static PyObject *sync_profile_func(PyObject * /*self*/, PyObject *value)
+{
+  BlenderSession *session = (BlenderSession *)PyLong_AsVoidPtr(value);
+
+  const string json = session->get_sync_profile();
+  if (json.empty()) {
+    Py_RETURN_NONE;
+  }
+
+  return PyUnicode_FromString(json.c_str());
+}
+
 static PyObject *get_device_types_func(PyObject * /*self*/, PyObject * /*args*/)
 {
   vector<DeviceType> device_types = Device::available_types();
@@ -986,6 +1012,8 @@ static PyMethodDef methods[] = {
 
     /* Statistics. */
     {"enable_print_stats", enable_print_stats_func, METH_NOARGS, ""},
+    {"enable_sync_profile", enable_sync_profile_func, METH_VARARGS, ""},
+    {"sync_profile", sync_profile_func, METH_O, ""},
 
     /* Compute Device selection */
     {"get_device_types", get_device_types_func, METH_VARARGS, ""},
@@ -53,6 +53,8 @@ CCL_NAMESPACE_BEGIN
 DeviceTypeMask BlenderSession::device_override = DEVICE_MASK_ALL;
 bool BlenderSession::headless = false;
 bool BlenderSession::print_render_stats = false;
+bool BlenderSession::use_sync_profile = false;
+string BlenderSession::sync_profile_filepath;
 
 BlenderSession::BlenderSession(BL::RenderEngine &b_engine,
                                BL::Preferences &b_userpref,
@@ -123,7 +125,7 @@ void BlenderSession::create_session()
 {
   const SessionParams session_params = BlenderSync::get_session_params(
       b_engine, b_userpref, b_scene, background);
-  const SceneParams scene_params = BlenderSync::get_scene_params(b_scene, background);
+  const SceneParams scene_params = BlenderSync::get_scene_params(b_data, b_scene, background);
   const bool session_pause = BlenderSync::get_session_pause(b_scene, background);
 
   /* reset status/progress */
@@ -209,7 +211,7 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
 
   const SessionParams session_params = BlenderSync::get_session_params(
       b_engine, b_userpref, b_scene, background);
-  const SceneParams scene_params = BlenderSync::get_scene_params(b_scene, background);
+  const SceneParams scene_params = BlenderSync::get_scene_params(b_data, b_scene, background);
 
   if (scene->params.modified(scene_params) || session->params.modified(session_params) ||
       !this->b_render.use_persistent_data()) {
@@ -290,6 +292,39 @@ static void add_cryptomatte_layer(BL::RenderResult &b_rr, string name, string ma
   render_add_metadata(b_rr, prefix + "manifest", manifest);
 }
 
+string BlenderSession::get_sync_profile()
+{
+  if (!scene || !scene->update_stats) {
+    return "";
+  }
+
+  thread_scoped_lock lock(scene->mutex);
+  return scene->update_stats->timeline.trace_json();
+}
+
+void BlenderSession::write_sync_profile()
+{
+  string filepath = sync_profile_filepath;
+
+  const size_t frame_start = filepath.find('#');
+  if (frame_start != string::npos) {
+    const size_t frame_end = filepath.find_first_not_of('#', frame_start);
+    const size_t num_digits = ((frame_end == string::npos) ? filepath.size() : frame_end) -
+                              frame_start;
+    filepath.replace(frame_start,
+                     num_digits,
+                     string_printf("%0*d", (int)num_digits, b_scene.frame_current()));
+  }
+
+  string json = get_sync_profile();
+  if (!path_write_text(filepath, json)) {
+    fprintf(stderr, "Failed to write synchronization profile to %s\n", filepath.c_str());
+    return;
+  }
+
+  VLOG(1) << "Wrote synchronization profile to " << filepath;
+}
+
 void BlenderSession::stamp_view_layer_metadata(Scene *scene, const string &view_layer_name)
 {
   BL::RenderResult b_rr = b_engine.get_result();
@@ -385,6 +420,9 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     num_views++;
   }
 
+  const bool use_update_stats = !b_engine.is_preview() && background &&
+                                (print_render_stats || use_sync_profile);
+
   int view_index = 0;
   for (b_rr.views.begin(b_view_iter); b_view_iter != b_rr.views.end();
        ++b_view_iter, ++view_index) {
@@ -396,6 +434,12 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     /* set the current view */
     b_engine.active_view_set(b_rview_name.c_str());
 
+    /* Collect statistics from the start of synchronization. */
+    if (use_update_stats) {
+      scene->enable_update_stats();
+      scene->update_stats->timeline.clear();
+    }
+
     /* update scene */
     BL::Object b_camera_override(b_engine.camera_override());
     sync->sync_camera(b_render, b_camera_override, width, height, b_rview_name.c_str());
@@ -434,13 +478,13 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     session->reset(effective_session_params, buffer_params);
 
     /* render */
-    if (!b_engine.is_preview() && background && print_render_stats) {
-      scene->enable_update_stats();
-    }
-
     session->start();
     session->wait();
 
+    if (use_update_stats && !sync_profile_filepath.empty()) {
+      write_sync_profile();
+    }
+
     if (!b_engine.is_preview() && background && print_render_stats) {
       RenderStats stats;
       session->collect_statistics(&stats);
@@ -600,9 +644,19 @@ void BlenderSession::bake(BL::Depsgraph &b_depsgraph_,
   scene->bake_manager->set(scene, b_object.name());
 
   /* Add render pass that we want to bake, and name it Combined so that it is
-   * used as that on the Blender side. */
-  Pass *pass = scene->create_node<Pass>();
-  pass->set_name(ustring("Combined"));
+   * used as that on the Blender side. Following bakes with the same session, for other objects
+   * or images, reuse the pass so the scene does not need to be synchronized again. */
+  Pass *pass = nullptr;
+  foreach (Pass *scene_pass, scene->passes) {
+    if (scene_pass->get_name() == "Combined") {
+      pass = scene_pass;
+      break;
+    }
+  }
+  if (pass == nullptr) {
+    pass = scene->create_node<Pass>();
+    pass->set_name(ustring("Combined"));
+  }
   pass->set_type(bake_type_to_pass(bake_type, bake_filter));
   pass->set_include_albedo((bake_filter & BL::BakeSettings::pass_filter_COLOR));
 
@@ -610,7 +664,8 @@ void BlenderSession::bake(BL::Depsgraph &b_depsgraph_,
   session->set_output_driver(make_unique<BlenderOutputDriver>(b_engine));
 
   if (!session->progress.get_cancel()) {
-    /* Sync scene. */
+    /* Sync scene. This does nothing if the scene was already synchronized for a previous bake
+     * with the same depsgraph, which keeps the BVH and other device data resident. */
     BL::Object b_camera_override(b_engine.camera_override());
     sync->sync_camera(b_render, b_camera_override, width, height, "");
     sync->sync_data(
@@ -680,7 +735,7 @@ void BlenderSession::synchronize(BL::Depsgraph &b_depsgraph_)
   /* on session/scene parameter changes, we recreate session entirely */
   const SessionParams session_params = BlenderSync::get_session_params(
       b_engine, b_userpref, b_scene, background);
-  const SceneParams scene_params = BlenderSync::get_scene_params(b_scene, background);
+  const SceneParams scene_params = BlenderSync::get_scene_params(b_data, b_scene, background);
   const bool session_pause = BlenderSync::get_session_pause(b_scene, background);
 
   if (session->params.modified(session_params) || scene->params.modified(scene_params)) {
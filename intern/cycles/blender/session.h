@@ -132,9 +132,22 @@ class BlenderSession {
 
   static bool print_render_stats;
 
+  /* Collect per item timing of synchronization and scene update for final renders from the
+   * command line, and write it to the file if not empty. A run of # characters in the file path
+   * is replaced by the frame number. */
+  static bool use_sync_profile;
+  static string sync_profile_filepath;
+
+  /* Per item timing of the last synchronization and scene update, as JSON in the Chrome trace
+   * event format. Empty if no statistics were collected. */
+  string get_sync_profile();
+
  protected:
   void stamp_view_layer_metadata(Scene *scene, const string &view_layer_name);
 
+  /* Write the per item timing to the sync profile file. */
+  void write_sync_profile();
+
   /* Check whether session error happened.
    * If so, it is reported to the render engine and true is returned.
    * Otherwise false is returned. */
@@ -27,6 +27,7 @@
 #include "scene/shader.h"
 #include "scene/shader_graph.h"
 #include "scene/shader_nodes.h"
+#include "scene/stats.h"
 
 #include "device/device.h"
 
@@ -269,16 +270,35 @@ void BlenderSync::sync_data(BL::RenderSettings &b_render,
   sync_view_layer(b_view_layer);
   sync_integrator(b_view_layer, background);
   sync_film(b_view_layer, b_v3d);
-  sync_shaders(b_depsgraph, b_v3d);
+  {
+    scoped_callback_timer timer([this](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->timeline.add_entry("Sync Shaders", "", time);
+      }
+    });
+    sync_shaders(b_depsgraph, b_v3d);
+  }
   sync_images();
 
   geometry_synced.clear(); /* use for objects and motion sync */
 
   if (scene->need_motion() == Scene::MOTION_PASS || scene->need_motion() == Scene::MOTION_NONE ||
       scene->camera->get_motion_position() == Camera::MOTION_POSITION_CENTER) {
+    scoped_callback_timer timer([this](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->timeline.add_entry("Sync Objects", "", time);
+      }
+    });
     sync_objects(b_depsgraph, b_v3d);
   }
-  sync_motion(b_render, b_depsgraph, b_v3d, b_override, width, height, python_thread_state);
+  {
+    scoped_callback_timer timer([this](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->timeline.add_entry("Sync Motion", "", time);
+      }
+    });
+    sync_motion(b_render, b_depsgraph, b_v3d, b_override, width, height, python_thread_state);
+  }
 
   geometry_synced.clear();
 
@@ -344,6 +364,7 @@ void BlenderSync::sync_integrator(BL::ViewLayer &b_view_layer, bool background)
   }
 
   integrator->set_light_sampling_threshold(get_float(cscene, "light_sampling_threshold"));
+  integrator->set_use_light_tree(get_boolean(cscene, "use_light_tree"));
 
   SamplingPattern sampling_pattern = (SamplingPattern)get_enum(
       cscene, "sampling_pattern", SAMPLING_NUM_PATTERNS, SAMPLING_PATTERN_SOBOL);
@@ -380,6 +401,10 @@ void BlenderSync::sync_integrator(BL::ViewLayer &b_view_layer, bool background)
   }
   integrator->set_scrambling_distance(scrambling_distance);
 
+  integrator->set_use_guiding(get_boolean(cscene, "use_guiding"));
+  integrator->set_guiding_probability(get_float(cscene, "guiding_probability"));
+  integrator->set_guiding_training_samples(get_int(cscene, "guiding_training_samples"));
+
   if (get_boolean(cscene, "use_fast_gi")) {
     if (preview) {
       integrator->set_ao_bounces(get_int(cscene, "ao_bounces"));
@@ -765,7 +790,9 @@ void BlenderSync::free_data_after_sync(BL::Depsgraph &b_depsgraph)
 
 /* Scene Parameters */
 
-SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
+SceneParams BlenderSync::get_scene_params(BL::BlendData &b_data,
+                                          BL::Scene &b_scene,
+                                          bool background)
 {
   SceneParams params;
   PointerRNA cscene = RNA_pointer_get(&b_scene.ptr, "cycles");
@@ -785,6 +812,12 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
   params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
   params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
 
+  const string bvh_cache_path = get_string(cscene, "bvh_cache_path");
+  if (!bvh_cache_path.empty()) {
+    params.bvh_cache_path = blender_absolute_path(b_data, b_scene, bvh_cache_path);
+  }
+  params.bvh_cache_size = get_int(cscene, "bvh_cache_size");
+
   PointerRNA csscene = RNA_pointer_get(&b_scene.ptr, "cycles_curves");
   params.hair_subdivisions = get_int(csscene, "subdivisions");
   params.hair_shape = (CurveShapeType)get_enum(
@@ -804,6 +837,11 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
     params.texture_limit = 0;
   }
 
+  params.texture_cache = get_boolean(cscene, "use_texture_cache");
+  params.texture_cache_size = get_int(cscene, "texture_cache_size");
+
+  params.use_compact_geometry = get_boolean(cscene, "use_compact_geometry");
+
   params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
   params.background = background;
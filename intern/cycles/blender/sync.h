@@ -94,7 +94,9 @@ class BlenderSync {
   }
 
   /* get parameters */
-  static SceneParams get_scene_params(BL::Scene &b_scene, bool background);
+  static SceneParams get_scene_params(BL::BlendData &b_data,
+                                      BL::Scene &b_scene,
+                                      bool background);
   static SessionParams get_session_params(BL::RenderEngine &b_engine,
                                           BL::Preferences &b_userpref,
                                           BL::Scene &b_scene,
@@ -185,6 +187,8 @@ class BlenderSync {
                             bool use_particle_hair,
                             TaskPool *task_pool);
 
+  void deduplicate_geometry();
+
   /* Light */
   void sync_light(BL::Object &b_parent,
                   int persistent_id[OBJECT_PERSISTENT_ID_SIZE],
@@ -226,6 +230,10 @@ class BlenderSync {
   set<Geometry *> geometry_synced;
   set<Geometry *> geometry_motion_synced;
   set<Geometry *> geometry_motion_attribute_synced;
+  /* Geometry shared by multiple keys after deduplication, and content hashes of geometry which
+   * other geometry with identical content can be deduplicated with. */
+  set<Geometry *> geometry_shared;
+  map<Geometry *, uint> geometry_content_hash;
   /** Remember which geometries come from which objects to be able to sync them after changes. */
   map<void *, set<BL::ID>> instance_geometries_by_object;
   set<float> motion_times;
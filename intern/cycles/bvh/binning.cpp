@@ -23,7 +23,9 @@
 
 #include "util/algorithm.h"
 #include "util/boundbox.h"
+#include "util/tbb.h"
 #include "util/types.h"
+#include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -105,63 +107,39 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
     bin_bounds[i][0] = bin_bounds[i][1] = bin_bounds[i][2] = BoundBox::empty;
   }
 
-  /* map geometry to bins, unrolled once */
-  {
-    int64_t i;
-
-    for (i = 0; i < int64_t(size()) - 1; i += 2) {
-      prefetch_L2(&prims[start() + i + 8]);
-
-      /* map even and odd primitive to bin */
-      const BVHReference &prim0 = prims[start() + i + 0];
-      const BVHReference &prim1 = prims[start() + i + 1];
-
-      BoundBox bounds0 = get_prim_bounds(prim0);
-      BoundBox bounds1 = get_prim_bounds(prim1);
-
-      int4 bin0 = get_bin(bounds0);
-      int4 bin1 = get_bin(bounds1);
-
-      /* increase bounds for bins for even primitive */
-      int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
-
-      /* increase bounds of bins for odd primitive */
-      int b10 = (int)extract<0>(bin1);
-      bin_count[b10][0]++;
-      bin_bounds[b10][0].grow(bounds1);
-      int b11 = (int)extract<1>(bin1);
-      bin_count[b11][1]++;
-      bin_bounds[b11][1].grow(bounds1);
-      int b12 = (int)extract<2>(bin1);
-      bin_count[b12][2]++;
-      bin_bounds[b12][2].grow(bounds1);
-    }
-
-    /* for uneven number of primitives */
-    if (i < int64_t(size())) {
-      /* map primitive to bin */
-      const BVHReference &prim0 = prims[start() + i];
-      BoundBox bounds0 = get_prim_bounds(prim0);
-      int4 bin0 = get_bin(bounds0);
-
-      /* increase bounds of bins */
-      int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
+  /* map geometry to bins */
+  if (size() < PARALLEL_MIN_SIZE) {
+    bin_primitives(prims, start(), end(), bin_count, bin_bounds);
+  }
+  else {
+    /* Bin chunks in parallel and merge them afterwards. */
+    struct ChunkBins {
+      BoundBox bounds[MAX_BINS][4];
+      int4 count[MAX_BINS];
+    };
+
+    const size_t num_chunks = divide_up(size(), PARALLEL_CHUNK_SIZE);
+    vector<ChunkBins> chunks(num_chunks);
+
+    parallel_for(size_t(0), num_chunks, [&](size_t chunk) {
+      ChunkBins &bins = chunks[chunk];
+      for (size_t i = 0; i < num_bins; i++) {
+        bins.count[i] = make_int4(0);
+        bins.bounds[i][0] = bins.bounds[i][1] = bins.bounds[i][2] = BoundBox::empty;
+      }
+
+      const size_t chunk_begin = start() + chunk * PARALLEL_CHUNK_SIZE;
+      const size_t chunk_end = min(chunk_begin + PARALLEL_CHUNK_SIZE, end());
+      bin_primitives(prims, chunk_begin, chunk_end, bins.count, bins.bounds);
+    });
+
+    for (const ChunkBins &bins : chunks) {
+      for (size_t i = 0; i < num_bins; i++) {
+        bin_count[i] = bin_count[i] + bins.count[i];
+        for (int dim = 0; dim < 3; dim++) {
+          bin_bounds[i][dim].grow(bins.bounds[i][dim]);
+        }
+      }
     }
   }
 
@@ -226,6 +204,165 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
   leafSAH = bounds_.half_area() * blocks(size());
 }
 
+void BVHObjectBinning::bin_primitives(const BVHReference *prims,
+                                      size_t begin,
+                                      size_t end,
+                                      int4 bin_count[MAX_BINS],
+                                      BoundBox bin_bounds[MAX_BINS][4]) const
+{
+  /* map geometry to bins, unrolled once */
+  int64_t i;
+
+  for (i = begin; i < int64_t(end) - 1; i += 2) {
+    prefetch_L2(&prims[i + 8]);
+
+    /* map even and odd primitive to bin */
+    const BVHReference &prim0 = prims[i + 0];
+    const BVHReference &prim1 = prims[i + 1];
+
+    BoundBox bounds0 = get_prim_bounds(prim0);
+    BoundBox bounds1 = get_prim_bounds(prim1);
+
+    int4 bin0 = get_bin(bounds0);
+    int4 bin1 = get_bin(bounds1);
+
+    /* increase bounds for bins for even primitive */
+    int b00 = (int)extract<0>(bin0);
+    bin_count[b00][0]++;
+    bin_bounds[b00][0].grow(bounds0);
+    int b01 = (int)extract<1>(bin0);
+    bin_count[b01][1]++;
+    bin_bounds[b01][1].grow(bounds0);
+    int b02 = (int)extract<2>(bin0);
+    bin_count[b02][2]++;
+    bin_bounds[b02][2].grow(bounds0);
+
+    /* increase bounds of bins for odd primitive */
+    int b10 = (int)extract<0>(bin1);
+    bin_count[b10][0]++;
+    bin_bounds[b10][0].grow(bounds1);
+    int b11 = (int)extract<1>(bin1);
+    bin_count[b11][1]++;
+    bin_bounds[b11][1].grow(bounds1);
+    int b12 = (int)extract<2>(bin1);
+    bin_count[b12][2]++;
+    bin_bounds[b12][2].grow(bounds1);
+  }
+
+  /* for uneven number of primitives */
+  if (i < int64_t(end)) {
+    /* map primitive to bin */
+    const BVHReference &prim0 = prims[i];
+    BoundBox bounds0 = get_prim_bounds(prim0);
+    int4 bin0 = get_bin(bounds0);
+
+    /* increase bounds of bins */
+    int b00 = (int)extract<0>(bin0);
+    bin_count[b00][0]++;
+    bin_bounds[b00][0].grow(bounds0);
+    int b01 = (int)extract<1>(bin0);
+    bin_count[b01][1]++;
+    bin_bounds[b01][1].grow(bounds0);
+    int b02 = (int)extract<2>(bin0);
+    bin_count[b02][2]++;
+    bin_bounds[b02][2].grow(bounds0);
+  }
+}
+
+size_t BVHObjectBinning::partition_parallel(BVHReference *prims,
+                                            BoundBox &lgeom_bounds,
+                                            BoundBox &rgeom_bounds,
+                                            BoundBox &lcent_bounds,
+                                            BoundBox &rcent_bounds) const
+{
+  struct ChunkPartition {
+    size_t num_left;
+    BoundBox lgeom_bounds, rgeom_bounds;
+    BoundBox lcent_bounds, rcent_bounds;
+  };
+
+  const size_t N = size();
+  const size_t num_chunks = divide_up(N, PARALLEL_CHUNK_SIZE);
+  vector<ChunkPartition> chunks(num_chunks);
+
+  /* Count primitives on the left side and compute bounds of both sides for every chunk. */
+  parallel_for(size_t(0), num_chunks, [&](size_t chunk) {
+    ChunkPartition &partition = chunks[chunk];
+    partition.num_left = 0;
+    partition.lgeom_bounds = partition.rgeom_bounds = BoundBox::empty;
+    partition.lcent_bounds = partition.rcent_bounds = BoundBox::empty;
+
+    const size_t chunk_begin = start() + chunk * PARALLEL_CHUNK_SIZE;
+    const size_t chunk_end = min(chunk_begin + PARALLEL_CHUNK_SIZE, end());
+    for (size_t i = chunk_begin; i < chunk_end; i++) {
+      const BVHReference &prim = prims[i];
+      const float3 unaligned_center = get_prim_bounds(prim).center2();
+      const float3 center = prim.bounds().center2();
+
+      if (get_bin(unaligned_center)[dim] < pos) {
+        partition.lgeom_bounds.grow(prim.bounds());
+        partition.lcent_bounds.grow(center);
+        partition.num_left++;
+      }
+      else {
+        partition.rgeom_bounds.grow(prim.bounds());
+        partition.rcent_bounds.grow(center);
+      }
+    }
+  });
+
+  /* Offsets of every chunk on either side. */
+  vector<size_t> left_offset(num_chunks), right_offset(num_chunks);
+  size_t num_left = 0;
+  for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+    left_offset[chunk] = num_left;
+    num_left += chunks[chunk].num_left;
+
+    lgeom_bounds.grow(chunks[chunk].lgeom_bounds);
+    rgeom_bounds.grow(chunks[chunk].rgeom_bounds);
+    lcent_bounds.grow(chunks[chunk].lcent_bounds);
+    rcent_bounds.grow(chunks[chunk].rcent_bounds);
+  }
+
+  if (num_left == 0 || num_left == N) {
+    return num_left;
+  }
+
+  for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+    right_offset[chunk] = num_left + chunk * PARALLEL_CHUNK_SIZE - left_offset[chunk];
+  }
+
+  /* Scatter into temporary storage and copy back. */
+  vector<BVHReference> partitioned(N);
+
+  parallel_for(size_t(0), num_chunks, [&](size_t chunk) {
+    size_t left = left_offset[chunk];
+    size_t right = right_offset[chunk];
+
+    const size_t chunk_begin = start() + chunk * PARALLEL_CHUNK_SIZE;
+    const size_t chunk_end = min(chunk_begin + PARALLEL_CHUNK_SIZE, end());
+    for (size_t i = chunk_begin; i < chunk_end; i++) {
+      const BVHReference &prim = prims[i];
+      if (get_bin(get_prim_bounds(prim).center2())[dim] < pos) {
+        partitioned[left++] = prim;
+      }
+      else {
+        partitioned[right++] = prim;
+      }
+    }
+  });
+
+  parallel_for(size_t(0), num_chunks, [&](size_t chunk) {
+    const size_t chunk_begin = chunk * PARALLEL_CHUNK_SIZE;
+    const size_t chunk_end = min(chunk_begin + PARALLEL_CHUNK_SIZE, N);
+    std::copy(partitioned.begin() + chunk_begin,
+              partitioned.begin() + chunk_end,
+              prims + start() + chunk_begin);
+  });
+
+  return num_left;
+}
+
 void BVHObjectBinning::split(BVHReference *prims,
                              BVHObjectBinning &left_o,
                              BVHObjectBinning &right_o) const
@@ -237,34 +374,44 @@ void BVHObjectBinning::split(BVHReference *prims,
   BoundBox lcent_bounds = BoundBox::empty;
   BoundBox rcent_bounds = BoundBox::empty;
 
-  int64_t l = 0, r = N - 1;
-
-  while (l <= r) {
-    prefetch_L2(&prims[start() + l + 8]);
-    prefetch_L2(&prims[start() + r - 8]);
+  size_t num_left;
 
-    BVHReference prim = prims[start() + l];
-    BoundBox unaligned_bounds = get_prim_bounds(prim);
-    float3 unaligned_center = unaligned_bounds.center2();
-    float3 center = prim.bounds().center2();
-
-    if (get_bin(unaligned_center)[dim] < pos) {
-      lgeom_bounds.grow(prim.bounds());
-      lcent_bounds.grow(center);
-      l++;
-    }
-    else {
-      rgeom_bounds.grow(prim.bounds());
-      rcent_bounds.grow(center);
-      swap(prims[start() + l], prims[start() + r]);
-      r--;
+  if (N >= PARALLEL_MIN_SIZE) {
+    num_left = partition_parallel(prims, lgeom_bounds, rgeom_bounds, lcent_bounds, rcent_bounds);
+  }
+  else {
+    int64_t l = 0, r = N - 1;
+
+    while (l <= r) {
+      prefetch_L2(&prims[start() + l + 8]);
+      prefetch_L2(&prims[start() + r - 8]);
+
+      BVHReference prim = prims[start() + l];
+      BoundBox unaligned_bounds = get_prim_bounds(prim);
+      float3 unaligned_center = unaligned_bounds.center2();
+      float3 center = prim.bounds().center2();
+
+      if (get_bin(unaligned_center)[dim] < pos) {
+        lgeom_bounds.grow(prim.bounds());
+        lcent_bounds.grow(center);
+        l++;
+      }
+      else {
+        rgeom_bounds.grow(prim.bounds());
+        rcent_bounds.grow(center);
+        swap(prims[start() + l], prims[start() + r]);
+        r--;
+      }
     }
+
+    num_left = l;
   }
+
   /* finish */
-  if (l != 0 && N - 1 - r != 0) {
-    right_o = BVHObjectBinning(BVHRange(rgeom_bounds, rcent_bounds, start() + l, N - 1 - r),
-                               prims);
-    left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), l), prims);
+  if (num_left != 0 && num_left != N) {
+    right_o = BVHObjectBinning(
+        BVHRange(rgeom_bounds, rcent_bounds, start() + num_left, N - num_left), prims);
+    left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), num_left), prims);
     return;
   }
 
@@ -27,12 +27,16 @@ CCL_NAMESPACE_BEGIN
 
 class BVHBuild;
 
-/* Single threaded object binner. Finds the split with the best SAH heuristic
+/* Object binner. Finds the split with the best SAH heuristic
  * by testing for each dimension multiple partitionings for regular spaced
  * partition locations. A partitioning for a partition location is computed,
  * by putting primitives whose centroid is on the left and right of the split
  * location to different sets. The SAH is evaluated by computing the number of
- * blocks occupied by the primitives in the partitions. */
+ * blocks occupied by the primitives in the partitions.
+ *
+ * Binning and partitioning of large ranges is split into chunks which are
+ * processed in parallel, so the top levels of the tree are not built by a
+ * single thread. The result does not depend on the number of threads. */
 
 class BVHObjectBinning : public BVHRange {
  public:
@@ -71,6 +75,26 @@ class BVHObjectBinning : public BVHRange {
   enum { MAX_BINS = 32 };
   enum { LOG_BLOCK_SIZE = 2 };
 
+  /* Ranges of at least this many primitives are binned and split in parallel, in chunks of
+   * the given size. */
+  enum { PARALLEL_MIN_SIZE = 65536 };
+  enum { PARALLEL_CHUNK_SIZE = 16384 };
+
+  /* Accumulate primitives in the given range into bin counts and bounds. */
+  void bin_primitives(const BVHReference *prims,
+                      size_t begin,
+                      size_t end,
+                      int4 bin_count[MAX_BINS],
+                      BoundBox bin_bounds[MAX_BINS][4]) const;
+
+  /* Partition primitives by the best split while preserving their order, returns the number of
+   * primitives on the left side. */
+  size_t partition_parallel(BVHReference *prims,
+                            BoundBox &lgeom_bounds,
+                            BoundBox &rgeom_bounds,
+                            BoundBox &lcent_bounds,
+                            BoundBox &rcent_bounds) const;
+
   /* computes the bin numbers for each dimension for a box. */
   __forceinline int4 get_bin(const BoundBox &box) const
   {
@@ -35,6 +35,7 @@
 #include "util/queue.h"
 #include "util/simd.h"
 #include "util/stack_allocator.h"
+#include "util/tbb.h"
 #include "util/time.h"
 
 CCL_NAMESPACE_BEGIN
@@ -422,6 +423,11 @@ BVHNode *BVHBuild::run()
     rootnode = build_node(root, references, 0, local_storage);
     task_pool.wait_work();
   }
+  else if (params.bvh_type == BVH_TYPE_DYNAMIC && references.size() >= THREAD_TASK_SIZE) {
+    /* Perform fast build, splitting the top levels along a Morton curve. */
+    rootnode = build_morton_nodes(root);
+    task_pool.wait_work();
+  }
   else {
     /* Perform multithreaded binning build. */
     BVHObjectBinning rootbin(root, (references.size()) ? &references[0] : NULL);
@@ -656,6 +662,173 @@ BVHNode *BVHBuild::build_node(const BVHObjectBinning &range, int level)
   return inner;
 }
 
+/* Morton code builder for the top levels of the tree
+ *
+ * Used for the dynamic BVH type, where build time matters more than render time. References are
+ * sorted along a Morton curve through their centroids, and ranges are split where the Morton
+ * code changes in the highest bit. This needs no binning and gives independent ranges for all
+ * threads from the start, which are then built by the binning builder. */
+
+static uint bvh_morton_expand_bits(uint v)
+{
+  v = (v * 0x00010001u) & 0xFF0000FFu;
+  v = (v * 0x00000101u) & 0x0F00F00Fu;
+  v = (v * 0x00000011u) & 0xC30C30C3u;
+  v = (v * 0x00000005u) & 0x49249249u;
+  return v;
+}
+
+static uint bvh_morton_code(const float3 p)
+{
+  const uint x = (uint)clamp((int)p.x, 0, 1023);
+  const uint y = (uint)clamp((int)p.y, 0, 1023);
+  const uint z = (uint)clamp((int)p.z, 0, 1023);
+  return (bvh_morton_expand_bits(x) << 2) | (bvh_morton_expand_bits(y) << 1) |
+         bvh_morton_expand_bits(z);
+}
+
+namespace {
+
+struct BVHMortonNode {
+  size_t start;
+  size_t size;
+  int level;
+  /* Child nodes, or -1 for ranges which are built by the binning builder. */
+  int children[2];
+
+  BoundBox bounds;
+  BoundBox cent_bounds;
+  InnerNode *inner;
+};
+
+}  // namespace
+
+static int bvh_morton_split(const vector<uint> &codes,
+                            const size_t start,
+                            const size_t size,
+                            const int level,
+                            const size_t max_leaf_size,
+                            vector<BVHMortonNode> &nodes)
+{
+  const int index = (int)nodes.size();
+  nodes.push_back({start, size, level, {-1, -1}, BoundBox::empty, BoundBox::empty, NULL});
+
+  if (size < max_leaf_size || level >= BVHParams::MAX_DEPTH / 2) {
+    return index;
+  }
+
+  const size_t end = start + size;
+  const uint first_code = codes[start];
+  const uint last_code = codes[end - 1];
+
+  size_t split;
+  if (first_code == last_code) {
+    /* All references in the same Morton cell. */
+    split = start + size / 2;
+  }
+  else {
+    /* Codes are sorted and share all bits above the highest differing one. */
+    const uint bit = 1u << (31 - count_leading_zeros(first_code ^ last_code));
+    split = std::partition_point(codes.begin() + start,
+                                 codes.begin() + end,
+                                 [bit](const uint code) { return !(code & bit); }) -
+            codes.begin();
+  }
+
+  const int left = bvh_morton_split(codes, start, split - start, level + 1, max_leaf_size, nodes);
+  const int right = bvh_morton_split(codes, split, end - split, level + 1, max_leaf_size, nodes);
+  nodes[index].children[0] = left;
+  nodes[index].children[1] = right;
+
+  return index;
+}
+
+BVHNode *BVHBuild::build_morton_nodes(const BVHRange &root)
+{
+  const size_t num_references = references.size();
+
+  /* Compute Morton codes, with the index of the reference in the lower bits for sorting. */
+  const BoundBox &cent_bounds = root.cent_bounds();
+  const float3 cent_size = cent_bounds.size();
+  const float3 cent_scale = make_float3((cent_size.x > 0.0f) ? 1024.0f / cent_size.x : 0.0f,
+                                        (cent_size.y > 0.0f) ? 1024.0f / cent_size.y : 0.0f,
+                                        (cent_size.z > 0.0f) ? 1024.0f / cent_size.z : 0.0f);
+
+  vector<uint64_t> keys(num_references);
+  parallel_for(blocked_range<size_t>(0, num_references, THREAD_TASK_SIZE),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   const float3 p = (references[i].bounds().center2() - cent_bounds.min) *
+                                    cent_scale;
+                   keys[i] = ((uint64_t)bvh_morton_code(p) << 32) | i;
+                 }
+               });
+
+  parallel_sort(keys.begin(), keys.end());
+
+  /* Reorder references along the curve. */
+  vector<BVHReference> sorted_references(num_references);
+  vector<uint> codes(num_references);
+  parallel_for(blocked_range<size_t>(0, num_references, THREAD_TASK_SIZE),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   sorted_references[i] = references[keys[i] & 0xFFFFFFFF];
+                   codes[i] = (uint)(keys[i] >> 32);
+                 }
+               });
+  references.swap(sorted_references);
+
+  /* Split into ranges small enough for a single thread task. */
+  vector<BVHMortonNode> nodes;
+  bvh_morton_split(codes, 0, num_references, 0, THREAD_TASK_SIZE, nodes);
+
+  /* Compute bounds of ranges in parallel, and of the inner nodes from their children. Children
+   * always come after their parent. */
+  parallel_for(size_t(0), nodes.size(), [&](size_t i) {
+    BVHMortonNode &node = nodes[i];
+    if (node.children[0] != -1) {
+      return;
+    }
+    for (size_t j = node.start; j < node.start + node.size; j++) {
+      node.bounds.grow(references[j].bounds());
+      node.cent_bounds.grow(references[j].bounds().center2());
+    }
+  });
+
+  for (int i = (int)nodes.size() - 1; i >= 0; i--) {
+    BVHMortonNode &node = nodes[i];
+    if (node.children[0] != -1) {
+      node.bounds = merge(nodes[node.children[0]].bounds, nodes[node.children[1]].bounds);
+      node.inner = new InnerNode(node.bounds);
+    }
+  }
+
+  /* Link inner nodes, and build the remaining ranges with the binning builder. */
+  foreach (const BVHMortonNode &node, nodes) {
+    if (node.children[0] == -1) {
+      continue;
+    }
+
+    for (int child = 0; child < 2; child++) {
+      const BVHMortonNode &child_node = nodes[node.children[child]];
+      if (child_node.inner) {
+        node.inner->children[child] = child_node.inner;
+      }
+      else {
+        InnerNode *inner = node.inner;
+        const BVHRange range(
+            child_node.bounds, child_node.cent_bounds, child_node.start, child_node.size);
+        const int level = child_node.level;
+        task_pool.push([=] {
+          thread_build_node(inner, child, BVHObjectBinning(range, &references[0]), level);
+        });
+      }
+    }
+  }
+
+  return nodes[0].inner;
+}
+
 /* multithreaded spatial split builder */
 BVHNode *BVHBuild::build_node(const BVHRange &range,
                               vector<BVHReference> &references,
@@ -22,11 +22,14 @@
 #include "scene/object.h"
 
 #include "bvh/build.h"
+#include "bvh/cache.h"
 #include "bvh/node.h"
 #include "bvh/unaligned.h"
 
 #include "util/foreach.h"
+#include "util/log.h"
 #include "util/progress.h"
+#include "util/tbb.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -42,12 +45,22 @@ int BVHStackEntry::encodeIdx() const
 BVH2::BVH2(const BVHParams &params_,
            const vector<Geometry *> &geometry_,
            const vector<Object *> &objects_)
-    : BVH(params_, geometry_, objects_)
+    : BVH(params_, geometry_, objects_), build_sah_cost(0.0f)
 {
 }
 
 void BVH2::build(Progress &progress, Stats *)
 {
+  string cache_key;
+  if (!params.cache_path.empty()) {
+    progress.set_substatus("Loading BVH from cache");
+    cache_key = bvh_cache_key(params, geometry, objects);
+    if (!cache_key.empty() &&
+        bvh_cache_read(params.cache_path, cache_key, pack, build_sah_cost)) {
+      return;
+    }
+  }
+
   progress.set_substatus("Building BVH");
 
   /* build nodes */
@@ -67,6 +80,8 @@ void BVH2::build(Progress &progress, Stats *)
     return;
   }
 
+  build_sah_cost = bvh2_root->computeSubtreeSAHCost(params);
+
   /* BVH builder returns tree in a binary mode (with two children per inner
    * node. Need to adopt that for a wider BVH implementations. */
   BVHNode *root = widen_children_nodes(bvh2_root);
@@ -96,6 +111,10 @@ void BVH2::build(Progress &progress, Stats *)
 
   /* free build nodes */
   root->deleteSubtree();
+
+  if (!cache_key.empty()) {
+    bvh_cache_write(params.cache_path, cache_key, pack, build_sah_cost, params.cache_size);
+  }
 }
 
 void BVH2::refit(Progress &progress)
@@ -107,7 +126,14 @@ void BVH2::refit(Progress &progress)
     return;
 
   progress.set_substatus("Refitting BVH nodes");
-  refit_nodes();
+  const float sah_cost = refit_nodes();
+
+  /* Primitives moved too far from where they were when the topology was built. */
+  if (sah_cost > build_sah_cost * params.refit_rebuild_threshold) {
+    VLOG(2) << "Rebuilding BVH, refitted SAH cost " << sah_cost << " exceeds build cost "
+            << build_sah_cost << ".";
+    build(progress, NULL);
+  }
 }
 
 BVHNode *BVH2::widen_children_nodes(const BVHNode *root)
@@ -313,16 +339,25 @@ void BVH2::pack_nodes(const BVHNode *root)
   pack.root_index = (root->is_leaf()) ? -1 : 0;
 }
 
-void BVH2::refit_nodes()
+float BVH2::refit_nodes()
 {
   assert(!params.top_level);
 
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
-  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+  float area_cost = 0.0f;
+  refit_node(0, (pack.root_index == -1) ? true : false, 0, bbox, visibility, area_cost);
+
+  /* Same as BVHNode::computeSubtreeSAHCost(), with probabilities relative to the root. */
+  const float root_area = bbox.safe_area();
+  return (root_area > 0.0f) ? area_cost / root_area : 0.0f;
 }
 
-void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
+/* Subtrees above this depth are refitted in parallel. */
+#define BVH_REFIT_PARALLEL_DEPTH 8
+
+void BVH2::refit_node(
+    int idx, bool leaf, int depth, BoundBox &bbox, uint &visibility, float &area_cost)
 {
   if (leaf) {
     /* refit leaf node */
@@ -332,6 +367,7 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     const int c1 = data[0].y;
 
     refit_primitives(c0, c1, bbox, visibility);
+    area_cost += bbox.safe_area() * params.cost(0, c1 - c0);
 
     /* TODO(sergey): De-duplicate with pack_leaf(). */
     float4 leaf_data[BVH_NODE_LEAF_SIZE];
@@ -351,9 +387,23 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     /* refit inner node, set bbox from children */
     BoundBox bbox0 = BoundBox::empty, bbox1 = BoundBox::empty;
     uint visibility0 = 0, visibility1 = 0;
-
-    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0);
-    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1);
+    float area_cost0 = 0.0f, area_cost1 = 0.0f;
+
+    /* Children are independent, so the tree can be refitted bottom-up in parallel. */
+    auto refit_child0 = [&]() {
+      refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), depth + 1, bbox0, visibility0, area_cost0);
+    };
+    auto refit_child1 = [&]() {
+      refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), depth + 1, bbox1, visibility1, area_cost1);
+    };
+
+    if (depth < BVH_REFIT_PARALLEL_DEPTH) {
+      parallel_invoke(refit_child0, refit_child1);
+    }
+    else {
+      refit_child0();
+      refit_child1();
+    }
 
     if (is_unaligned) {
       Transform aligned_space = transform_identity();
@@ -367,6 +417,7 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     bbox.grow(bbox0);
     bbox.grow(bbox1);
     visibility = visibility0 | visibility1;
+    area_cost += bbox.safe_area() * params.cost(2, 0) + area_cost0 + area_cost1;
   }
 }
 
@@ -51,6 +51,9 @@ class BVH2 : public BVH {
   PackedBVH pack;
 
  protected:
+  /* SAH cost of the BVH after the last build, to detect when refitting degraded it. */
+  float build_sah_cost;
+
   /* constructor */
   friend class BVH;
   BVH2(const BVHParams &params,
@@ -90,9 +93,10 @@ class BVH2 : public BVH {
                            uint visibility0,
                            uint visibility1);
 
-  /* refit */
-  void refit_nodes();
-  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
+  /* refit, returns the SAH cost of the refitted BVH */
+  float refit_nodes();
+  void refit_node(
+      int idx, bool leaf, int depth, BoundBox &bbox, uint &visibility, float &area_cost);
 
   /* Refit range of primitives. */
   void refit_primitives(int start, int end, BoundBox &bbox, uint &visibility);
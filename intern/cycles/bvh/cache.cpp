@@ -0,0 +1,349 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bvh/cache.h"
+
+#include "bvh/bvh.h"
+#include "bvh/params.h"
+
+#include "scene/hair.h"
+#include "scene/mesh.h"
+#include "scene/object.h"
+
+#include "util/foreach.h"
+#include "util/log.h"
+#include "util/map.h"
+#include "util/md5.h"
+#include "util/path.h"
+#include "util/time.h"
+
+#include <cstdio>
+
+CCL_NAMESPACE_BEGIN
+
+/* Increase when the layout of the packed BVH or the way it is built changes, so files written
+ * by older versions are not used. */
+#define BVH_CACHE_VERSION 2
+
+static const char bvh_cache_magic[8] = {'C', 'Y', 'C', 'L', 'B', 'V', 'H', '2'};
+
+/* Hashing */
+
+static void md5_append_data(MD5Hash &md5, const void *data, size_t size)
+{
+  /* MD5Hash takes an int size, so append large arrays in chunks. */
+  const uint8_t *bytes = (const uint8_t *)data;
+  const size_t chunk_size = 1 << 30;
+  while (size > 0) {
+    const size_t append_size = (size < chunk_size) ? size : chunk_size;
+    md5.append(bytes, (int)append_size);
+    bytes += append_size;
+    size -= append_size;
+  }
+}
+
+template<typename T> static void md5_append_value(MD5Hash &md5, const T &value)
+{
+  md5_append_data(md5, &value, sizeof(value));
+}
+
+template<typename T> static void md5_append_array(MD5Hash &md5, const array<T> &data)
+{
+  md5_append_value(md5, data.size());
+  if (data.size()) {
+    md5_append_data(md5, data.data(), data.size() * sizeof(T));
+  }
+}
+
+static void md5_append_params(MD5Hash &md5, const BVHParams &params)
+{
+  md5_append_value(md5, params.use_spatial_split);
+  md5_append_value(md5, params.spatial_split_alpha);
+  md5_append_value(md5, params.unaligned_split_threshold);
+  md5_append_value(md5, params.sah_node_cost);
+  md5_append_value(md5, params.sah_primitive_cost);
+  md5_append_value(md5, params.min_leaf_size);
+  md5_append_value(md5, params.max_triangle_leaf_size);
+  md5_append_value(md5, params.max_motion_triangle_leaf_size);
+  md5_append_value(md5, params.max_curve_leaf_size);
+  md5_append_value(md5, params.max_motion_curve_leaf_size);
+  md5_append_value(md5, params.top_level);
+  md5_append_value(md5, params.bvh_layout);
+  md5_append_value(md5, params.use_unaligned_nodes);
+  md5_append_value(md5, params.num_motion_curve_steps);
+  md5_append_value(md5, params.num_motion_triangle_steps);
+  md5_append_value(md5, params.bvh_type);
+  md5_append_value(md5, params.curve_subdivisions);
+}
+
+static string geometry_primitives_hash(const Geometry *geom)
+{
+  MD5Hash md5;
+
+  if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
+    const Mesh *mesh = static_cast<const Mesh *>(geom);
+    md5_append_array(md5, mesh->get_verts());
+    md5_append_array(md5, mesh->get_triangles());
+  }
+  else if (geom->geometry_type == Geometry::HAIR) {
+    const Hair *hair = static_cast<const Hair *>(geom);
+    md5_append_array(md5, hair->get_curve_keys());
+    md5_append_array(md5, hair->get_curve_radius());
+    md5_append_array(md5, hair->get_curve_first_key());
+  }
+
+  if (geom->has_motion_blur()) {
+    md5_append_value(md5, geom->get_motion_steps());
+    const Attribute *attr = geom->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION);
+    if (attr) {
+      md5_append_value(md5, attr->buffer.size());
+      md5_append_data(md5, attr->data(), attr->buffer.size());
+    }
+  }
+
+  return md5.get_hex();
+}
+
+void bvh_cache_update_geometry_hash(Geometry *geom)
+{
+  if (!geom->bvh_cache_hash.empty() && !geom->is_modified()) {
+    return;
+  }
+
+  const string hash = geometry_primitives_hash(geom);
+  if (!geom->bvh_cache_hash.empty() && hash != geom->bvh_cache_hash) {
+    geom->bvh_cache_deforming = true;
+  }
+  if (geom->has_motion_blur() && geom->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION)) {
+    geom->bvh_cache_deforming = true;
+  }
+  geom->bvh_cache_hash = hash;
+}
+
+static void md5_append_geometry(MD5Hash &md5, const BVHParams &params, Geometry *geom)
+{
+  md5_append_value(md5, geom->geometry_type);
+  md5_append_value(md5, geom->primitive_type());
+  md5_append_value(md5, geom->need_build_bvh(params.bvh_layout));
+
+  /* Primitive indices in the scene level BVH are offset into the global arrays. */
+  if (params.top_level) {
+    md5_append_value(md5, geom->prim_offset);
+    if (geom->geometry_type == Geometry::HAIR) {
+      md5_append_value(md5, static_cast<const Hair *>(geom)->curve_segment_offset);
+    }
+  }
+
+  /* Modified geometry is hashed in #Geometry::compute_bvh, before any BVH is built. */
+  if (geom->bvh_cache_hash.empty()) {
+    bvh_cache_update_geometry_hash(geom);
+  }
+  md5.append(geom->bvh_cache_hash);
+}
+
+string bvh_cache_key(const BVHParams &params,
+                     const vector<Geometry *> &geometry,
+                     const vector<Object *> &objects)
+{
+  MD5Hash md5;
+
+  md5_append_value(md5, BVH_CACHE_VERSION);
+  md5_append_params(md5, params);
+
+  /* Instanced geometry is merged into the scene level BVH in the order of the geometry. */
+  unordered_map<const Geometry *, int> geometry_index;
+  md5_append_value(md5, geometry.size());
+  foreach (Geometry *geom, geometry) {
+    geometry_index[geom] = (int)geometry_index.size();
+    md5_append_geometry(md5, params, geom);
+    if (geom->bvh_cache_deforming) {
+      return "";
+    }
+  }
+
+  md5_append_value(md5, objects.size());
+  foreach (Object *ob, objects) {
+    Geometry *geom = ob->get_geometry();
+    unordered_map<const Geometry *, int>::const_iterator it = geometry_index.find(geom);
+    if (it != geometry_index.end()) {
+      md5_append_value(md5, it->second);
+    }
+    else {
+      /* Object which is not part of the geometry list, as for geometry level BVHs. */
+      md5_append_value(md5, -1);
+      md5_append_geometry(md5, params, geom);
+      if (geom->bvh_cache_deforming) {
+        return "";
+      }
+    }
+
+    const BoundBox &bounds = ob->bounds;
+    md5_append_value(md5, make_float2(bounds.min.x, bounds.max.x));
+    md5_append_value(md5, make_float2(bounds.min.y, bounds.max.y));
+    md5_append_value(md5, make_float2(bounds.min.z, bounds.max.z));
+    md5_append_value(md5, ob->is_traceable());
+    md5_append_value(md5, ob->visibility_for_tracing());
+  }
+
+  return md5.get_hex();
+}
+
+/* Reading and Writing */
+
+template<typename T> static void cache_write_value(vector<uint8_t> &binary, const T &value)
+{
+  const uint8_t *bytes = (const uint8_t *)&value;
+  binary.insert(binary.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T> static void cache_write_array(vector<uint8_t> &binary, const array<T> &data)
+{
+  cache_write_value(binary, (uint64_t)data.size());
+  if (data.size()) {
+    const uint8_t *bytes = (const uint8_t *)data.data();
+    binary.insert(binary.end(), bytes, bytes + data.size() * sizeof(T));
+  }
+}
+
+template<typename T>
+static bool cache_read_value(const vector<uint8_t> &binary, size_t &offset, T &value)
+{
+  if (offset + sizeof(T) > binary.size()) {
+    return false;
+  }
+  memcpy(&value, binary.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+template<typename T>
+static bool cache_read_array(const vector<uint8_t> &binary, size_t &offset, array<T> &data)
+{
+  uint64_t size;
+  if (!cache_read_value(binary, offset, size) || size > (binary.size() - offset) / sizeof(T)) {
+    return false;
+  }
+  data.resize(size);
+  if (size) {
+    memcpy(data.data(), binary.data() + offset, size * sizeof(T));
+  }
+  offset += size * sizeof(T);
+  return true;
+}
+
+static string bvh_cache_filepath(const string &directory, const string &key)
+{
+  return path_join(directory, "bvh_" + key + ".bin");
+}
+
+bool bvh_cache_read(const string &directory,
+                    const string &key,
+                    PackedBVH &pack,
+                    float &sah_cost)
+{
+  const string filepath = bvh_cache_filepath(directory, key);
+  if (!path_exists(filepath)) {
+    return false;
+  }
+
+  vector<uint8_t> binary;
+  if (!path_read_binary(filepath, binary)) {
+    return false;
+  }
+
+  /* Mark as recently used, the least recently modified files are removed first. */
+  path_touch(filepath);
+
+  size_t offset = 0;
+  char magic[sizeof(bvh_cache_magic)];
+  int version;
+  if (!cache_read_value(binary, offset, magic) ||
+      memcmp(magic, bvh_cache_magic, sizeof(magic)) != 0 ||
+      !cache_read_value(binary, offset, version) || version != BVH_CACHE_VERSION) {
+    VLOG(1) << "Ignoring BVH cache file with unknown format " << filepath;
+    return false;
+  }
+
+  PackedBVH cached_pack;
+  float cached_sah_cost;
+  if (!(cache_read_array(binary, offset, cached_pack.nodes) &&
+        cache_read_array(binary, offset, cached_pack.leaf_nodes) &&
+        cache_read_array(binary, offset, cached_pack.object_node) &&
+        cache_read_array(binary, offset, cached_pack.prim_type) &&
+        cache_read_array(binary, offset, cached_pack.prim_visibility) &&
+        cache_read_array(binary, offset, cached_pack.prim_index) &&
+        cache_read_array(binary, offset, cached_pack.prim_object) &&
+        cache_read_array(binary, offset, cached_pack.prim_time) &&
+        cache_read_value(binary, offset, cached_pack.root_index) &&
+        cache_read_value(binary, offset, cached_sah_cost))) {
+    VLOG(1) << "Ignoring truncated BVH cache file " << filepath;
+    return false;
+  }
+
+  pack = std::move(cached_pack);
+  sah_cost = cached_sah_cost;
+
+  VLOG(1) << "Loaded BVH from cache file " << filepath;
+  return true;
+}
+
+bool bvh_cache_write(const string &directory,
+                     const string &key,
+                     const PackedBVH &pack,
+                     const float sah_cost,
+                     const size_t max_size)
+{
+  vector<uint8_t> binary;
+  binary.insert(binary.end(), bvh_cache_magic, bvh_cache_magic + sizeof(bvh_cache_magic));
+  cache_write_value(binary, (int)BVH_CACHE_VERSION);
+  cache_write_array(binary, pack.nodes);
+  cache_write_array(binary, pack.leaf_nodes);
+  cache_write_array(binary, pack.object_node);
+  cache_write_array(binary, pack.prim_type);
+  cache_write_array(binary, pack.prim_visibility);
+  cache_write_array(binary, pack.prim_index);
+  cache_write_array(binary, pack.prim_object);
+  cache_write_array(binary, pack.prim_time);
+  cache_write_value(binary, pack.root_index);
+  cache_write_value(binary, sah_cost);
+
+  /* Write to a temporary file first, so other processes sharing the cache directory never read
+   * a partially written file. */
+  const string filepath = bvh_cache_filepath(directory, key);
+  /* Temporary files don't start with the cache file prefix, so that limiting the cache size does
+   * not remove files other processes are writing. */
+  const string temp_filepath = path_join(
+      directory,
+      string_printf("tmp_%p_%f_%s", (const void *)&pack, time_dt(), path_filename(filepath).c_str()));
+
+  if (!path_write_binary(temp_filepath, binary)) {
+    VLOG(1) << "Failed to write BVH cache file " << temp_filepath;
+    return false;
+  }
+
+  if (rename(temp_filepath.c_str(), filepath.c_str()) != 0) {
+    /* Another process may have written the same file in the meantime. */
+    path_remove(temp_filepath);
+    return path_exists(filepath);
+  }
+
+  VLOG(1) << "Wrote BVH to cache file " << filepath;
+
+  path_cache_limit_size(directory, "bvh_", max_size);
+  return true;
+}
+
+CCL_NAMESPACE_END
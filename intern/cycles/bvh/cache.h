@@ -0,0 +1,66 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BVH_CACHE_H__
+#define __BVH_CACHE_H__
+
+#include "util/string.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class BVHParams;
+class Geometry;
+class Object;
+struct PackedBVH;
+
+/* BVH Disk Cache
+ *
+ * Packed BVH2 data is stored in a directory, in files named by a hash of everything the build
+ * depends on. Renders of following frames or of other processes which find a file for the same
+ * parameters, geometry and objects load it instead of building the BVH again.
+ *
+ * The primitives of each geometry are hashed once per modification. BVHs containing deforming
+ * geometry are not cached, since they differ every frame. The least recently used files are
+ * removed when the directory exceeds its size limit. */
+
+/* Hash the primitives of the geometry again if it was modified. Geometry with deformation motion
+ * or whose primitives changed since they were first hashed is marked as deforming. */
+void bvh_cache_update_geometry_hash(Geometry *geom);
+
+/* Hash of the build parameters and the content of the geometry and objects. Empty if the BVH
+ * contains deforming geometry and should not be cached. */
+string bvh_cache_key(const BVHParams &params,
+                     const vector<Geometry *> &geometry,
+                     const vector<Object *> &objects);
+
+/* Read packed BVH from the cache, returns false if it does not exist or is invalid. */
+bool bvh_cache_read(const string &directory,
+                    const string &key,
+                    PackedBVH &pack,
+                    float &sah_cost);
+
+/* Write packed BVH to the cache, then remove the least recently used files until the cache is
+ * at most max_size bytes. */
+bool bvh_cache_write(const string &directory,
+                     const string &key,
+                     const PackedBVH &pack,
+                     const float sah_cost,
+                     const size_t max_size);
+
+CCL_NAMESPACE_END
+
+#endif /* __BVH_CACHE_H__ */
@@ -326,7 +326,9 @@ BVHEmbree::BVHEmbree(const BVHParams &params_,
     : BVH(params_, geometry_, objects_),
       scene(NULL),
       rtc_device(NULL),
-      build_quality(RTC_BUILD_QUALITY_REFIT)
+      stats(NULL),
+      build_quality(RTC_BUILD_QUALITY_REFIT),
+      build_bounds_area(0.0f)
 {
   SIMD_SET_FLUSH_TO_ZERO;
 }
@@ -338,9 +340,10 @@ BVHEmbree::~BVHEmbree()
   }
 }
 
-void BVHEmbree::build(Progress &progress, Stats *stats, RTCDevice rtc_device_)
+void BVHEmbree::build(Progress &progress, Stats *stats_, RTCDevice rtc_device_)
 {
   rtc_device = rtc_device_;
+  stats = stats_;
   assert(rtc_device);
 
   rtcSetDeviceErrorFunction(rtc_device, rtc_error_func, NULL);
@@ -392,6 +395,17 @@ void BVHEmbree::build(Progress &progress, Stats *stats, RTCDevice rtc_device_)
 
   rtcSetSceneProgressMonitorFunction(scene, rtc_progress_func, &progress);
   rtcCommitScene(scene);
+
+  build_bounds_area = geometry_bounds_area();
+}
+
+float BVHEmbree::geometry_bounds_area() const
+{
+  BoundBox bounds = BoundBox::empty;
+  foreach (Geometry *geom, geometry) {
+    bounds.grow(geom->bounds);
+  }
+  return bounds.safe_area();
 }
 
 void BVHEmbree::add_object(Object *ob, int i)
@@ -474,7 +488,11 @@ void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
   const size_t num_triangles = mesh->num_triangles();
 
   RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_TRIANGLE);
-  rtcSetGeometryBuildQuality(geom_id, build_quality);
+  /* In interactive sessions, build triangle BVHs which Embree refits instead of rebuilding them
+   * when only the vertices change. */
+  rtcSetGeometryBuildQuality(geom_id,
+                             (params.bvh_type == BVH_TYPE_DYNAMIC) ? RTC_BUILD_QUALITY_REFIT :
+                                                                     build_quality);
   rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
 
   unsigned *rtc_indices = (unsigned *)rtcSetNewGeometryBuffer(
@@ -690,6 +708,17 @@ void BVHEmbree::add_curves(const Object *ob, const Hair *hair, int i)
 
 void BVHEmbree::refit(Progress &progress)
 {
+  /* Rebuild when the geometry grew or shrank too much since the last build, as the nodes of the
+   * refitted BVH then overlap a lot. */
+  const float bounds_area = geometry_bounds_area();
+  if (build_bounds_area > 0.0f && bounds_area > 0.0f &&
+      fmaxf(bounds_area / build_bounds_area, build_bounds_area / bounds_area) >
+          params.refit_rebuild_threshold) {
+    VLOG(2) << "Rebuilding BVH, geometry bounds changed too much for refitting.";
+    build(progress, stats, rtc_device);
+    return;
+  }
+
   progress.set_substatus("Refitting BVH nodes");
 
   /* Update all vertex buffers, then tell Embree to rebuild/-fit the BVHs. */
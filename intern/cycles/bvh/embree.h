@@ -57,8 +57,16 @@ class BVHEmbree : public BVH {
   void set_tri_vertex_buffer(RTCGeometry geom_id, const Mesh *mesh, const bool update);
   void set_curve_vertex_buffer(RTCGeometry geom_id, const Hair *hair, const bool update);
 
+  /* Surface area of the bounds of all geometry in the BVH. */
+  float geometry_bounds_area() const;
+
   RTCDevice rtc_device;
+  Stats *stats;
   enum RTCBuildQuality build_quality;
+
+  /* Geometry bounds area at the last build, used to estimate how much refitting degraded the
+   * BVH, as Embree does not expose its nodes. */
+  float build_bounds_area;
 };
 
 CCL_NAMESPACE_END
@@ -19,6 +19,7 @@
 #define __BVH_PARAMS_H__
 
 #include "util/boundbox.h"
+#include "util/string.h"
 
 #include "kernel/types.h"
 
@@ -38,7 +39,8 @@ enum BVHType {
   /* BVH supports dynamic updates of geometry.
    *
    * Faster for updating BVH tree when doing modifications in viewport,
-   * but slower for rendering.
+   * but slower for rendering. The BVH2 builder splits the top levels of
+   * the tree along a Morton curve instead of binning for faster builds.
    */
   BVH_TYPE_DYNAMIC = 0,
   /* BVH tree is calculated for specific scene, updates in geometry
@@ -112,6 +114,16 @@ class BVHParams {
   /* These are needed for Embree. */
   int curve_subdivisions;
 
+  /* Refitting keeps the topology of the BVH, which becomes less efficient to traverse as
+   * primitives move. Rebuild instead when the estimated cost of the refitted BVH exceeds the
+   * cost after the last build by this factor. */
+  float refit_rebuild_threshold;
+
+  /* Directory to store built BVHs in and load them from, disabled when empty. */
+  string cache_path;
+  /* Size limit of the cache directory in bytes. */
+  size_t cache_size;
+
   /* fixed parameters */
   enum { MAX_DEPTH = 64, MAX_SPATIAL_DEPTH = 48, NUM_SPATIAL_BINS = 32 };
 
@@ -143,6 +155,10 @@ class BVHParams {
     bvh_type = 0;
 
     curve_subdivisions = 4;
+
+    refit_rebuild_threshold = 1.5f;
+
+    cache_size = 0;
   }
 
   /* SAH costs */
@@ -78,6 +78,8 @@ CPUDevice::CPUDevice(const DeviceInfo &info_, Stats &stats_, Profiler &profiler_
 #ifdef WITH_OSL
   kernel_globals.osl = &osl_globals;
 #endif
+  kernel_globals.texture_cache = NULL;
+  kernel_globals.guiding = NULL;
 #ifdef WITH_EMBREE
   embree_device = rtcNewDevice("verbose=0");
 #endif
@@ -314,6 +316,16 @@ void *CPUDevice::get_cpu_osl_memory()
 #endif
 }
 
+void CPUDevice::set_cpu_texture_cache(void *texture_system)
+{
+  kernel_globals.texture_cache = texture_system;
+}
+
+void CPUDevice::set_cpu_path_guiding(const KernelPathGuiding *guiding)
+{
+  kernel_globals.guiding = guiding;
+}
+
 bool CPUDevice::load_kernels(const uint /*kernel_features*/)
 {
   return true;
@@ -89,6 +89,8 @@ class CPUDevice : public Device {
   virtual void get_cpu_kernel_thread_globals(
       vector<CPUKernelThreadGlobals> &kernel_thread_globals) override;
   virtual void *get_cpu_osl_memory() override;
+  virtual void set_cpu_texture_cache(void *texture_system) override;
+  virtual void set_cpu_path_guiding(const KernelPathGuiding *guiding) override;
 
  protected:
   virtual bool load_kernels(uint /*kernel_features*/) override;
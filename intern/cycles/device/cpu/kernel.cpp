@@ -44,6 +44,7 @@ CPUKernels::CPUKernels()
       REGISTER_KERNEL(integrator_shade_surface),
       REGISTER_KERNEL(integrator_shade_volume),
       REGISTER_KERNEL(integrator_megakernel),
+      REGISTER_KERNEL(integrator_wavefront),
       /* Shader evaluation. */
       REGISTER_KERNEL(shader_eval_displace),
       REGISTER_KERNEL(shader_eval_background),
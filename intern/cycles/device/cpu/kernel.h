@@ -53,6 +53,13 @@ class CPUKernels {
   IntegratorShadeFunction integrator_shade_volume;
   IntegratorShadeFunction integrator_megakernel;
 
+  using IntegratorWavefrontFunction = CPUKernelFunction<void (*)(const KernelGlobalsCPU *kg,
+                                                                 IntegratorStateCPU *states,
+                                                                 const int num_states,
+                                                                 ccl_global float *render_buffer)>;
+
+  IntegratorWavefrontFunction integrator_wavefront;
+
   /* Shader evaluation. */
 
   using ShaderEvalFunction = CPUKernelFunction<void (*)(
@@ -21,6 +21,8 @@
 #include "kernel/osl/globals.h"
 // clang-format on
 
+#include "kernel/device/cpu/texture_cache.h"
+
 #include "util/profiling.h"
 
 CCL_NAMESPACE_BEGIN
@@ -37,6 +39,10 @@ CPUKernelThreadGlobals::CPUKernelThreadGlobals(const KernelGlobalsCPU &kernel_gl
 #else
   (void)osl_globals_memory;
 #endif
+
+  if (texture_cache) {
+    texture_cache_tdata = texture_cache_thread_init(texture_cache);
+  }
 }
 
 CPUKernelThreadGlobals::CPUKernelThreadGlobals(CPUKernelThreadGlobals &&other) noexcept
@@ -50,6 +56,10 @@ CPUKernelThreadGlobals::~CPUKernelThreadGlobals()
 #ifdef WITH_OSL
   OSLShader::thread_free(this);
 #endif
+
+  if (texture_cache_tdata) {
+    texture_cache_thread_free(texture_cache_tdata);
+  }
 }
 
 CPUKernelThreadGlobals &CPUKernelThreadGlobals::operator=(CPUKernelThreadGlobals &&other)
@@ -70,6 +80,7 @@ void CPUKernelThreadGlobals::reset_runtime_memory()
 #ifdef WITH_OSL
   osl = nullptr;
 #endif
+  texture_cache_tdata = nullptr;
 }
 
 void CPUKernelThreadGlobals::start_profiling()
@@ -380,6 +380,14 @@ void *Device::get_cpu_osl_memory()
   return nullptr;
 }
 
+void Device::set_cpu_texture_cache(void * /*texture_system*/)
+{
+}
+
+void Device::set_cpu_path_guiding(const KernelPathGuiding * /*guiding*/)
+{
+}
+
 /* DeviceInfo */
 
 CCL_NAMESPACE_END
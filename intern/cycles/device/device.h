@@ -42,6 +42,7 @@ class DeviceQueue;
 class Progress;
 class CPUKernels;
 class CPUKernelThreadGlobals;
+struct KernelPathGuiding;
 
 /* Device Types */
 
@@ -180,6 +181,10 @@ class Device {
       vector<CPUKernelThreadGlobals> & /*kernel_thread_globals*/);
   /* Get OpenShadingLanguage memory buffer. */
   virtual void *get_cpu_osl_memory();
+  /* Set OpenImageIO texture system used for images in the texture cache. */
+  virtual void set_cpu_texture_cache(void *texture_system);
+  /* Set path guiding distribution and training data used by the kernels. */
+  virtual void set_cpu_path_guiding(const KernelPathGuiding *guiding);
 
   /* acceleration structure building */
   virtual void build_bvh(BVH *bvh, Progress &progress, bool refit);
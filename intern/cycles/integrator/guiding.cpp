@@ -0,0 +1,93 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "integrator/guiding.h"
+
+#include "util/algorithm.h"
+#include "util/log.h"
+#include "util/math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Fraction of a uniform distribution mixed into every trained cell, so that directions which
+ * received no training data yet still have a non-zero probability. */
+static const float guiding_uniform_fraction = 0.1f;
+
+PathGuiding::PathGuiding()
+    : distribution_(GUIDING_NUM_CELLS * GUIDING_NUM_BINS, 0.0f),
+      training_(GUIDING_NUM_CELLS * GUIDING_NUM_BINS, 0.0f)
+{
+  kernel_guiding_.distribution = distribution_.data();
+  kernel_guiding_.training = training_.data();
+  kernel_guiding_.use_training = false;
+}
+
+void PathGuiding::reset()
+{
+  std::fill(distribution_.begin(), distribution_.end(), 0.0f);
+  std::fill(training_.begin(), training_.end(), 0.0f);
+  kernel_guiding_.use_training = false;
+}
+
+void PathGuiding::set_use_training(bool use_training)
+{
+  kernel_guiding_.use_training = use_training;
+}
+
+void PathGuiding::update_distribution()
+{
+  int num_trained_cells = 0;
+
+  for (int cell = 0; cell < GUIDING_NUM_CELLS; cell++) {
+    const float *training = training_.data() + cell * GUIDING_NUM_BINS;
+    float *cdf = distribution_.data() + cell * GUIDING_NUM_BINS;
+
+    float sum = 0.0f;
+    for (int bin = 0; bin < GUIDING_NUM_BINS; bin++) {
+      sum += training[bin];
+    }
+
+    if (!(sum > 0.0f) || !isfinite_safe(sum)) {
+      std::fill(cdf, cdf + GUIDING_NUM_BINS, 0.0f);
+      continue;
+    }
+
+    const float uniform = sum * guiding_uniform_fraction / GUIDING_NUM_BINS;
+    float cumulative = 0.0f;
+    for (int bin = 0; bin < GUIDING_NUM_BINS; bin++) {
+      cumulative += training[bin] + uniform;
+      cdf[bin] = cumulative;
+    }
+
+    const float inv_cumulative = 1.0f / cumulative;
+    for (int bin = 0; bin < GUIDING_NUM_BINS - 1; bin++) {
+      cdf[bin] *= inv_cumulative;
+    }
+    cdf[GUIDING_NUM_BINS - 1] = 1.0f;
+
+    num_trained_cells++;
+  }
+
+  VLOG(3) << "Updated path guiding distribution, " << num_trained_cells << " of "
+          << GUIDING_NUM_CELLS << " cells trained.";
+}
+
+const KernelPathGuiding *PathGuiding::get_kernel_guiding() const
+{
+  return &kernel_guiding_;
+}
+
+CCL_NAMESPACE_END
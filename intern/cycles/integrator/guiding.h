@@ -0,0 +1,55 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "kernel/types.h"
+
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Path guiding distribution and training data, shared with the CPU kernels which sample the
+ * distribution and accumulate the training data. See `kernel/integrator/guiding.h`.
+ *
+ * The render scheduler schedules the first samples as training iterations of doubling length.
+ * After every iteration the distribution is rebuilt from all training data so far, so that the
+ * following samples are guided by a more accurate distribution and record more useful training
+ * data. */
+class PathGuiding {
+ public:
+  PathGuiding();
+
+  /* Discard distribution and training data, for rendering from scratch. */
+  void reset();
+
+  /* Record path contributions into the training data in the following path tracing work. */
+  void set_use_training(bool use_training);
+
+  /* Rebuild the distribution from the training data.
+   * Must not be called while kernels are executing. */
+  void update_distribution();
+
+  const KernelPathGuiding *get_kernel_guiding() const;
+
+ protected:
+  vector<float> distribution_;
+  vector<float> training_;
+
+  KernelPathGuiding kernel_guiding_;
+};
+
+CCL_NAMESPACE_END
@@ -67,6 +67,8 @@ PathTrace::PathTrace(Device *device,
 
 PathTrace::~PathTrace()
 {
+  set_device_path_guiding(nullptr);
+
   /* Destroy any GPU resource which was used for graphics interop.
    * Need to have access to the PathTraceDisplay as it is the only source of drawing context which
    * is used for interop. */
@@ -184,6 +186,7 @@ void PathTrace::render_pipeline(RenderWork render_work)
   render_scheduler_.set_need_schedule_cryptomatte(device_scene_->data.film.cryptomatte_passes !=
                                                   0);
 
+  render_init_path_guiding(render_work);
   render_init_kernel_execution();
 
   render_scheduler_.report_work_begin(render_work);
@@ -197,6 +200,10 @@ void PathTrace::render_pipeline(RenderWork render_work)
     return;
   }
 
+  if (guiding_ && render_work.guiding.train) {
+    guiding_->update_distribution();
+  }
+
   adaptive_sample(render_work);
   if (render_cancel_.is_requested) {
     return;
@@ -220,6 +227,34 @@ void PathTrace::render_pipeline(RenderWork render_work)
   finalize_full_buffer_on_disk(render_work);
 }
 
+void PathTrace::render_init_path_guiding(const RenderWork &render_work)
+{
+  if (!(device_scene_->data.kernel_features & KERNEL_FEATURE_PATH_GUIDING)) {
+    if (guiding_) {
+      set_device_path_guiding(nullptr);
+      guiding_.reset();
+    }
+    return;
+  }
+
+  if (!guiding_) {
+    guiding_ = make_unique<PathGuiding>();
+    set_device_path_guiding(guiding_->get_kernel_guiding());
+  }
+
+  if (render_work.init_render_buffers) {
+    guiding_->reset();
+  }
+
+  guiding_->set_use_training(render_work.guiding.train);
+}
+
+void PathTrace::set_device_path_guiding(const KernelPathGuiding *guiding)
+{
+  device_->foreach_device(
+      [guiding](Device *path_trace_device) { path_trace_device->set_cpu_path_guiding(guiding); });
+}
+
 void PathTrace::render_init_kernel_execution()
 {
   for (auto &&path_trace_work : path_trace_works_) {
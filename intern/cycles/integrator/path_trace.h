@@ -17,6 +17,7 @@
 #pragma once
 
 #include "integrator/denoiser.h"
+#include "integrator/guiding.h"
 #include "integrator/pass_accessor.h"
 #include "integrator/path_trace_work.h"
 #include "integrator/work_balancer.h"
@@ -189,6 +190,11 @@ class PathTrace {
    * `render_cancel_` in the consistent state. */
   void render_pipeline(RenderWork render_work);
 
+  /* Share path guiding data with the devices, and reset it when rendering from scratch. Needs to
+   * happen before kernel execution is initialized. */
+  void render_init_path_guiding(const RenderWork &render_work);
+  void set_device_path_guiding(const KernelPathGuiding *guiding);
+
   /* Initialize kernel execution on all integrator queues. */
   void render_init_kernel_execution();
 
@@ -259,6 +265,9 @@ class PathTrace {
   /* Per-path trace work information needed for multi-device balancing. */
   vector<WorkBalanceInfo> work_balance_infos_;
 
+  /* Learned distribution for path guiding, only allocated when it is used. */
+  unique_ptr<PathGuiding> guiding_;
+
   /* Render buffer parameters of the full frame and current big tile. */
   BufferParams full_params_;
   BufferParams big_tile_params_;
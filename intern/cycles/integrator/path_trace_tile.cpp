@@ -30,7 +30,8 @@ PathTraceTile::PathTraceTile(PathTrace &path_trace)
                          path_trace.get_render_tile_size(),
                          path_trace.get_render_size(),
                          path_trace.get_render_tile_params().layer,
-                         path_trace.get_render_tile_params().view),
+                         path_trace.get_render_tile_params().view,
+                         path_trace.get_num_render_tile_samples()),
       path_trace_(path_trace),
       copied_from_device_(false)
 {
@@ -28,6 +28,7 @@
 #include "session/buffers.h"
 
 #include "util/atomic.h"
+#include "util/debug.h"
 #include "util/log.h"
 #include "util/tbb.h"
 
@@ -85,31 +86,76 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
   }
 
   tbb::task_arena local_arena = local_tbb_arena_create(device_);
-  local_arena.execute([&]() {
-    tbb::parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
-      if (is_cancel_requested()) {
-        return;
-      }
 
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
+  if (DebugFlags().cpu.wavefront) {
+    /* Every pixel uses a pair of states, the second one for the shadow catcher. Pixels of a chunk
+     * are consecutive in a row, so that their paths are coherent. */
+    const int chunk_width = INTEGRATOR_WAVEFRONT_SIZE_CPU / 2;
+    const int64_t row_chunks_num = divide_up(image_width, chunk_width);
+    const int64_t chunks_num = row_chunks_num * image_height;
+
+    wavefront_thread_states_.resize(kernel_thread_globals_.size());
 
-      KernelWorkTile work_tile;
-      work_tile.x = effective_buffer_params_.full_x + x;
-      work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
-      work_tile.start_sample = start_sample;
-      work_tile.sample_offset = sample_offset;
-      work_tile.num_samples = 1;
-      work_tile.offset = effective_buffer_params_.offset;
-      work_tile.stride = effective_buffer_params_.stride;
+    local_arena.execute([&]() {
+      tbb::parallel_for(int64_t(0), chunks_num, [&](int64_t chunk_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
 
-      CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+        const int y = chunk_index / row_chunks_num;
+        const int x = (chunk_index - y * row_chunks_num) * chunk_width;
+
+        KernelWorkTile work_tile;
+        work_tile.x = effective_buffer_params_.full_x + x;
+        work_tile.y = effective_buffer_params_.full_y + y;
+        work_tile.w = min(chunk_width, int(image_width - x));
+        work_tile.h = 1;
+        work_tile.start_sample = start_sample;
+        work_tile.sample_offset = sample_offset;
+        work_tile.num_samples = 1;
+        work_tile.offset = effective_buffer_params_.offset;
+        work_tile.stride = effective_buffer_params_.stride;
+
+        const int thread_index = tbb::this_task_arena::current_thread_index();
+        CPUKernelThreadGlobals *kernel_globals = &kernel_thread_globals_[thread_index];
+
+        vector<IntegratorStateCPU> &states = wavefront_thread_states_[thread_index];
+        if (states.empty()) {
+          states.resize(INTEGRATOR_WAVEFRONT_SIZE_CPU);
+        }
 
-      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+        render_samples_wavefront(kernel_globals, states.data(), work_tile, samples_num);
+      });
     });
-  });
+  }
+  else {
+    local_arena.execute([&]() {
+      tbb::parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
+
+        const int y = work_index / image_width;
+        const int x = work_index - y * image_width;
+
+        KernelWorkTile work_tile;
+        work_tile.x = effective_buffer_params_.full_x + x;
+        work_tile.y = effective_buffer_params_.full_y + y;
+        work_tile.w = 1;
+        work_tile.h = 1;
+        work_tile.start_sample = start_sample;
+        work_tile.sample_offset = sample_offset;
+        work_tile.num_samples = 1;
+        work_tile.offset = effective_buffer_params_.offset;
+        work_tile.stride = effective_buffer_params_.stride;
+
+        CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(
+            kernel_thread_globals_);
+
+        render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+      });
+    });
+  }
   if (device_->profiler.active()) {
     for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
       kernel_globals.stop_profiling();
@@ -166,6 +212,66 @@ void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobalsCPU *kernel_glo
   }
 }
 
+void PathTraceWorkCPU::render_samples_wavefront(KernelGlobalsCPU *kernel_globals,
+                                                IntegratorStateCPU *states,
+                                                const KernelWorkTile &work_tile,
+                                                const int samples_num)
+{
+  const bool has_bake = device_scene_->data.bake.use;
+  const int num_states = work_tile.w * 2;
+
+  /* Pixels are tracked separately, as adaptive sampling can stop them at different samples. */
+  bool pixel_active[INTEGRATOR_WAVEFRONT_SIZE_CPU / 2];
+  for (int i = 0; i < work_tile.w; i++) {
+    pixel_active[i] = true;
+  }
+
+  /* Shadow catcher states are only queued by splitting the main path. */
+  for (int i = 0; i < num_states; i++) {
+    path_state_init_queues(&states[i]);
+  }
+
+  KernelWorkTile pixel_work_tile = work_tile;
+  pixel_work_tile.w = 1;
+
+  float *render_buffer = buffers_->buffer.data();
+
+  for (int sample = 0; sample < samples_num; ++sample) {
+    if (is_cancel_requested()) {
+      break;
+    }
+
+    bool any_pixel_active = false;
+
+    for (int i = 0; i < work_tile.w; i++) {
+      if (!pixel_active[i]) {
+        continue;
+      }
+
+      pixel_work_tile.x = work_tile.x + i;
+      pixel_work_tile.start_sample = work_tile.start_sample + sample;
+
+      IntegratorStateCPU *state = &states[i * 2];
+      if (has_bake) {
+        pixel_active[i] = kernels_.integrator_init_from_bake(
+            kernel_globals, state, &pixel_work_tile, render_buffer);
+      }
+      else {
+        pixel_active[i] = kernels_.integrator_init_from_camera(
+            kernel_globals, state, &pixel_work_tile, render_buffer);
+      }
+
+      any_pixel_active |= pixel_active[i];
+    }
+
+    if (!any_pixel_active) {
+      break;
+    }
+
+    kernels_.integrator_wavefront(kernel_globals, states, num_states, render_buffer);
+  }
+}
+
 void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
                                        PassMode pass_mode,
                                        int num_samples)
@@ -69,6 +69,13 @@ class PathTraceWorkCPU : public PathTraceWork {
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Path tracing routine which traces the paths of a chunk of pixels together, one sample at a
+   * time. The states are storage for INTEGRATOR_WAVEFRONT_SIZE_CPU path states. */
+  void render_samples_wavefront(KernelGlobalsCPU *kernel_globals,
+                                IntegratorStateCPU *states,
+                                const KernelWorkTile &work_tile,
+                                const int samples_num);
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
@@ -78,6 +85,10 @@ class PathTraceWorkCPU : public PathTraceWork {
    * accessing it, but some "localization" is required to decouple from kernel globals stored
    * on the device level. */
   vector<CPUKernelThreadGlobals> kernel_thread_globals_;
+
+  /* Path states of the wavefront integrator, for every thread. Allocated on first use, as they
+   * take a considerable amount of memory. */
+  vector<vector<IntegratorStateCPU>> wavefront_thread_states_;
 };
 
 CCL_NAMESPACE_END
@@ -68,6 +68,11 @@ bool RenderScheduler::is_adaptive_sampling_used() const
   return adaptive_sampling_.use;
 }
 
+void RenderScheduler::set_guiding_training_samples(int num_samples)
+{
+  guiding_training_samples_ = num_samples;
+}
+
 void RenderScheduler::set_start_sample(int start_sample)
 {
   start_sample_ = start_sample;
@@ -333,6 +338,8 @@ RenderWork RenderScheduler::get_render_work()
 
   render_work.init_render_buffers = (render_work.path_trace.start_sample == get_start_sample());
 
+  render_work.guiding.train = work_need_guiding_training();
+
   /* NOTE: Rebalance scheduler requires current number of samples to not be advanced forward. */
   render_work.rebalance = work_need_rebalance();
 
@@ -619,6 +626,12 @@ string RenderScheduler::full_report() const
     result += "  Threshold: " + to_string(adaptive_sampling_.threshold) + "\n";
   }
 
+  result += "\nPath guiding:\n";
+  result += "  Use: " + string_from_bool(guiding_training_samples_ != 0) + "\n";
+  if (guiding_training_samples_) {
+    result += "  Training Samples: " + to_string(guiding_training_samples_) + "\n";
+  }
+
   result += "\nDenoiser:\n";
   result += "  Use: " + string_from_bool(denoiser_params_.use) + "\n";
   if (denoiser_params_.use) {
@@ -867,6 +880,15 @@ int RenderScheduler::get_num_samples_to_path_trace() const
                                 min(num_samples_to_occupy, max_num_samples_to_render));
   }
 
+  /* Stop at the end of the current path guiding training iteration, so that the following samples
+   * use the distribution rebuilt from it. */
+  if (work_need_guiding_training()) {
+    const int iteration_end = min(
+        (int)next_power_of_two(state_.num_rendered_samples + 1) - 1, guiding_training_samples_);
+    num_samples_to_render = min(num_samples_to_render,
+                                iteration_end - state_.num_rendered_samples);
+  }
+
   /* If adaptive sampling is not use, render as many samples per update as possible, keeping the
    * device fully occupied, without much overhead of display updates. */
   if (!adaptive_sampling_.use) {
@@ -920,6 +942,16 @@ bool RenderScheduler::work_need_adaptive_filter() const
   return adaptive_sampling_.need_filter(get_rendered_sample());
 }
 
+bool RenderScheduler::work_need_guiding_training() const
+{
+  /* Training data of lower resolution navigation renders is not kept. */
+  if (state_.resolution_divider != pixel_size_) {
+    return false;
+  }
+
+  return state_.num_rendered_samples < guiding_training_samples_;
+}
+
 float RenderScheduler::work_adaptive_threshold() const
 {
   if (!use_progressive_noise_floor_) {
@@ -56,6 +56,12 @@ class RenderWork {
     bool postprocess = false;
   } cryptomatte;
 
+  struct {
+    /* Record path contributions for path guiding, and rebuild the guiding distribution from them
+     * after path tracing. */
+    bool train = false;
+  } guiding;
+
   /* Work related on the current tile. */
   struct {
     /* Write render buffers of the current tile.
@@ -115,6 +121,10 @@ class RenderScheduler {
 
   bool is_adaptive_sampling_used() const;
 
+  /* Number of samples at the start of rendering used to train path guiding, zero when path
+   * guiding is not used. */
+  void set_guiding_training_samples(int num_samples);
+
   /* Start sample for path tracing.
    * The scheduler will schedule work using this sample as the first one. */
   void set_start_sample(int start_sample);
@@ -254,6 +264,9 @@ class RenderScheduler {
   /* Whether adaptive sampling convergence check and filter is to happen. */
   bool work_need_adaptive_filter() const;
 
+  /* Whether the path tracing work starting at the current sample is to train path guiding. */
+  bool work_need_guiding_training() const;
+
   /* Calculate threshold for adaptive sampling. */
   float work_adaptive_threshold() const;
 
@@ -446,6 +459,10 @@ class RenderScheduler {
 
   AdaptiveSampling adaptive_sampling_;
 
+  /* Path guiding is trained in iterations of 1, 2, 4, ... samples, up to this number of samples,
+   * with the distribution rebuilt after every iteration. */
+  int guiding_training_samples_ = 0;
+
   /* Progressively lower adaptive sampling threshold level, keeping the image at a uniform noise
    * level. */
   bool use_progressive_noise_floor_ = false;
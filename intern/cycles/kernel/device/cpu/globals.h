@@ -35,6 +35,8 @@ struct OSLThreadData;
 struct OSLShadingSystem;
 #endif
 
+struct TextureCacheThreadData;
+
 typedef struct KernelGlobalsCPU {
 #define KERNEL_TEX(type, name) texture<type> name;
 #include "kernel/textures.h"
@@ -49,6 +51,13 @@ typedef struct KernelGlobalsCPU {
   OSLThreadData *osl_tdata;
 #endif
 
+  /* OpenImageIO texture system for images in the texture cache, and its per-thread data. */
+  void *texture_cache;
+  TextureCacheThreadData *texture_cache_tdata;
+
+  /* Path guiding distribution and training data. */
+  const KernelPathGuiding *guiding;
+
   /* **** Run-time data ****  */
 
   ProfilingState profiler;
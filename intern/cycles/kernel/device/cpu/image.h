@@ -22,6 +22,8 @@
 #  include <nanovdb/util/SampleFromVoxels.h>
 #endif
 
+#include "kernel/device/cpu/texture_cache.h"
+
 CCL_NAMESPACE_BEGIN
 
 /* Make template functions private so symbols don't conflict between kernels with different
@@ -604,6 +606,11 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, flo
       return TextureInterpolator<ushort4>::interp(info, x, y);
     case IMAGE_DATA_TYPE_FLOAT4:
       return TextureInterpolator<float4>::interp(info, x, y);
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE: {
+      float4 r;
+      texture_cache_lookup(kg->texture_cache_tdata, info, x, y, zero_float2(), zero_float2(), &r);
+      return r;
+    }
     default:
       assert(0);
       return make_float4(
@@ -611,6 +618,27 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, flo
   }
 }
 
+/* Lookup with derivatives of the texture coordinates, which are only used to choose the mipmap
+ * level of images in the texture cache. */
+ccl_device float4 kernel_tex_image_interp_with_derivatives(
+    KernelGlobals kg, int id, float x, float y, const float2 dx, const float2 dy)
+{
+  const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
+
+  if (info.data_type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    float4 r;
+    texture_cache_lookup(kg->texture_cache_tdata, info, x, y, dx, dy, &r);
+    return r;
+  }
+
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
+ccl_device_inline bool kernel_tex_image_use_derivatives(KernelGlobals kg, int id)
+{
+  return kernel_tex_fetch(__texture_info, id).data_type == IMAGE_DATA_TYPE_TEXTURE_CACHE;
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals kg,
                                              int id,
                                              float3 P,
@@ -48,6 +48,11 @@ KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_surface);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_volume);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel);
 
+void KERNEL_FUNCTION_FULL_NAME(integrator_wavefront)(const KernelGlobalsCPU *ccl_restrict kg,
+                                                     IntegratorStateCPU *states,
+                                                     const int num_states,
+                                                     ccl_global float *render_buffer);
+
 #undef KERNEL_INTEGRATOR_FUNCTION
 #undef KERNEL_INTEGRATOR_INIT_FUNCTION
 #undef KERNEL_INTEGRATOR_SHADE_FUNCTION
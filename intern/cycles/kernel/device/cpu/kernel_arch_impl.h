@@ -45,6 +45,7 @@
 #    include "kernel/integrator/shade_surface.h"
 #    include "kernel/integrator/shade_volume.h"
 #    include "kernel/integrator/megakernel.h"
+#    include "kernel/integrator/wavefront.h"
 
 #    include "kernel/film/adaptive_sampling.h"
 #    include "kernel/film/id_passes.h"
@@ -123,6 +124,14 @@ DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel)
 DEFINE_INTEGRATOR_SHADOW_KERNEL(intersect_shadow)
 DEFINE_INTEGRATOR_SHADOW_SHADE_KERNEL(shade_shadow)
 
+void KERNEL_FUNCTION_FULL_NAME(integrator_wavefront)(const KernelGlobalsCPU *kg,
+                                                     IntegratorStateCPU *states,
+                                                     const int num_states,
+                                                     ccl_global float *render_buffer)
+{
+  KERNEL_INVOKE(wavefront, kg, states, num_states, render_buffer);
+}
+
 /* --------------------------------------------------------------------
  * Shader evaluation.
  */
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "kernel/device/cpu/compat.h"
+
+#include "kernel/device/cpu/texture_cache.h"
+
+#include <OpenImageIO/texture.h>
+
+CCL_NAMESPACE_BEGIN
+
+struct TextureCacheThreadData {
+  OIIO::TextureSystem *texture_system;
+  OIIO::TextureSystem::Perthread *thread_info;
+};
+
+TextureCacheThreadData *texture_cache_thread_init(void *texture_system)
+{
+  TextureCacheThreadData *tdata = new TextureCacheThreadData();
+  tdata->texture_system = (OIIO::TextureSystem *)texture_system;
+  tdata->thread_info = tdata->texture_system->create_thread_info();
+  return tdata;
+}
+
+void texture_cache_thread_free(TextureCacheThreadData *tdata)
+{
+  tdata->texture_system->destroy_thread_info(tdata->thread_info);
+  delete tdata;
+}
+
+static OIIO::TextureOpt::Wrap texture_cache_wrap(const uint extension)
+{
+  switch (extension) {
+    case EXTENSION_REPEAT:
+      return OIIO::TextureOpt::WrapPeriodic;
+    case EXTENSION_EXTEND:
+      return OIIO::TextureOpt::WrapClamp;
+    case EXTENSION_CLIP:
+    default:
+      return OIIO::TextureOpt::WrapBlack;
+  }
+}
+
+void texture_cache_lookup(TextureCacheThreadData *tdata,
+                          const TextureInfo &info,
+                          const float x,
+                          const float y,
+                          const float2 dx,
+                          const float2 dy,
+                          float4 *result)
+{
+  /* The texture handle is stored in place of the pixels. */
+  OIIO::TextureSystem::TextureHandle *handle = *(OIIO::TextureSystem::TextureHandle **)info.data;
+
+  OIIO::TextureOpt options;
+  options.swrap = texture_cache_wrap(info.extension);
+  options.twrap = options.swrap;
+  /* Missing alpha channel is opaque, like for images in memory. */
+  options.fill = 1.0f;
+
+  switch (info.interpolation) {
+    case INTERPOLATION_CLOSEST:
+      options.interpmode = OIIO::TextureOpt::InterpClosest;
+      options.mipmode = OIIO::TextureOpt::MipModeOneLevel;
+      break;
+    case INTERPOLATION_CUBIC:
+    case INTERPOLATION_SMART:
+      options.interpmode = OIIO::TextureOpt::InterpSmartBicubic;
+      break;
+    case INTERPOLATION_LINEAR:
+    default:
+      options.interpmode = OIIO::TextureOpt::InterpBilinear;
+      break;
+  }
+
+  /* Images in Cycles are stored bottom to top, OpenImageIO uses top to bottom. */
+  float rgba[4];
+  const bool status = tdata->texture_system->texture(handle,
+                                                     tdata->thread_info,
+                                                     options,
+                                                     x,
+                                                     1.0f - y,
+                                                     dx.x,
+                                                     -dx.y,
+                                                     dy.x,
+                                                     -dy.y,
+                                                     4,
+                                                     rgba);
+
+  if (!status) {
+    /* Clear the error message, it would otherwise accumulate for every lookup. */
+    tdata->texture_system->geterror();
+    *result = make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+    return;
+  }
+
+  *result = make_float4(rgba[0], rgba[1], rgba[2], rgba[3]);
+}
+
+CCL_NAMESPACE_END
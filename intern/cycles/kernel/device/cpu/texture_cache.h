@@ -0,0 +1,46 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+/* Texture Cache
+ *
+ * Images of type IMAGE_DATA_TYPE_TEXTURE_CACHE are not loaded into memory by the image manager.
+ * Instead the OpenImageIO texture system reads the tiles and mipmap levels needed for rendering
+ * from disk on demand, and keeps the resident memory within a fixed budget.
+ *
+ * The lookup is not part of the kernel itself, as OpenImageIO headers can not be included in
+ * kernels compiled for different instruction sets. */
+
+CCL_NAMESPACE_BEGIN
+
+struct TextureCacheThreadData;
+
+/* Per-thread data, created for every thread that executes kernels. */
+TextureCacheThreadData *texture_cache_thread_init(void *texture_system);
+void texture_cache_thread_free(TextureCacheThreadData *tdata);
+
+/* Filtered lookup at the given texture coordinates, with the mipmap level chosen from the
+ * derivatives of the texture coordinates. Zero derivatives use the highest resolution. */
+void texture_cache_lookup(TextureCacheThreadData *tdata,
+                          const TextureInfo &info,
+                          const float x,
+                          const float y,
+                          const float2 dx,
+                          const float2 dy,
+                          float4 *result);
+
+CCL_NAMESPACE_END
@@ -223,6 +223,18 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, flo
   }
 }
 
+/* The texture cache is not supported on the GPU, all images are fully loaded. */
+ccl_device float4 kernel_tex_image_interp_with_derivatives(
+    KernelGlobals kg, int id, float x, float y, const float2 dx, const float2 dy)
+{
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
+ccl_device_inline bool kernel_tex_image_use_derivatives(KernelGlobals kg, int id)
+{
+  return false;
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals kg,
                                              int id,
                                              float3 P,
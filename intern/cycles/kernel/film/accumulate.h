@@ -19,6 +19,7 @@
 #include "kernel/film/adaptive_sampling.h"
 #include "kernel/film/write_passes.h"
 
+#include "kernel/integrator/guiding.h"
 #include "kernel/integrator/shadow_catcher.h"
 
 CCL_NAMESPACE_BEGIN
@@ -446,6 +447,10 @@ ccl_device_inline void kernel_accum_light(KernelGlobals kg,
   /* Direct light shadow. */
   kernel_accum_combined_pass(kg, path_flag, sample, contribution, buffer);
 
+#ifdef __PATH_GUIDING__
+  guiding_record_shadow_contribution(kg, state, contribution);
+#endif
+
 #ifdef __PASSES__
   if (kernel_data.film.light_pass_flag & PASS_ANY) {
     const uint32_t path_flag = INTEGRATOR_STATE(state, shadow_path, flag);
@@ -569,6 +574,10 @@ ccl_device_inline void kernel_accum_background(KernelGlobals kg,
   }
   kernel_accum_emission_or_background_pass(
       kg, state, contribution, buffer, kernel_data.film.pass_background);
+
+#ifdef __PATH_GUIDING__
+  guiding_record_contribution(kg, state, contribution);
+#endif
 }
 
 /* Write emission to render buffer. */
@@ -587,6 +596,10 @@ ccl_device_inline void kernel_accum_emission(KernelGlobals kg,
   kernel_accum_combined_pass(kg, path_flag, sample, contribution, buffer);
   kernel_accum_emission_or_background_pass(
       kg, state, contribution, buffer, kernel_data.film.pass_emission);
+
+#ifdef __PATH_GUIDING__
+  guiding_record_contribution(kg, state, contribution);
+#endif
 }
 
 CCL_NAMESPACE_END
@@ -43,9 +43,7 @@ ccl_device_inline void motion_triangle_verts_for_step(KernelGlobals kg,
 {
   if (step == numsteps) {
     /* center step: regular vertex location */
-    verts[0] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-    verts[1] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-    verts[2] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+    triangle_vertices_from_vindex(kg, tri_vindex, verts);
   }
   else {
     /* center step not store in this array */
@@ -70,9 +68,9 @@ ccl_device_inline void motion_triangle_normals_for_step(KernelGlobals kg,
 {
   if (step == numsteps) {
     /* center step: regular vertex location */
-    normals[0] = kernel_tex_fetch(__tri_vnormal, tri_vindex.x);
-    normals[1] = kernel_tex_fetch(__tri_vnormal, tri_vindex.y);
-    normals[2] = kernel_tex_fetch(__tri_vnormal, tri_vindex.z);
+    normals[0] = triangle_vertex_normal(kg, tri_vindex.x);
+    normals[1] = triangle_vertex_normal(kg, tri_vindex.y);
+    normals[2] = triangle_vertex_normal(kg, tri_vindex.z);
   }
   else {
     /* center step is not stored in this array */
@@ -24,14 +24,49 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Vertex locations are stored for every triangle corner, so intersection does not need to look
+ * up the vertex indices. The compact geometry layout stores them once per vertex instead, and
+ * vertex normals octahedral encoded in 32 bits. */
+
+ccl_device_inline void triangle_vertices_from_vindex(KernelGlobals kg,
+                                                     const uint4 tri_vindex,
+                                                     float3 P[3])
+{
+#ifdef __COMPACT_GEOMETRY__
+  if (kernel_data.bvh.compact_geometry) {
+    P[0] = kernel_tex_fetch(__tri_verts, tri_vindex.x);
+    P[1] = kernel_tex_fetch(__tri_verts, tri_vindex.y);
+    P[2] = kernel_tex_fetch(__tri_verts, tri_vindex.z);
+    return;
+  }
+#endif
+
+  P[0] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
+  P[1] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
+  P[2] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+}
+
+ccl_device_inline float3 triangle_vertex_normal(KernelGlobals kg, const uint vertex)
+{
+#ifdef __COMPACT_GEOMETRY__
+  if (kernel_data.bvh.compact_geometry) {
+    return oct_uint_to_float3(kernel_tex_fetch(__tri_vnormal_oct, vertex));
+  }
+#endif
+
+  return kernel_tex_fetch(__tri_vnormal, vertex);
+}
+
 /* Normal on triangle. */
 ccl_device_inline float3 triangle_normal(KernelGlobals kg, ccl_private ShaderData *sd)
 {
   /* load triangle vertices */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, sd->prim);
-  const float3 v0 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-  const float3 v1 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-  const float3 v2 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+  float3 verts[3];
+  triangle_vertices_from_vindex(kg, tri_vindex, verts);
+  const float3 v0 = verts[0];
+  const float3 v1 = verts[1];
+  const float3 v2 = verts[2];
 
   /* return normal */
   if (sd->object_flag & SD_OBJECT_NEGATIVE_SCALE_APPLIED) {
@@ -54,9 +89,11 @@ ccl_device_inline void triangle_point_normal(KernelGlobals kg,
 {
   /* load triangle vertices */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  float3 v0 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-  float3 v1 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-  float3 v2 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+  float3 verts[3];
+  triangle_vertices_from_vindex(kg, tri_vindex, verts);
+  const float3 v0 = verts[0];
+  const float3 v1 = verts[1];
+  const float3 v2 = verts[2];
   /* compute point */
   float t = 1.0f - u - v;
   *P = (u * v0 + v * v1 + t * v2);
@@ -78,9 +115,7 @@ ccl_device_inline void triangle_point_normal(KernelGlobals kg,
 ccl_device_inline void triangle_vertices(KernelGlobals kg, int prim, float3 P[3])
 {
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  P[0] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-  P[1] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-  P[2] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+  triangle_vertices_from_vindex(kg, tri_vindex, P);
 }
 
 /* Triangle vertex locations and vertex normals */
@@ -91,12 +126,10 @@ ccl_device_inline void triangle_vertices_and_normals(KernelGlobals kg,
                                                      float3 N[3])
 {
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  P[0] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-  P[1] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-  P[2] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
-  N[0] = kernel_tex_fetch(__tri_vnormal, tri_vindex.x);
-  N[1] = kernel_tex_fetch(__tri_vnormal, tri_vindex.y);
-  N[2] = kernel_tex_fetch(__tri_vnormal, tri_vindex.z);
+  triangle_vertices_from_vindex(kg, tri_vindex, P);
+  N[0] = triangle_vertex_normal(kg, tri_vindex.x);
+  N[1] = triangle_vertex_normal(kg, tri_vindex.y);
+  N[2] = triangle_vertex_normal(kg, tri_vindex.z);
 }
 
 /* Interpolate smooth vertex normal from vertices */
@@ -106,9 +139,9 @@ triangle_smooth_normal(KernelGlobals kg, float3 Ng, int prim, float u, float v)
 {
   /* load triangle vertices */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  float3 n0 = kernel_tex_fetch(__tri_vnormal, tri_vindex.x);
-  float3 n1 = kernel_tex_fetch(__tri_vnormal, tri_vindex.y);
-  float3 n2 = kernel_tex_fetch(__tri_vnormal, tri_vindex.z);
+  float3 n0 = triangle_vertex_normal(kg, tri_vindex.x);
+  float3 n1 = triangle_vertex_normal(kg, tri_vindex.y);
+  float3 n2 = triangle_vertex_normal(kg, tri_vindex.z);
 
   float3 N = safe_normalize((1.0f - u - v) * n2 + u * n0 + v * n1);
 
@@ -120,9 +153,9 @@ ccl_device_inline float3 triangle_smooth_normal_unnormalized(
 {
   /* load triangle vertices */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  float3 n0 = kernel_tex_fetch(__tri_vnormal, tri_vindex.x);
-  float3 n1 = kernel_tex_fetch(__tri_vnormal, tri_vindex.y);
-  float3 n2 = kernel_tex_fetch(__tri_vnormal, tri_vindex.z);
+  float3 n0 = triangle_vertex_normal(kg, tri_vindex.x);
+  float3 n1 = triangle_vertex_normal(kg, tri_vindex.y);
+  float3 n2 = triangle_vertex_normal(kg, tri_vindex.z);
 
   /* ensure that the normals are in object space */
   if (sd->object_flag & SD_OBJECT_TRANSFORM_APPLIED) {
@@ -145,13 +178,12 @@ ccl_device_inline void triangle_dPdudv(KernelGlobals kg,
 {
   /* fetch triangle vertex coordinates */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  const float3 p0 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-  const float3 p1 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-  const float3 p2 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+  float3 P[3];
+  triangle_vertices_from_vindex(kg, tri_vindex, P);
 
   /* compute derivatives of P w.r.t. uv */
-  *dPdu = (p0 - p2);
-  *dPdv = (p1 - p2);
+  *dPdu = (P[0] - P[2]);
+  *dPdv = (P[1] - P[2]);
 }
 
 /* Reading attributes on various triangle elements */
@@ -36,10 +36,9 @@ ccl_device_inline bool triangle_intersect(KernelGlobals kg,
                                           int prim_addr)
 {
   const int prim = kernel_tex_fetch(__prim_index, prim_addr);
-  const uint tri_vindex = kernel_tex_fetch(__tri_vindex, prim).w;
-  const float3 tri_a = kernel_tex_fetch(__tri_verts, tri_vindex + 0),
-               tri_b = kernel_tex_fetch(__tri_verts, tri_vindex + 1),
-               tri_c = kernel_tex_fetch(__tri_verts, tri_vindex + 2);
+  float3 verts[3];
+  triangle_vertices_from_vindex(kg, kernel_tex_fetch(__tri_vindex, prim), verts);
+  const float3 tri_a = verts[0], tri_b = verts[1], tri_c = verts[2];
   float t, u, v;
   if (ray_triangle_intersect(P, dir, tmax, tri_a, tri_b, tri_c, &u, &v, &t)) {
 #ifdef __VISIBILITY_FLAG__
@@ -89,10 +88,9 @@ ccl_device_inline bool triangle_intersect_local(KernelGlobals kg,
   }
 
   const int prim = kernel_tex_fetch(__prim_index, prim_addr);
-  const uint tri_vindex = kernel_tex_fetch(__tri_vindex, prim).w;
-  const float3 tri_a = kernel_tex_fetch(__tri_verts, tri_vindex + 0),
-               tri_b = kernel_tex_fetch(__tri_verts, tri_vindex + 1),
-               tri_c = kernel_tex_fetch(__tri_verts, tri_vindex + 2);
+  float3 verts[3];
+  triangle_vertices_from_vindex(kg, kernel_tex_fetch(__tri_vindex, prim), verts);
+  const float3 tri_a = verts[0], tri_b = verts[1], tri_c = verts[2];
   float t, u, v;
   if (!ray_triangle_intersect(P, dir, tmax, tri_a, tri_b, tri_c, &u, &v, &t)) {
     return false;
@@ -185,10 +183,9 @@ ccl_device_inline float3 triangle_refine(KernelGlobals kg,
 
   P = P + D * t;
 
-  const uint tri_vindex = kernel_tex_fetch(__tri_vindex, isect_prim).w;
-  const packed_float3 tri_a = kernel_tex_fetch(__tri_verts, tri_vindex + 0),
-                      tri_b = kernel_tex_fetch(__tri_verts, tri_vindex + 1),
-                      tri_c = kernel_tex_fetch(__tri_verts, tri_vindex + 2);
+  float3 verts[3];
+  triangle_vertices_from_vindex(kg, kernel_tex_fetch(__tri_vindex, isect_prim), verts);
+  const float3 tri_a = verts[0], tri_b = verts[1], tri_c = verts[2];
   float3 edge1 = make_float3(tri_a.x - tri_c.x, tri_a.y - tri_c.y, tri_a.z - tri_c.z);
   float3 edge2 = make_float3(tri_b.x - tri_c.x, tri_b.y - tri_c.y, tri_b.z - tri_c.z);
   float3 tvec = make_float3(P.x - tri_c.x, P.y - tri_c.y, P.z - tri_c.z);
@@ -242,10 +239,9 @@ ccl_device_inline float3 triangle_refine_local(KernelGlobals kg,
   P = P + D * t;
 
 #  ifdef __INTERSECTION_REFINE__
-  const uint tri_vindex = kernel_tex_fetch(__tri_vindex, isect_prim).w;
-  const packed_float3 tri_a = kernel_tex_fetch(__tri_verts, tri_vindex + 0),
-                      tri_b = kernel_tex_fetch(__tri_verts, tri_vindex + 1),
-                      tri_c = kernel_tex_fetch(__tri_verts, tri_vindex + 2);
+  float3 verts[3];
+  triangle_vertices_from_vindex(kg, kernel_tex_fetch(__tri_vindex, isect_prim), verts);
+  const float3 tri_a = verts[0], tri_b = verts[1], tri_c = verts[2];
   float3 edge1 = make_float3(tri_a.x - tri_c.x, tri_a.y - tri_c.y, tri_a.z - tri_c.z);
   float3 edge2 = make_float3(tri_b.x - tri_c.x, tri_b.y - tri_c.y, tri_b.z - tri_c.z);
   float3 tvec = make_float3(P.x - tri_c.x, P.y - tri_c.y, P.z - tri_c.z);
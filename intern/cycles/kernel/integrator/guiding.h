@@ -0,0 +1,260 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "kernel/integrator/state.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Path Guiding
+ *
+ * The incident radiance in the scene is learned during rendering, and used to sample bounce
+ * directions on surfaces in a mixture with the BSDF. The scene bounds are divided into a regular
+ * grid, and every grid cell stores a distribution over equal-area direction bins, mapped by the
+ * cosine of the polar angle and the azimuth.
+ *
+ * While training, every non-singular surface bounce of a path is recorded as a vertex. Light
+ * arriving later on the path, from emission, the background or direct light, is divided by the
+ * throughput after the vertex and the pdf of the sampled direction, which gives an estimate of
+ * the incident radiance integrated over the direction bin. These are accumulated into the
+ * training data, from which the host builds the distribution between render works.
+ *
+ * Direct light at the vertex itself is not recorded, as it is already handled by light sampling.
+ * Only available on the CPU, where the host memory of the distribution is shared with the
+ * kernels. */
+
+#ifdef __PATH_GUIDING__
+
+ccl_device_inline bool guiding_is_enabled(KernelGlobals kg)
+{
+  return (kernel_data.kernel_features & KERNEL_FEATURE_PATH_GUIDING) && kg->guiding != nullptr;
+}
+
+ccl_device_inline bool guiding_use_training(KernelGlobals kg)
+{
+  return guiding_is_enabled(kg) && kg->guiding->use_training;
+}
+
+/* Grid cell containing the position, positions outside of the scene bounds are clamped to the
+ * nearest cell. */
+ccl_device_inline int guiding_cell(KernelGlobals kg, const float3 P)
+{
+  int index[3];
+  for (int i = 0; i < 3; i++) {
+    const float p = (P[i] - kernel_data.integrator.guiding_bounds_min[i]) *
+                    kernel_data.integrator.guiding_inv_cell_size[i];
+    index[i] = clamp(float_to_int(p), 0, GUIDING_GRID_RESOLUTION - 1);
+  }
+  return (index[2] * GUIDING_GRID_RESOLUTION + index[1]) * GUIDING_GRID_RESOLUTION + index[0];
+}
+
+/* Grid cell for sampling and training at a surface, or GUIDING_CELL_NONE if the closures can not
+ * be guided. Singular closures can not be evaluated for a guided direction, and subsurface
+ * scattering is left to the BSSRDF. */
+ccl_device_inline int guiding_surface_cell(KernelGlobals kg, ccl_private const ShaderData *sd)
+{
+  if (!guiding_is_enabled(kg) || !(sd->flag & SD_BSDF_HAS_EVAL) || (sd->flag & SD_BSSRDF)) {
+    return GUIDING_CELL_NONE;
+  }
+
+  for (int i = 0; i < sd->num_closure; i++) {
+    if (CLOSURE_IS_BSDF_SINGULAR(sd->closure[i].type)) {
+      return GUIDING_CELL_NONE;
+    }
+  }
+
+  return guiding_cell(kg, sd->P);
+}
+
+/* Direction Bins */
+
+ccl_device_inline int guiding_direction_bin(const float3 D)
+{
+  const float u = (D.z + 1.0f) * 0.5f;
+  const float v = (atan2f(D.y, D.x) + M_PI_F) * M_1_2PI_F;
+  const int x = clamp(float_to_int(u * GUIDING_DIRECTION_RESOLUTION),
+                      0,
+                      GUIDING_DIRECTION_RESOLUTION - 1);
+  const int y = clamp(float_to_int(v * GUIDING_DIRECTION_RESOLUTION),
+                      0,
+                      GUIDING_DIRECTION_RESOLUTION - 1);
+  return x * GUIDING_DIRECTION_RESOLUTION + y;
+}
+
+ccl_device_inline ccl_global const float *guiding_cell_distribution(KernelGlobals kg,
+                                                                    const int cell)
+{
+  return kg->guiding->distribution + (size_t)cell * GUIDING_NUM_BINS;
+}
+
+ccl_device_inline bool guiding_cell_is_trained(ccl_global const float *cdf)
+{
+  return cdf[GUIDING_NUM_BINS - 1] != 0.0f;
+}
+
+ccl_device_inline float guiding_direction_pdf(ccl_global const float *cdf, const float3 D)
+{
+  const int bin = guiding_direction_bin(D);
+  const float probability = cdf[bin] - ((bin > 0) ? cdf[bin - 1] : 0.0f);
+  /* Every bin covers the same solid angle. */
+  return probability * (GUIDING_NUM_BINS / M_4PI_F);
+}
+
+ccl_device_inline float3 guiding_direction_sample(ccl_global const float *cdf,
+                                                  const float randu,
+                                                  const float randv,
+                                                  ccl_private float *pdf)
+{
+  /* Find the bin, skipping bins with zero probability. */
+  int first = 0;
+  int len = GUIDING_NUM_BINS;
+  while (len > 0) {
+    const int half_len = len >> 1;
+    const int middle = first + half_len;
+    if (randu >= cdf[middle]) {
+      first = middle + 1;
+      len -= half_len + 1;
+    }
+    else {
+      len = half_len;
+    }
+  }
+  const int bin = min(first, GUIDING_NUM_BINS - 1);
+
+  const float cdf_begin = (bin > 0) ? cdf[bin - 1] : 0.0f;
+  const float probability = cdf[bin] - cdf_begin;
+  const float du = clamp((randu - cdf_begin) / probability, 0.0f, 1.0f);
+
+  const int x = bin / GUIDING_DIRECTION_RESOLUTION;
+  const int y = bin % GUIDING_DIRECTION_RESOLUTION;
+  const float z = ((x + du) * (2.0f / GUIDING_DIRECTION_RESOLUTION)) - 1.0f;
+  const float phi = ((y + randv) * (M_2PI_F / GUIDING_DIRECTION_RESOLUTION)) - M_PI_F;
+  const float r = safe_sqrtf(1.0f - z * z);
+
+  *pdf = probability * (GUIDING_NUM_BINS / M_4PI_F);
+  return make_float3(r * cosf(phi), r * sinf(phi), z);
+}
+
+/* Training */
+
+/* Record the surface bounce which was just sampled, with the path throughput after the bounce
+ * and the pdf of the sampled direction. */
+ccl_device_inline void guiding_record_surface_vertex(KernelGlobals kg,
+                                                     IntegratorState state,
+                                                     const int cell,
+                                                     const float3 D,
+                                                     const float3 throughput,
+                                                     const float pdf)
+{
+  if (!guiding_use_training(kg)) {
+    return;
+  }
+
+  const float weight = 1.0f / (average(throughput) * pdf);
+  if (!isfinite_safe(weight) || weight <= 0.0f) {
+    return;
+  }
+
+  const uint16_t num_vertices = INTEGRATOR_STATE(state, path, guiding_num_vertices);
+  const int index = num_vertices % GUIDING_MAX_VERTICES;
+  INTEGRATOR_STATE_ARRAY_WRITE(state, guiding_vertex, index, cell) = cell;
+  INTEGRATOR_STATE_ARRAY_WRITE(state, guiding_vertex, index, bin) = guiding_direction_bin(D);
+  INTEGRATOR_STATE_ARRAY_WRITE(state, guiding_vertex, index, weight) = weight;
+  INTEGRATOR_STATE_WRITE(state, path, guiding_num_vertices) = num_vertices + 1;
+}
+
+ccl_device_inline void guiding_accum(KernelGlobals kg,
+                                     const int cell,
+                                     const int bin,
+                                     const float value)
+{
+  atomic_add_and_fetch_float(kg->guiding->training + (size_t)cell * GUIDING_NUM_BINS + bin,
+                             value);
+}
+
+/* Add light arriving at the end of the main path to the recorded vertices. */
+ccl_device_inline void guiding_record_contribution(KernelGlobals kg,
+                                                   ConstIntegratorState state,
+                                                   const float3 contribution)
+{
+  if (!guiding_use_training(kg)) {
+    return;
+  }
+
+  const float value = average(contribution);
+  if (!(value > 0.0f) || !isfinite_safe(value)) {
+    return;
+  }
+
+  const int num_vertices = min((int)INTEGRATOR_STATE(state, path, guiding_num_vertices),
+                               GUIDING_MAX_VERTICES);
+  for (int i = 0; i < num_vertices; i++) {
+    guiding_accum(kg,
+                  INTEGRATOR_STATE_ARRAY(state, guiding_vertex, i, cell),
+                  INTEGRATOR_STATE_ARRAY(state, guiding_vertex, i, bin),
+                  value * INTEGRATOR_STATE_ARRAY(state, guiding_vertex, i, weight));
+  }
+}
+
+/* Add light arriving through an unoccluded shadow path to the vertices of its main path. */
+ccl_device_inline void guiding_record_shadow_contribution(KernelGlobals kg,
+                                                          ConstIntegratorShadowState state,
+                                                          const float3 contribution)
+{
+  if (!guiding_use_training(kg)) {
+    return;
+  }
+
+  const float value = average(contribution);
+  if (!(value > 0.0f) || !isfinite_safe(value)) {
+    return;
+  }
+
+  const int num_vertices = min((int)INTEGRATOR_STATE(state, shadow_path, guiding_num_vertices),
+                               GUIDING_MAX_VERTICES);
+  for (int i = 0; i < num_vertices; i++) {
+    guiding_accum(kg,
+                  INTEGRATOR_STATE_ARRAY(state, shadow_guiding_vertex, i, cell),
+                  INTEGRATOR_STATE_ARRAY(state, shadow_guiding_vertex, i, bin),
+                  value * INTEGRATOR_STATE_ARRAY(state, shadow_guiding_vertex, i, weight));
+  }
+}
+
+ccl_device_inline void guiding_copy_vertices_to_shadow(KernelGlobals kg,
+                                                       IntegratorShadowState shadow_state,
+                                                       ConstIntegratorState state)
+{
+  if (!guiding_use_training(kg)) {
+    return;
+  }
+
+  const uint16_t num_vertices = INTEGRATOR_STATE(state, path, guiding_num_vertices);
+  const int num_copy = min((int)num_vertices, GUIDING_MAX_VERTICES);
+  for (int i = 0; i < num_copy; i++) {
+    INTEGRATOR_STATE_ARRAY_WRITE(shadow_state, shadow_guiding_vertex, i, cell) =
+        INTEGRATOR_STATE_ARRAY(state, guiding_vertex, i, cell);
+    INTEGRATOR_STATE_ARRAY_WRITE(shadow_state, shadow_guiding_vertex, i, bin) =
+        INTEGRATOR_STATE_ARRAY(state, guiding_vertex, i, bin);
+    INTEGRATOR_STATE_ARRAY_WRITE(shadow_state, shadow_guiding_vertex, i, weight) =
+        INTEGRATOR_STATE_ARRAY(state, guiding_vertex, i, weight);
+  }
+  INTEGRATOR_STATE_WRITE(shadow_state, shadow_path, guiding_num_vertices) = num_vertices;
+}
+
+#endif /* __PATH_GUIDING__ */
+
+CCL_NAMESPACE_END
@@ -66,6 +66,7 @@ ccl_device_inline void path_state_init_integrator(KernelGlobals kg,
                                               PATH_RAY_TRANSPARENT_BACKGROUND;
   INTEGRATOR_STATE_WRITE(state, path, mis_ray_pdf) = 0.0f;
   INTEGRATOR_STATE_WRITE(state, path, mis_ray_t) = 0.0f;
+  INTEGRATOR_STATE_WRITE(state, path, mis_origin_n) = zero_float3();
   INTEGRATOR_STATE_WRITE(state, path, min_ray_pdf) = FLT_MAX;
   INTEGRATOR_STATE_WRITE(state, path, continuation_probability) = 1.0f;
   INTEGRATOR_STATE_WRITE(state, path, throughput) = make_float3(1.0f, 1.0f, 1.0f);
@@ -84,6 +85,12 @@ ccl_device_inline void path_state_init_integrator(KernelGlobals kg,
     INTEGRATOR_STATE_WRITE(state, path, denoising_feature_throughput) = one_float3();
   }
 #endif
+
+#ifdef __PATH_GUIDING__
+  if (kernel_data.kernel_features & KERNEL_FEATURE_PATH_GUIDING) {
+    INTEGRATOR_STATE_WRITE(state, path, guiding_num_vertices) = 0;
+  }
+#endif
 }
 
 ccl_device_inline void path_state_next(KernelGlobals kg, IntegratorState state, int label)
@@ -79,7 +79,10 @@ ccl_device float3 integrator_eval_background_shader(KernelGlobals kg,
 
     /* multiple importance sampling, get background light pdf for ray
      * direction, and compute weight with respect to BSDF pdf */
-    const float pdf = background_light_pdf(kg, ray_P - ray_D * mis_ray_t, ray_D);
+    float pdf = background_light_pdf(kg, ray_P - ray_D * mis_ray_t, ray_D);
+    if (kernel_data.integrator.use_light_tree) {
+      pdf *= light_tree_infinite_pdf_correction(kg);
+    }
     const float mis_weight = light_sample_mis_weight_forward(kg, mis_ray_pdf, pdf);
     L *= mis_weight;
   }
@@ -166,6 +169,9 @@ ccl_device_inline void integrate_distant_lights(KernelGlobals kg,
       if (!(path_flag & PATH_RAY_MIS_SKIP)) {
         /* multiple importance sampling, get regular light pdf,
          * and compute weight with respect to BSDF pdf */
+        if (kernel_data.integrator.use_light_tree) {
+          ls.pdf *= light_tree_infinite_pdf_correction(kg);
+        }
         const float mis_ray_pdf = INTEGRATOR_STATE(state, path, mis_ray_pdf);
         const float mis_weight = light_sample_mis_weight_forward(kg, mis_ray_pdf, ls.pdf);
         light_eval *= mis_weight;
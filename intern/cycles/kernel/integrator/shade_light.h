@@ -55,6 +55,11 @@ ccl_device_inline void integrate_light(KernelGlobals kg,
     return;
   }
 
+  if (kernel_data.integrator.use_light_tree) {
+    const float3 N = INTEGRATOR_STATE(state, path, mis_origin_n);
+    ls.pdf *= light_tree_lamp_pdf_correction(kg, ray_P, N, ls.lamp);
+  }
+
   /* Use visibility flag to skip lights. */
 #ifdef __PASSES__
   const uint32_t path_flag = INTEGRATOR_STATE(state, path, flag);
@@ -93,6 +93,11 @@ ccl_device_forceinline void integrate_surface_emission(KernelGlobals kg,
     /* Multiple importance sampling, get triangle light pdf,
      * and compute weight with respect to BSDF pdf. */
     float pdf = triangle_light_pdf(kg, sd, t);
+    if (kernel_data.integrator.use_light_tree) {
+      const float3 ray_P = sd->P + sd->I * t;
+      const float3 N = INTEGRATOR_STATE(state, path, mis_origin_n);
+      pdf *= light_tree_triangle_pdf_correction(kg, ray_P, N, sd->object, sd->prim);
+    }
     float mis_weight = light_sample_mis_weight_forward(kg, bsdf_pdf, pdf);
     L *= mis_weight;
   }
@@ -102,6 +107,78 @@ ccl_device_forceinline void integrate_surface_emission(KernelGlobals kg,
 }
 #endif /* __EMISSION__ */
 
+#ifdef __PATH_GUIDING__
+/* Path guiding: the pdf of sampling a direction from the mixture of the guiding distribution and
+ * the BSDF, given the pdf of the BSDF. Cells without training data only sample the BSDF. */
+ccl_device_forceinline float integrate_surface_guiding_mixture_pdf(KernelGlobals kg,
+                                                                   const int cell,
+                                                                   const float3 D,
+                                                                   const float bsdf_pdf)
+{
+  ccl_global const float *cdf = guiding_cell_distribution(kg, cell);
+  if (!guiding_cell_is_trained(cdf)) {
+    return bsdf_pdf;
+  }
+
+  const float guiding_probability = kernel_data.integrator.guiding_probability;
+  return guiding_probability * guiding_direction_pdf(cdf, D) +
+         (1.0f - guiding_probability) * bsdf_pdf;
+}
+
+/* Path guiding: sample a bounce direction from either the guiding distribution or the BSDF, and
+ * return the pdf of the mixture of both. */
+ccl_device_forceinline int integrate_surface_guiding_sample(
+    KernelGlobals kg,
+    ccl_private ShaderData *sd,
+    ccl_private const ShaderClosure *sc,
+    const int cell,
+    float randu,
+    const float randv,
+    ccl_private BsdfEval *bsdf_eval,
+    ccl_private float3 *omega_in,
+    ccl_private differential3 *domega_in,
+    ccl_private float *pdf)
+{
+  ccl_global const float *cdf = guiding_cell_distribution(kg, cell);
+  if (!guiding_cell_is_trained(cdf)) {
+    return shader_bsdf_sample_closure(
+        kg, sd, sc, randu, randv, bsdf_eval, omega_in, domega_in, pdf);
+  }
+
+  const float guiding_probability = kernel_data.integrator.guiding_probability;
+
+  if (randu < guiding_probability) {
+    /* Sample guiding distribution and evaluate all BSDFs for the direction. */
+    float guiding_pdf;
+    *omega_in = guiding_direction_sample(cdf, randu / guiding_probability, randv, &guiding_pdf);
+    *domega_in = differential3_zero();
+
+    const bool is_transmission = shader_bsdf_is_transmission(sd, *omega_in);
+    const float bsdf_pdf = shader_bsdf_eval(kg, sd, *omega_in, is_transmission, bsdf_eval, 0);
+    *pdf = guiding_probability * guiding_pdf + (1.0f - guiding_probability) * bsdf_pdf;
+
+    return ((is_transmission) ? LABEL_TRANSMIT : LABEL_REFLECT) |
+           ((CLOSURE_IS_BSDF_DIFFUSE(sc->type)) ? LABEL_DIFFUSE : LABEL_GLOSSY);
+  }
+
+  /* Sample BSDF, rescaling the random number to reuse it. */
+  randu = (randu - guiding_probability) / (1.0f - guiding_probability);
+  const int label = shader_bsdf_sample_closure(
+      kg, sd, sc, randu, randv, bsdf_eval, omega_in, domega_in, pdf);
+
+  if (label & LABEL_SINGULAR) {
+    /* Directions of near-singular microfacet closures are never sampled by guiding. */
+    *pdf *= 1.0f - guiding_probability;
+  }
+  else {
+    *pdf = guiding_probability * guiding_direction_pdf(cdf, *omega_in) +
+           (1.0f - guiding_probability) * *pdf;
+  }
+
+  return label;
+}
+#endif
+
 #ifdef __EMISSION__
 /* Path tracing: sample point on light and evaluate light shader, then
  * queue shadow ray to be traced. */
@@ -124,7 +201,7 @@ ccl_device_forceinline void integrate_surface_direct_light(KernelGlobals kg,
     path_state_rng_2D(kg, rng_state, PRNG_LIGHT_U, &light_u, &light_v);
 
     if (!light_distribution_sample_from_position(
-            kg, light_u, light_v, sd->time, sd->P, bounce, path_flag, &ls)) {
+            kg, light_u, light_v, sd->time, sd->P, sd->N, bounce, path_flag, &ls)) {
       return;
     }
   }
@@ -148,9 +225,17 @@ ccl_device_forceinline void integrate_surface_direct_light(KernelGlobals kg,
   const bool is_transmission = shader_bsdf_is_transmission(sd, ls.D);
 
   BsdfEval bsdf_eval ccl_optional_struct_init;
-  const float bsdf_pdf = shader_bsdf_eval(kg, sd, ls.D, is_transmission, &bsdf_eval, ls.shader);
+  float bsdf_pdf = shader_bsdf_eval(kg, sd, ls.D, is_transmission, &bsdf_eval, ls.shader);
   bsdf_eval_mul3(&bsdf_eval, light_eval / ls.pdf);
 
+#  ifdef __PATH_GUIDING__
+  /* Bounce directions are also sampled from the guiding distribution. */
+  const int guiding_cell = guiding_surface_cell(kg, sd);
+  if (guiding_cell != GUIDING_CELL_NONE) {
+    bsdf_pdf = integrate_surface_guiding_mixture_pdf(kg, guiding_cell, ls.D, bsdf_pdf);
+  }
+#  endif
+
   if (ls.shader & SHADER_USE_MIS) {
     const float mis_weight = light_sample_mis_weight_nee(kg, ls.pdf, bsdf_pdf);
     bsdf_eval_mul(&bsdf_eval, mis_weight);
@@ -180,6 +265,10 @@ ccl_device_forceinline void integrate_surface_direct_light(KernelGlobals kg,
 #  endif
   }
 
+#  ifdef __PATH_GUIDING__
+  guiding_copy_vertices_to_shadow(kg, shadow_state, state);
+#  endif
+
   /* Write shadow ray and associated state to global memory. */
   integrator_state_write_shadow_ray(kg, shadow_state, &ray);
 
@@ -258,8 +347,26 @@ ccl_device_forceinline int integrate_surface_bsdf_bssrdf_bounce(
   differential3 bsdf_domega_in ccl_optional_struct_init;
   int label;
 
-  label = shader_bsdf_sample_closure(
-      kg, sd, sc, bsdf_u, bsdf_v, &bsdf_eval, &bsdf_omega_in, &bsdf_domega_in, &bsdf_pdf);
+#ifdef __PATH_GUIDING__
+  const int guiding_cell = guiding_surface_cell(kg, sd);
+  if (guiding_cell != GUIDING_CELL_NONE) {
+    label = integrate_surface_guiding_sample(kg,
+                                             sd,
+                                             sc,
+                                             guiding_cell,
+                                             bsdf_u,
+                                             bsdf_v,
+                                             &bsdf_eval,
+                                             &bsdf_omega_in,
+                                             &bsdf_domega_in,
+                                             &bsdf_pdf);
+  }
+  else
+#endif
+  {
+    label = shader_bsdf_sample_closure(
+        kg, sd, sc, bsdf_u, bsdf_v, &bsdf_eval, &bsdf_omega_in, &bsdf_domega_in, &bsdf_pdf);
+  }
 
   if (bsdf_pdf == 0.0f || bsdf_eval_is_zero(&bsdf_eval)) {
     return LABEL_NONE;
@@ -283,6 +390,12 @@ ccl_device_forceinline int integrate_surface_bsdf_bssrdf_bounce(
   throughput *= bsdf_eval_sum(&bsdf_eval) / bsdf_pdf;
   INTEGRATOR_STATE_WRITE(state, path, throughput) = throughput;
 
+#ifdef __PATH_GUIDING__
+  if (guiding_cell != GUIDING_CELL_NONE && !(label & LABEL_SINGULAR)) {
+    guiding_record_surface_vertex(kg, state, guiding_cell, bsdf_omega_in, throughput, bsdf_pdf);
+  }
+#endif
+
   if (kernel_data.kernel_features & KERNEL_FEATURE_LIGHT_PASSES) {
     if (INTEGRATOR_STATE(state, path, bounce) == 0) {
       INTEGRATOR_STATE_WRITE(state, path, pass_diffuse_weight) = bsdf_eval_pass_diffuse_weight(
@@ -299,6 +412,7 @@ ccl_device_forceinline int integrate_surface_bsdf_bssrdf_bounce(
   else {
     INTEGRATOR_STATE_WRITE(state, path, mis_ray_pdf) = bsdf_pdf;
     INTEGRATOR_STATE_WRITE(state, path, mis_ray_t) = 0.0f;
+    INTEGRATOR_STATE_WRITE(state, path, mis_origin_n) = sd->N;
     INTEGRATOR_STATE_WRITE(state, path, min_ray_pdf) = fminf(
         bsdf_pdf, INTEGRATOR_STATE(state, path, min_ray_pdf));
   }
@@ -741,7 +741,7 @@ ccl_device_forceinline void integrate_volume_direct_light(
     path_state_rng_2D(kg, rng_state, PRNG_LIGHT_U, &light_u, &light_v);
 
     if (!light_distribution_sample_from_position(
-            kg, light_u, light_v, sd->time, P, bounce, path_flag, ls)) {
+            kg, light_u, light_v, sd->time, P, zero_float3(), bounce, path_flag, ls)) {
       return;
     }
   }
@@ -792,6 +792,10 @@ ccl_device_forceinline void integrate_volume_direct_light(
   /* Write shadow ray and associated state to global memory. */
   integrator_state_write_shadow_ray(kg, shadow_state, &ray);
 
+#    ifdef __PATH_GUIDING__
+  guiding_copy_vertices_to_shadow(kg, shadow_state, state);
+#    endif
+
   /* Copy state from main path to shadow path. */
   const uint16_t bounce = INTEGRATOR_STATE(state, path, bounce);
   const uint16_t transparent_bounce = INTEGRATOR_STATE(state, path, transparent_bounce);
@@ -892,6 +896,7 @@ ccl_device_forceinline bool integrate_volume_phase_scatter(
   /* Update path state */
   INTEGRATOR_STATE_WRITE(state, path, mis_ray_pdf) = phase_pdf;
   INTEGRATOR_STATE_WRITE(state, path, mis_ray_t) = 0.0f;
+  INTEGRATOR_STATE_WRITE(state, path, mis_origin_n) = zero_float3();
   INTEGRATOR_STATE_WRITE(state, path, min_ray_pdf) = fminf(
       phase_pdf, INTEGRATOR_STATE(state, path, min_ray_pdf));
 
@@ -51,6 +51,8 @@ KERNEL_STRUCT_MEMBER(shadow_path, packed_float3, pass_diffuse_weight, KERNEL_FEA
 KERNEL_STRUCT_MEMBER(shadow_path, packed_float3, pass_glossy_weight, KERNEL_FEATURE_LIGHT_PASSES)
 /* Number of intersections found by ray-tracing. */
 KERNEL_STRUCT_MEMBER(shadow_path, uint16_t, num_hits, KERNEL_FEATURE_PATH_TRACING)
+/* Path guiding vertices of the main path, copied to receive the light contribution. */
+KERNEL_STRUCT_MEMBER(shadow_path, uint16_t, guiding_num_vertices, KERNEL_FEATURE_PATH_GUIDING)
 KERNEL_STRUCT_END(shadow_path)
 
 /********************************** Shadow Ray *******************************/
@@ -85,3 +87,11 @@ KERNEL_STRUCT_ARRAY_MEMBER(shadow_volume_stack, int, shader, KERNEL_FEATURE_VOLU
 KERNEL_STRUCT_END_ARRAY(shadow_volume_stack,
                         KERNEL_STRUCT_VOLUME_STACK_SIZE,
                         KERNEL_STRUCT_VOLUME_STACK_SIZE)
+
+/************************* Shadow Path Guiding Vertices ***********************/
+
+KERNEL_STRUCT_BEGIN(shadow_guiding_vertex)
+KERNEL_STRUCT_ARRAY_MEMBER(shadow_guiding_vertex, int, cell, KERNEL_FEATURE_PATH_GUIDING)
+KERNEL_STRUCT_ARRAY_MEMBER(shadow_guiding_vertex, int, bin, KERNEL_FEATURE_PATH_GUIDING)
+KERNEL_STRUCT_ARRAY_MEMBER(shadow_guiding_vertex, float, weight, KERNEL_FEATURE_PATH_GUIDING)
+KERNEL_STRUCT_END_ARRAY(shadow_guiding_vertex, GUIDING_MAX_VERTICES, GUIDING_MAX_VERTICES)
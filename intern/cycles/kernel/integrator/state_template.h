@@ -54,6 +54,8 @@ KERNEL_STRUCT_MEMBER(path, uint32_t, flag, KERNEL_FEATURE_PATH_TRACING)
  * compute the complete distance through transparent surfaces and volumes. */
 KERNEL_STRUCT_MEMBER(path, float, mis_ray_pdf, KERNEL_FEATURE_PATH_TRACING)
 KERNEL_STRUCT_MEMBER(path, float, mis_ray_t, KERNEL_FEATURE_PATH_TRACING)
+/* Normal at the last scatter point, zero for volumes. Used to evaluate the light tree PDF. */
+KERNEL_STRUCT_MEMBER(path, packed_float3, mis_origin_n, KERNEL_FEATURE_PATH_TRACING)
 /* Filter glossy. */
 KERNEL_STRUCT_MEMBER(path, float, min_ray_pdf, KERNEL_FEATURE_PATH_TRACING)
 /* Continuation probability for path termination. */
@@ -68,6 +70,9 @@ KERNEL_STRUCT_MEMBER(path, packed_float3, denoising_feature_throughput, KERNEL_F
 /* Shader sorting. */
 /* TODO: compress as uint16? or leave out entirely and recompute key in sorting code? */
 KERNEL_STRUCT_MEMBER(path, uint32_t, shader_sort_key, KERNEL_FEATURE_PATH_TRACING)
+/* Number of vertices recorded for path guiding training, the latest of which are stored in the
+ * guiding vertex array. */
+KERNEL_STRUCT_MEMBER(path, uint16_t, guiding_num_vertices, KERNEL_FEATURE_PATH_GUIDING)
 KERNEL_STRUCT_END(path)
 
 /************************************** Ray ***********************************/
@@ -110,3 +115,13 @@ KERNEL_STRUCT_ARRAY_MEMBER(volume_stack, int, shader, KERNEL_FEATURE_VOLUME)
 KERNEL_STRUCT_END_ARRAY(volume_stack,
                         KERNEL_STRUCT_VOLUME_STACK_SIZE,
                         KERNEL_STRUCT_VOLUME_STACK_SIZE)
+
+/******************************* Path Guiding Vertices ***********************/
+
+/* Grid cell and direction bin of the vertex, and weight converting path contributions into
+ * incident radiance samples for it. */
+KERNEL_STRUCT_BEGIN(guiding_vertex)
+KERNEL_STRUCT_ARRAY_MEMBER(guiding_vertex, int, cell, KERNEL_FEATURE_PATH_GUIDING)
+KERNEL_STRUCT_ARRAY_MEMBER(guiding_vertex, int, bin, KERNEL_FEATURE_PATH_GUIDING)
+KERNEL_STRUCT_ARRAY_MEMBER(guiding_vertex, float, weight, KERNEL_FEATURE_PATH_GUIDING)
+KERNEL_STRUCT_END_ARRAY(guiding_vertex, GUIDING_MAX_VERTICES, GUIDING_MAX_VERTICES)
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "kernel/integrator/megakernel.h"
+
+#include <algorithm>
+
+CCL_NAMESPACE_BEGIN
+
+/* Wavefront Path Tracing on the CPU
+ *
+ * Instead of tracing one path at a time until it terminates like the megakernel, a batch of
+ * paths is advanced together. Every step executes the kernel that most paths in the batch are
+ * queued for, over all of those paths, similar to how the GPU schedules kernels over its path
+ * state pool. Paths executing the same kernel back to back share instruction and BVH cache, and
+ * surface shading is sorted by shader so SVM evaluates the same nodes for consecutive paths.
+ *
+ * Each path has a single shadow and AO state on the CPU, so the main path of a state only
+ * continues once its shadow paths are done. */
+
+ccl_device_inline bool integrator_wavefront_is_shadow_kernel(const uint32_t kernel)
+{
+  return kernel == DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW ||
+         kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW;
+}
+
+ccl_device_inline bool integrator_wavefront_is_sorted_kernel(const uint32_t kernel)
+{
+  return kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE ||
+         kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE;
+}
+
+/* Kernel the main path of the state is queued for, or zero if it has to wait for its shadow
+ * paths first. */
+ccl_device_inline uint32_t integrator_wavefront_queued_kernel(ConstIntegratorState state)
+{
+  if (INTEGRATOR_STATE(&state->shadow, shadow_path, queued_kernel) ||
+      INTEGRATOR_STATE(&state->ao, shadow_path, queued_kernel)) {
+    return 0;
+  }
+  return INTEGRATOR_STATE(state, path, queued_kernel);
+}
+
+ccl_device void integrator_wavefront_shadow_kernel(KernelGlobals kg,
+                                                   IntegratorShadowState state,
+                                                   const uint32_t kernel,
+                                                   ccl_global float *ccl_restrict render_buffer)
+{
+  if (kernel == DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW) {
+    integrator_intersect_shadow(kg, state);
+  }
+  else {
+    integrator_shade_shadow(kg, state, render_buffer);
+  }
+}
+
+ccl_device void integrator_wavefront_main_kernel(KernelGlobals kg,
+                                                 IntegratorState state,
+                                                 const uint32_t kernel,
+                                                 ccl_global float *ccl_restrict render_buffer)
+{
+  switch (kernel) {
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
+      integrator_intersect_closest(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
+      integrator_shade_background(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
+      integrator_shade_surface(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
+      integrator_shade_volume(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
+      integrator_shade_surface_raytrace(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT:
+      integrator_shade_light(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE:
+      integrator_intersect_subsurface(kg, state);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK:
+      integrator_intersect_volume_stack(kg, state);
+      break;
+    default:
+      kernel_assert(0);
+      break;
+  }
+}
+
+/* Trace all paths queued in the given states until they terminate. */
+ccl_device void integrator_wavefront(KernelGlobals kg,
+                                     IntegratorStateCPU *states,
+                                     const int num_states,
+                                     ccl_global float *ccl_restrict render_buffer)
+{
+  kernel_assert(num_states <= INTEGRATOR_WAVEFRONT_SIZE_CPU);
+
+  int indices[INTEGRATOR_WAVEFRONT_SIZE_CPU];
+
+  while (true) {
+    /* Count the paths queued for every kernel, shadow and AO paths share the same kernels. */
+    int num_queued[DEVICE_KERNEL_INTEGRATOR_NUM] = {0};
+
+    for (int i = 0; i < num_states; i++) {
+      IntegratorStateCPU *state = &states[i];
+      num_queued[INTEGRATOR_STATE(&state->shadow, shadow_path, queued_kernel)]++;
+      num_queued[INTEGRATOR_STATE(&state->ao, shadow_path, queued_kernel)]++;
+      num_queued[integrator_wavefront_queued_kernel(state)]++;
+    }
+
+    /* Index zero counts idle paths. */
+    uint32_t kernel = 0;
+    int max_num_queued = 0;
+    for (uint32_t i = 1; i < DEVICE_KERNEL_INTEGRATOR_NUM; i++) {
+      if (num_queued[i] > max_num_queued) {
+        kernel = i;
+        max_num_queued = num_queued[i];
+      }
+    }
+
+    if (kernel == 0) {
+      break;
+    }
+
+    if (integrator_wavefront_is_shadow_kernel(kernel)) {
+      for (int i = 0; i < num_states; i++) {
+        IntegratorStateCPU *state = &states[i];
+        if (INTEGRATOR_STATE(&state->shadow, shadow_path, queued_kernel) == kernel) {
+          integrator_wavefront_shadow_kernel(kg, &state->shadow, kernel, render_buffer);
+        }
+        if (INTEGRATOR_STATE(&state->ao, shadow_path, queued_kernel) == kernel) {
+          integrator_wavefront_shadow_kernel(kg, &state->ao, kernel, render_buffer);
+        }
+      }
+      continue;
+    }
+
+    int num_indices = 0;
+    for (int i = 0; i < num_states; i++) {
+      if (integrator_wavefront_queued_kernel(&states[i]) == kernel) {
+        indices[num_indices++] = i;
+      }
+    }
+
+    if (integrator_wavefront_is_sorted_kernel(kernel)) {
+      std::stable_sort(indices, indices + num_indices, [&](const int a, const int b) {
+        return INTEGRATOR_STATE(&states[a], path, shader_sort_key) <
+               INTEGRATOR_STATE(&states[b], path, shader_sort_key);
+      });
+    }
+
+    for (int i = 0; i < num_indices; i++) {
+      integrator_wavefront_main_kernel(kg, &states[indices[i]], kernel, render_buffer);
+    }
+  }
+}
+
+CCL_NAMESPACE_END
@@ -18,6 +18,7 @@
 
 #include "kernel/geom/geom.h"
 #include "kernel/light/background.h"
+#include "kernel/light/tree.h"
 #include "kernel/sample/mapping.h"
 
 CCL_NAMESPACE_BEGIN
@@ -781,12 +782,31 @@ ccl_device_noinline bool light_distribution_sample(KernelGlobals kg,
                                                    const float randv,
                                                    const float time,
                                                    const float3 P,
+                                                   const float3 N,
                                                    const int bounce,
                                                    const uint32_t path_flag,
                                                    ccl_private LightSample *ls)
 {
-  /* Sample light index from distribution. */
-  const int index = light_distribution_sample(kg, &randu);
+  /* Sample light index from distribution or light tree. */
+  int index;
+  float pdf_correction = 1.0f;
+
+  if (kernel_data.integrator.use_light_tree) {
+    float pdf_selection;
+    const int emitter_index = light_tree_sample(kg, P, N, &randu, &pdf_selection);
+    if (emitter_index < 0) {
+      return false;
+    }
+
+    ccl_global const KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                          emitter_index);
+    index = kemitter->distribution_index;
+    pdf_correction = pdf_selection / kemitter->flat_pdf;
+  }
+  else {
+    index = light_distribution_sample(kg, &randu);
+  }
+
   ccl_global const KernelLightDistribution *kdistribution = &kernel_tex_fetch(__light_distribution,
                                                                               index);
   const int prim = kdistribution->prim;
@@ -804,6 +824,7 @@ ccl_device_noinline bool light_distribution_sample(KernelGlobals kg,
     const int shader_flag = kdistribution->mesh_light.shader_flag;
     triangle_light_sample<in_volume_segment>(kg, prim, object, randu, randv, time, ls, P);
     ls->shader |= shader_flag;
+    ls->pdf *= pdf_correction;
     return (ls->pdf > 0.0f);
   }
 
@@ -813,7 +834,11 @@ ccl_device_noinline bool light_distribution_sample(KernelGlobals kg,
     return false;
   }
 
-  return light_sample<in_volume_segment>(kg, lamp, randu, randv, P, path_flag, ls);
+  if (!light_sample<in_volume_segment>(kg, lamp, randu, randv, P, path_flag, ls)) {
+    return false;
+  }
+  ls->pdf *= pdf_correction;
+  return true;
 }
 
 ccl_device_inline bool light_distribution_sample_from_volume_segment(KernelGlobals kg,
@@ -825,7 +850,8 @@ ccl_device_inline bool light_distribution_sample_from_volume_segment(KernelGloba
                                                                      const uint32_t path_flag,
                                                                      ccl_private LightSample *ls)
 {
-  return light_distribution_sample<true>(kg, randu, randv, time, P, bounce, path_flag, ls);
+  return light_distribution_sample<true>(
+      kg, randu, randv, time, P, zero_float3(), bounce, path_flag, ls);
 }
 
 ccl_device_inline bool light_distribution_sample_from_position(KernelGlobals kg,
@@ -833,11 +859,12 @@ ccl_device_inline bool light_distribution_sample_from_position(KernelGlobals kg,
                                                                const float randv,
                                                                const float time,
                                                                const float3 P,
+                                                               const float3 N,
                                                                const int bounce,
                                                                const uint32_t path_flag,
                                                                ccl_private LightSample *ls)
 {
-  return light_distribution_sample<false>(kg, randu, randv, time, P, bounce, path_flag, ls);
+  return light_distribution_sample<false>(kg, randu, randv, time, P, N, bounce, path_flag, ls);
 }
 
 ccl_device_inline bool light_distribution_sample_new_position(KernelGlobals kg,
@@ -0,0 +1,323 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Light Tree
+ *
+ * Hierarchical light sampling, based on "Importance Sampling of Many Lights with Adaptive Tree
+ * Splitting" by Alejandro Conty Estevez and Christopher Kulla.
+ *
+ * The tree is traversed from the root, choosing a child with probability proportional to the
+ * estimated contribution of its emitters to the shading point. Distant and background lights
+ * have no position, they are chosen with a fixed probability outside of the tree.
+ *
+ * Emitters reference their entry in the flat light distribution, which is still used to sample
+ * a position on the chosen light. The functions computing the light PDF assume the flat
+ * distribution, so the PDF is converted with the ratio of both selection probabilities. */
+
+#pragma once
+
+CCL_NAMESPACE_BEGIN
+
+/* Estimate the contribution of a group of emitters to a shading point, given their spatial and
+ * orientation bounds. N may be zero when there is no receiving surface, as in volumes. */
+ccl_device float light_tree_importance(const float3 P,
+                                       const float3 N,
+                                       const float3 bbox_min,
+                                       const float3 bbox_max,
+                                       const float3 axis,
+                                       const float theta_o,
+                                       const float theta_e,
+                                       const float energy)
+{
+  if (energy == 0.0f) {
+    return 0.0f;
+  }
+
+  const float3 centroid = 0.5f * (bbox_min + bbox_max);
+  const float radius = len(bbox_max - centroid);
+
+  float distance;
+  const float3 point_to_centroid = safe_normalize_len(centroid - P, &distance);
+
+  /* Half angle of the cone bounding the emitters, as seen from the shading point. No useful
+   * bound exists when the shading point is inside the bounding sphere. */
+  const float theta_u = (distance > radius) ? asinf(radius / distance) : M_PI_F;
+
+  /* Minimum angle between the emission cone and the direction towards the shading point. */
+  const float theta = safe_acosf(dot(axis, -point_to_centroid));
+  const float theta_prime = fmaxf(theta - theta_o - theta_u, 0.0f);
+  if (theta_prime >= theta_e) {
+    return 0.0f;
+  }
+  const float cos_theta_prime = cosf(theta_prime);
+
+  /* Minimum angle between the receiver normal and the emitters. Both hemispheres are considered
+   * since surfaces may transmit light. */
+  float cos_theta_i_prime = 1.0f;
+  if (!is_zero(N)) {
+    const float theta_i = safe_acosf(fabsf(dot(N, point_to_centroid)));
+    cos_theta_i_prime = cosf(fmaxf(theta_i - theta_u, 0.0f));
+  }
+
+  /* Clamp the distance to the size of the bounds to avoid singularities for nearby emitters. */
+  const float distance_sq = fmaxf(distance * distance, fmaxf(radius * radius, 1e-8f));
+
+  return energy * cos_theta_prime * cos_theta_i_prime / distance_sq;
+}
+
+ccl_device_inline float light_tree_node_importance(KernelGlobals kg,
+                                                   const float3 P,
+                                                   const float3 N,
+                                                   const int node_index)
+{
+  ccl_global const KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes,
+                                                                  node_index);
+  return light_tree_importance(
+      P,
+      N,
+      make_float3(knode->bbox_min[0], knode->bbox_min[1], knode->bbox_min[2]),
+      make_float3(knode->bbox_max[0], knode->bbox_max[1], knode->bbox_max[2]),
+      make_float3(knode->axis[0], knode->axis[1], knode->axis[2]),
+      knode->theta_o,
+      knode->theta_e,
+      knode->energy);
+}
+
+ccl_device_inline float light_tree_emitter_importance(KernelGlobals kg,
+                                                      const float3 P,
+                                                      const float3 N,
+                                                      const int emitter_index)
+{
+  ccl_global const KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                        emitter_index);
+  return light_tree_importance(
+      P,
+      N,
+      make_float3(kemitter->bbox_min[0], kemitter->bbox_min[1], kemitter->bbox_min[2]),
+      make_float3(kemitter->bbox_max[0], kemitter->bbox_max[1], kemitter->bbox_max[2]),
+      make_float3(kemitter->axis[0], kemitter->axis[1], kemitter->axis[2]),
+      kemitter->theta_o,
+      kemitter->theta_e,
+      kemitter->energy);
+}
+
+/* Sum of the importance of all emitters in a leaf. */
+ccl_device float light_tree_leaf_importance(KernelGlobals kg,
+                                            const float3 P,
+                                            const float3 N,
+                                            ccl_global const KernelLightTreeNode *knode)
+{
+  float total_importance = 0.0f;
+  for (int i = 0; i < knode->num_emitters; i++) {
+    total_importance += light_tree_emitter_importance(kg, P, N, knode->child_index + i);
+  }
+  return total_importance;
+}
+
+/* Choose an emitter, returning its index in the emitters array or -1 if no emitter contributes.
+ * The random number is rescaled so it can be reused for sampling a position on the emitter. */
+ccl_device int light_tree_sample(KernelGlobals kg,
+                                 const float3 P,
+                                 const float3 N,
+                                 ccl_private float *randu,
+                                 ccl_private float *pdf_selection)
+{
+  const int num_emitters = kernel_data.integrator.num_light_tree_emitters;
+  const int num_infinite = kernel_data.integrator.num_light_tree_infinite;
+  const float pdf_infinite = kernel_data.integrator.light_tree_pdf_infinite;
+  float r = *randu;
+
+  /* Distant and background lights. */
+  if (r < pdf_infinite) {
+    r /= pdf_infinite;
+    const int index = min((int)(r * num_infinite), num_infinite - 1);
+    *randu = clamp(r * num_infinite - index, 0.0f, 1.0f - FLT_EPSILON);
+    *pdf_selection = pdf_infinite / num_infinite;
+    return num_emitters + index;
+  }
+
+  r = (r - pdf_infinite) / (1.0f - pdf_infinite);
+  float pdf = 1.0f - pdf_infinite;
+
+  /* Traverse inner nodes. */
+  int node_index = 0;
+  ccl_global const KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, 0);
+  while (knode->num_emitters == 0) {
+    const int left_index = node_index + 1;
+    const int right_index = knode->child_index;
+
+    const float left_importance = light_tree_node_importance(kg, P, N, left_index);
+    const float right_importance = light_tree_node_importance(kg, P, N, right_index);
+    const float total_importance = left_importance + right_importance;
+    if (total_importance == 0.0f) {
+      return -1;
+    }
+
+    const float left_probability = left_importance / total_importance;
+    if (r < left_probability) {
+      node_index = left_index;
+      r = r / left_probability;
+      pdf *= left_probability;
+    }
+    else {
+      node_index = right_index;
+      r = (r - left_probability) / (1.0f - left_probability);
+      pdf *= 1.0f - left_probability;
+    }
+
+    knode = &kernel_tex_fetch(__light_tree_nodes, node_index);
+  }
+
+  /* Pick an emitter in the leaf. */
+  const float total_importance = light_tree_leaf_importance(kg, P, N, knode);
+  if (total_importance == 0.0f) {
+    return -1;
+  }
+
+  const float target = r * total_importance;
+  float cumulative_importance = 0.0f;
+  int emitter_index = -1;
+  float emitter_importance = 0.0f;
+  for (int i = 0; i < knode->num_emitters; i++) {
+    const int index = knode->child_index + i;
+    const float importance = light_tree_emitter_importance(kg, P, N, index);
+    if (importance == 0.0f) {
+      continue;
+    }
+
+    emitter_index = index;
+    emitter_importance = importance;
+    if (target < cumulative_importance + importance) {
+      break;
+    }
+    cumulative_importance += importance;
+  }
+
+  if (emitter_index == -1) {
+    return -1;
+  }
+
+  *randu = clamp(
+      (target - cumulative_importance) / emitter_importance, 0.0f, 1.0f - FLT_EPSILON);
+  *pdf_selection = pdf * emitter_importance / total_importance;
+  return emitter_index;
+}
+
+/* Probability of choosing the emitter from the shading point, matching light_tree_sample. */
+ccl_device float light_tree_pdf(KernelGlobals kg,
+                                const float3 P,
+                                const float3 N,
+                                const int emitter_index)
+{
+  const int num_emitters = kernel_data.integrator.num_light_tree_emitters;
+  const float pdf_infinite = kernel_data.integrator.light_tree_pdf_infinite;
+
+  if (emitter_index >= num_emitters) {
+    return pdf_infinite / kernel_data.integrator.num_light_tree_infinite;
+  }
+
+  /* Follow the bit trail of the leaf from the root. */
+  ccl_global const KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                        emitter_index);
+  uint bit_trail = kernel_tex_fetch(__light_tree_nodes, kemitter->parent_index).bit_trail;
+  float pdf = 1.0f - pdf_infinite;
+
+  int node_index = 0;
+  ccl_global const KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, 0);
+  while (knode->num_emitters == 0) {
+    const int left_index = node_index + 1;
+    const int right_index = knode->child_index;
+
+    const float left_importance = light_tree_node_importance(kg, P, N, left_index);
+    const float right_importance = light_tree_node_importance(kg, P, N, right_index);
+    const float total_importance = left_importance + right_importance;
+    if (total_importance == 0.0f) {
+      return 0.0f;
+    }
+
+    if (bit_trail & 1) {
+      node_index = right_index;
+      pdf *= right_importance / total_importance;
+    }
+    else {
+      node_index = left_index;
+      pdf *= left_importance / total_importance;
+    }
+    bit_trail >>= 1;
+
+    knode = &kernel_tex_fetch(__light_tree_nodes, node_index);
+  }
+
+  const float total_importance = light_tree_leaf_importance(kg, P, N, knode);
+  if (total_importance == 0.0f) {
+    return 0.0f;
+  }
+
+  return pdf * light_tree_emitter_importance(kg, P, N, emitter_index) / total_importance;
+}
+
+/* Ratio between the tree and flat distribution selection probabilities, to convert PDFs of the
+ * light sampling functions to the tree. */
+ccl_device_inline float light_tree_pdf_correction(KernelGlobals kg,
+                                                  const float3 P,
+                                                  const float3 N,
+                                                  const int emitter_index)
+{
+  const float flat_pdf = kernel_tex_fetch(__light_tree_emitters, emitter_index).flat_pdf;
+  if (flat_pdf == 0.0f) {
+    return 0.0f;
+  }
+  return light_tree_pdf(kg, P, N, emitter_index) / flat_pdf;
+}
+
+ccl_device_inline float light_tree_lamp_pdf_correction(KernelGlobals kg,
+                                                       const float3 P,
+                                                       const float3 N,
+                                                       const int lamp)
+{
+  const int distribution_index = kernel_data.integrator.num_distribution -
+                                 kernel_data.integrator.num_all_lights + lamp;
+  const int emitter_index = kernel_tex_fetch(__light_tree_distribution_to_emitter,
+                                             distribution_index);
+  return light_tree_pdf_correction(kg, P, N, emitter_index);
+}
+
+ccl_device_inline float light_tree_triangle_pdf_correction(
+    KernelGlobals kg, const float3 P, const float3 N, const int object, const int prim)
+{
+  const int2 object_triangles = kernel_tex_fetch(__light_tree_object_triangles, object);
+  if (object_triangles.x == -1) {
+    /* Not part of the light distribution, never chosen by light sampling. */
+    return 0.0f;
+  }
+
+  const uint emitter_index = kernel_tex_fetch(__light_tree_triangles,
+                                              object_triangles.x + prim - object_triangles.y);
+  if (emitter_index == ~0u) {
+    return 0.0f;
+  }
+
+  return light_tree_pdf_correction(kg, P, N, emitter_index);
+}
+
+/* Distant and background lights are chosen independent of the shading point. */
+ccl_device_inline float light_tree_infinite_pdf_correction(KernelGlobals kg)
+{
+  return kernel_data.integrator.light_tree_pdf_infinite /
+         (kernel_data.integrator.num_light_tree_infinite * kernel_data.integrator.pdf_lights);
+}
+
+CCL_NAMESPACE_END
@@ -18,14 +18,20 @@
 
 CCL_NAMESPACE_BEGIN
 
-ccl_device float4 svm_image_texture(KernelGlobals kg, int id, float x, float y, uint flags)
+ccl_device float4 svm_image_texture(KernelGlobals kg,
+                                    int id,
+                                    float x,
+                                    float y,
+                                    const float2 dx,
+                                    const float2 dy,
+                                    uint flags)
 {
   if (id == -1) {
     return make_float4(
         TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
   }
 
-  float4 r = kernel_tex_image_interp(kg, id, x, y);
+  float4 r = kernel_tex_image_interp_with_derivatives(kg, id, x, y, dx, dy);
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -40,6 +46,21 @@ ccl_device float4 svm_image_texture(KernelGlobals kg, int id, float x, float y,
   return r;
 }
 
+/* Estimate the derivatives of the texture coordinates from the default UV map, used to choose
+ * the mipmap level of images in the texture cache. Only valid when the texture coordinates are
+ * the default UV map, other coordinates have no derivatives and use the highest resolution. */
+ccl_device_inline void svm_image_texture_uv_derivatives(KernelGlobals kg,
+                                                        ccl_private const ShaderData *sd,
+                                                        ccl_private float2 *dx,
+                                                        ccl_private float2 *dy)
+{
+  const AttributeDescriptor desc = find_attribute(kg, sd, ATTR_STD_UV);
+
+  if (desc.offset != ATTR_STD_NOT_FOUND) {
+    primitive_surface_attribute_float2(kg, sd, desc, dx, dy);
+  }
+}
+
 /* Remap coordinate from 0..1 box to -1..-1 */
 ccl_device_inline float3 texco_remap_square(float3 co)
 {
@@ -110,7 +131,12 @@ ccl_device_noinline int svm_node_tex_image(
     id = -num_nodes;
   }
 
-  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+  float2 dx = zero_float2(), dy = zero_float2();
+  if (id != -1 && (flags & NODE_IMAGE_DEFAULT_UV) && kernel_tex_image_use_derivatives(kg, id)) {
+    svm_image_texture_uv_derivatives(kg, sd, &dx, &dy);
+  }
+
+  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, dx, dy, flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -204,15 +230,15 @@ ccl_device_noinline void svm_node_tex_image_box(KernelGlobals kg,
   /* Map so that no textures are flipped, rotation is somewhat arbitrary. */
   if (weight.x > 0.0f) {
     float2 uv = make_float2((signed_N.x < 0.0f) ? 1.0f - co.y : co.y, co.z);
-    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
   if (weight.y > 0.0f) {
     float2 uv = make_float2((signed_N.y > 0.0f) ? 1.0f - co.x : co.x, co.z);
-    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
   if (weight.z > 0.0f) {
     float2 uv = make_float2((signed_N.z > 0.0f) ? 1.0f - co.y : co.y, co.x);
-    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
 
   if (stack_valid(out_offset))
@@ -242,7 +268,7 @@ ccl_device_noinline void svm_node_tex_environment(KernelGlobals kg,
   else
     uv = direction_to_mirrorball(co);
 
-  float4 f = svm_image_texture(kg, id, uv.x, uv.y, flags);
+  float4 f = svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -41,6 +41,7 @@ KERNEL_TEX(DecomposedTransform, __camera_motion)
 /* triangles */
 KERNEL_TEX(uint, __tri_shader)
 KERNEL_TEX(packed_float3, __tri_vnormal)
+KERNEL_TEX(uint, __tri_vnormal_oct)
 KERNEL_TEX(uint4, __tri_vindex)
 KERNEL_TEX(uint, __tri_patch)
 KERNEL_TEX(float2, __tri_patch_uv)
@@ -67,6 +68,11 @@ KERNEL_TEX(KernelLightDistribution, __light_distribution)
 KERNEL_TEX(KernelLight, __lights)
 KERNEL_TEX(float2, __light_background_marginal_cdf)
 KERNEL_TEX(float2, __light_background_conditional_cdf)
+KERNEL_TEX(KernelLightTreeNode, __light_tree_nodes)
+KERNEL_TEX(KernelLightTreeEmitter, __light_tree_emitters)
+KERNEL_TEX(uint, __light_tree_distribution_to_emitter)
+KERNEL_TEX(int2, __light_tree_object_triangles)
+KERNEL_TEX(uint, __light_tree_triangles)
 
 /* particles */
 KERNEL_TEX(KernelParticle, __particles)
@@ -63,6 +63,19 @@ CCL_NAMESPACE_BEGIN
 #define INTEGRATOR_SHADOW_ISECT_SIZE_CPU 1024U
 #define INTEGRATOR_SHADOW_ISECT_SIZE_GPU 4U
 
+/* Maximum number of path states traced together by the CPU wavefront integrator. */
+#define INTEGRATOR_WAVEFRONT_SIZE_CPU 64
+
+/* Path guiding grid resolution along each axis of the scene bounds, direction bins per grid cell
+ * along each axis, and number of path vertices which receive contributions while training. */
+#define GUIDING_GRID_RESOLUTION 16
+#define GUIDING_DIRECTION_RESOLUTION 8
+#define GUIDING_NUM_CELLS \
+  (GUIDING_GRID_RESOLUTION * GUIDING_GRID_RESOLUTION * GUIDING_GRID_RESOLUTION)
+#define GUIDING_NUM_BINS (GUIDING_DIRECTION_RESOLUTION * GUIDING_DIRECTION_RESOLUTION)
+#define GUIDING_MAX_VERTICES 4
+#define GUIDING_CELL_NONE (-1)
+
 #ifdef __KERNEL_CPU__
 #  define INTEGRATOR_SHADOW_ISECT_SIZE INTEGRATOR_SHADOW_ISECT_SIZE_CPU
 #else
@@ -108,6 +121,8 @@ CCL_NAMESPACE_BEGIN
 #    define __OSL__
 #  endif
 #  define __VOLUME_RECORD_ALL__
+#  define __PATH_GUIDING__
+#  define __COMPACT_GEOMETRY__
 #endif /* __KERNEL_CPU__ */
 
 #ifdef __KERNEL_OPTIX__
@@ -1207,8 +1222,19 @@ typedef struct KernelIntegrator {
   /* MIS debuging */
   int direct_light_sampling_type;
 
+  /* light tree */
+  int use_light_tree;
+  int num_light_tree_emitters;
+  int num_light_tree_infinite;
+  float light_tree_pdf_infinite;
+
+  /* path guiding */
+  float guiding_probability;
+  float guiding_bounds_min[3];
+  float guiding_inv_cell_size[3];
+
   /* padding */
-  int pad1, pad2;
+  int pad1, pad2, pad3;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
 
@@ -1248,6 +1274,10 @@ typedef struct KernelBVH {
   int scene, pad2;
 #  endif
 #endif
+
+  /* Mesh vertex locations stored per vertex and normals octahedral encoded. */
+  int compact_geometry;
+  int pad3, pad4, pad5;
 } KernelBVH;
 static_assert_align(KernelBVH, 16);
 
@@ -1281,6 +1311,18 @@ typedef struct KernelData {
 } KernelData;
 static_assert_align(KernelData, 16);
 
+/* Path guiding distribution and training data. Owned by the host and shared with the CPU kernels,
+ * which read the distribution and accumulate into the training data. */
+typedef struct KernelPathGuiding {
+  /* Cumulative distribution over the direction bins of every grid cell, all zero for cells which
+   * received no training data yet. */
+  const float *distribution;
+  /* Contributions accumulated for every grid cell and direction bin. */
+  float *training;
+  /* Record path contributions into the training data. */
+  bool use_training;
+} KernelPathGuiding;
+
 /* Kernel data structures. */
 
 typedef struct KernelObject {
@@ -1392,6 +1434,47 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+/* Light Tree */
+
+typedef struct KernelLightTreeNode {
+  /* Spatial and orientation bounds of all emitters in the node. */
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  float theta_o;
+  float axis[3];
+  float theta_e;
+
+  /* For inner nodes, the index of the right child, the left child directly follows the node.
+   * For leaves, the index of the first emitter in the emitters array. */
+  int child_index;
+  /* Number of emitters in a leaf, zero for inner nodes. */
+  int num_emitters;
+  /* Bit i is set if the node is in the right sub-tree at depth i. */
+  uint bit_trail;
+  int pad;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
+typedef struct KernelLightTreeEmitter {
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  float theta_o;
+  float axis[3];
+  float theta_e;
+
+  /* Index into the light distribution. */
+  int distribution_index;
+  /* Index of the leaf node the emitter belongs to, -1 for distant and background lights which
+   * are sampled outside of the tree. */
+  int parent_index;
+  /* Selection probability in the flat light distribution. */
+  float flat_pdf;
+  int pad;
+} KernelLightTreeEmitter;
+static_assert_align(KernelLightTreeEmitter, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
@@ -1596,6 +1679,9 @@ enum KernelFeatureFlag : unsigned int {
   KERNEL_FEATURE_AO_PASS = (1U << 25U),
   KERNEL_FEATURE_AO_ADDITIVE = (1U << 26U),
   KERNEL_FEATURE_AO = (KERNEL_FEATURE_AO_PASS | KERNEL_FEATURE_AO_ADDITIVE),
+
+  /* Path guiding. */
+  KERNEL_FEATURE_PATH_GUIDING = (1U << 27U),
 };
 
 /* Shader node feature mask, to specialize shader evaluation for kernels. */
@@ -42,12 +42,20 @@ bool BakeManager::get_baking() const
 
 void BakeManager::set(Scene *scene, const std::string &object_name_)
 {
+  if (object_name == object_name_) {
+    return;
+  }
+
+  const bool was_baking = get_baking();
   object_name = object_name_;
 
   /* create device and update scene */
-  scene->film->tag_modified();
-  scene->integrator->tag_update(scene, Integrator::UPDATE_ALL);
+  if (was_baking != get_baking()) {
+    scene->film->tag_modified();
+    scene->integrator->tag_update(scene, Integrator::UPDATE_ALL);
+  }
 
+  /* Switching to another object only changes the baking kernel data. */
   need_update_ = true;
 }
 
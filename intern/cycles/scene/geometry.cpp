@@ -16,6 +16,7 @@
 
 #include "bvh/bvh.h"
 #include "bvh/bvh2.h"
+#include "bvh/cache.h"
 
 #include "device/device.h"
 
@@ -74,6 +75,8 @@ Geometry::Geometry(const NodeType *node_type, const Type type)
   bvh = NULL;
   attr_map_offset = 0;
   prim_offset = 0;
+
+  bvh_cache_deforming = false;
 }
 
 Geometry::~Geometry()
@@ -198,6 +201,11 @@ void Geometry::compute_bvh(
 
   compute_bounds();
 
+  /* Hash all modified geometry here, as the scene level BVH may need it too. */
+  if (!params->bvh_cache_path.empty()) {
+    bvh_cache_update_geometry_hash(this);
+  }
+
   const BVHLayout bvh_layout = BVHParams::best_bvh_layout(params->bvh_layout,
                                                           device->get_bvh_layout_mask());
   if (need_build_bvh(bvh_layout)) {
@@ -241,6 +249,8 @@ void Geometry::compute_bvh(
       bparams.num_motion_curve_steps = params->num_bvh_time_steps;
       bparams.bvh_type = params->bvh_type;
       bparams.curve_subdivisions = params->curve_subdivisions();
+      bparams.cache_path = params->bvh_cache_path;
+      bparams.cache_size = (size_t)params->bvh_cache_size * 1024 * 1024;
 
       delete bvh;
       bvh = BVH::create(bparams, geometry, objects, device);
@@ -1065,7 +1075,7 @@ void GeometryManager::mesh_calc_offset(Scene *scene, BVHLayout bvh_layout)
   }
 }
 
-void GeometryManager::device_update_mesh(Device *,
+void GeometryManager::device_update_mesh(Device *device,
                                          DeviceScene *dscene,
                                          Scene *scene,
                                          Progress &progress)
@@ -1107,14 +1117,23 @@ void GeometryManager::device_update_mesh(Device *,
     }
   }
 
+  /* The compact layout is only decoded by the CPU kernels. */
+  const bool use_compact_geometry = scene->params.use_compact_geometry &&
+                                    device->info.type == DEVICE_CPU;
+  dscene->data.bvh.compact_geometry = use_compact_geometry;
+
   /* Fill in all the arrays. */
   if (tri_size != 0) {
     /* normals */
     progress.set_status("Updating Mesh", "Computing normals");
 
-    packed_float3 *tri_verts = dscene->tri_verts.alloc(tri_size * 3);
+    packed_float3 *tri_verts = dscene->tri_verts.alloc(use_compact_geometry ? vert_size :
+                                                                              tri_size * 3);
     uint *tri_shader = dscene->tri_shader.alloc(tri_size);
-    packed_float3 *vnormal = dscene->tri_vnormal.alloc(vert_size);
+    packed_float3 *vnormal = (use_compact_geometry) ? nullptr :
+                                                      dscene->tri_vnormal.alloc(vert_size);
+    uint *vnormal_oct = (use_compact_geometry) ? dscene->tri_vnormal_oct.alloc(vert_size) :
+                                                 nullptr;
     uint4 *tri_vindex = dscene->tri_vindex.alloc(tri_size);
     uint *tri_patch = dscene->tri_patch.alloc(tri_size);
     float2 *tri_patch_uv = dscene->tri_patch_uv.alloc(vert_size);
@@ -1122,6 +1141,7 @@ void GeometryManager::device_update_mesh(Device *,
     const bool copy_all_data = dscene->tri_shader.need_realloc() ||
                                dscene->tri_vindex.need_realloc() ||
                                dscene->tri_vnormal.need_realloc() ||
+                               dscene->tri_vnormal_oct.need_realloc() ||
                                dscene->tri_patch.need_realloc() ||
                                dscene->tri_patch_uv.need_realloc();
 
@@ -1135,15 +1155,18 @@ void GeometryManager::device_update_mesh(Device *,
         }
 
         if (mesh->verts_is_modified() || copy_all_data) {
-          mesh->pack_normals(&vnormal[mesh->vert_offset]);
+          mesh->pack_normals((vnormal) ? &vnormal[mesh->vert_offset] : nullptr,
+                             (vnormal_oct) ? &vnormal_oct[mesh->vert_offset] : nullptr);
         }
 
         if (mesh->verts_is_modified() || mesh->triangles_is_modified() ||
             mesh->vert_patch_uv_is_modified() || copy_all_data) {
-          mesh->pack_verts(&tri_verts[mesh->prim_offset * 3],
+          mesh->pack_verts(use_compact_geometry ? &tri_verts[mesh->vert_offset] :
+                                                  &tri_verts[mesh->prim_offset * 3],
                            &tri_vindex[mesh->prim_offset],
                            &tri_patch[mesh->prim_offset],
-                           &tri_patch_uv[mesh->vert_offset]);
+                           &tri_patch_uv[mesh->vert_offset],
+                           use_compact_geometry);
         }
 
         if (progress.get_cancel())
@@ -1157,6 +1180,7 @@ void GeometryManager::device_update_mesh(Device *,
     dscene->tri_verts.copy_to_device_if_modified();
     dscene->tri_shader.copy_to_device_if_modified();
     dscene->tri_vnormal.copy_to_device_if_modified();
+    dscene->tri_vnormal_oct.copy_to_device_if_modified();
     dscene->tri_vindex.copy_to_device_if_modified();
     dscene->tri_patch.copy_to_device_if_modified();
     dscene->tri_patch_uv.copy_to_device_if_modified();
@@ -1243,6 +1267,8 @@ void GeometryManager::device_update_bvh(Device *device,
   bparams.num_motion_curve_steps = scene->params.num_bvh_time_steps;
   bparams.bvh_type = scene->params.bvh_type;
   bparams.curve_subdivisions = scene->params.curve_subdivisions();
+  bparams.cache_path = scene->params.bvh_cache_path;
+  bparams.cache_size = (size_t)scene->params.bvh_cache_size * 1024 * 1024;
 
   VLOG(1) << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
@@ -1556,6 +1582,7 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
     if (device_update_flags & DEVICE_MESH_DATA_NEEDS_REALLOC) {
       dscene->tri_verts.tag_realloc();
       dscene->tri_vnormal.tag_realloc();
+      dscene->tri_vnormal_oct.tag_realloc();
       dscene->tri_vindex.tag_realloc();
       dscene->tri_patch.tag_realloc();
       dscene->tri_patch_uv.tag_realloc();
@@ -1619,6 +1646,7 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
      * these are the only arrays that can be updated */
     dscene->tri_verts.tag_modified();
     dscene->tri_vnormal.tag_modified();
+    dscene->tri_vnormal_oct.tag_modified();
     dscene->tri_shader.tag_modified();
   }
 
@@ -1811,7 +1839,14 @@ void GeometryManager::device_update(Device *device,
 
         mesh->subd_params->camera = dicing_camera;
         DiagSplit dsplit(*mesh->subd_params);
-        mesh->tessellate(&dsplit);
+        {
+          scoped_callback_timer timer([scene, mesh](double time) {
+            if (scene->update_stats) {
+              scene->update_stats->timeline.add_entry("Subdivision", mesh->name.string(), time);
+            }
+          });
+          mesh->tessellate(&dsplit);
+        }
 
         i++;
 
@@ -1890,6 +1925,11 @@ void GeometryManager::device_update(Device *device,
       if (geom->is_modified()) {
         if (geom->is_mesh()) {
           Mesh *mesh = static_cast<Mesh *>(geom);
+          scoped_callback_timer timer([scene, mesh](double time) {
+            if (scene->update_stats && mesh->has_true_displacement()) {
+              scene->update_stats->timeline.add_entry("Displacement", mesh->name.string(), time);
+            }
+          });
           if (displace(device, scene, mesh, progress)) {
             displacement_done = true;
           }
@@ -1953,9 +1993,16 @@ void GeometryManager::device_update(Device *device,
     foreach (Geometry *geom, scene->geometry) {
       if (geom->is_modified() || geom->need_update_bvh_for_offset) {
         need_update_scene_bvh = true;
-        pool.push(function_bind(
-            &Geometry::compute_bvh, geom, device, dscene, &scene->params, &progress, i, num_bvh));
-        if (geom->need_build_bvh(bvh_layout)) {
+        const bool need_build_bvh = geom->need_build_bvh(bvh_layout);
+        pool.push([=, &progress]() {
+          scoped_callback_timer timer([scene, geom, need_build_bvh](double time) {
+            if (scene->update_stats && need_build_bvh) {
+              scene->update_stats->timeline.add_entry("BVH Build", geom->name.string(), time);
+            }
+          });
+          geom->compute_bvh(device, dscene, &scene->params, &progress, i, num_bvh);
+        });
+        if (need_build_bvh) {
           i++;
         }
       }
@@ -2058,6 +2105,7 @@ void GeometryManager::device_update(Device *device,
   dscene->tri_vindex.clear_modified();
   dscene->tri_patch.clear_modified();
   dscene->tri_vnormal.clear_modified();
+  dscene->tri_vnormal_oct.clear_modified();
   dscene->tri_patch_uv.clear_modified();
   dscene->curves.clear_modified();
   dscene->curve_keys.clear_modified();
@@ -2084,6 +2132,7 @@ void GeometryManager::device_free(Device *device, DeviceScene *dscene, bool forc
   dscene->tri_verts.free_if_need_realloc(force_free);
   dscene->tri_shader.free_if_need_realloc(force_free);
   dscene->tri_vnormal.free_if_need_realloc(force_free);
+  dscene->tri_vnormal_oct.free_if_need_realloc(force_free);
   dscene->tri_vindex.free_if_need_realloc(force_free);
   dscene->tri_patch.free_if_need_realloc(force_free);
   dscene->tri_patch_uv.free_if_need_realloc(force_free);
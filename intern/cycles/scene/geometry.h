@@ -83,6 +83,11 @@ class Geometry : public Node {
   size_t attr_map_offset;
   size_t prim_offset;
 
+  /* BVH disk cache, see bvh/cache.h. Hash of the primitives, computed again only when the
+   * geometry is modified, and whether the primitives change between frames. */
+  string bvh_cache_hash;
+  bool bvh_cache_deforming;
+
   /* Shader Properties */
   bool has_volume;         /* Set in the device_update_flags(). */
   bool has_surface_bssrdf; /* Set in the device_update_flags(). */
@@ -32,6 +32,8 @@
 #include "util/texture.h"
 #include "util/unique_ptr.h"
 
+#include <OpenImageIO/texture.h>
+
 #ifdef WITH_OSL
 #  include <OSL/oslexec.h>
 #endif
@@ -77,6 +79,8 @@ const char *name_from_type(ImageDataType type)
       return "nanovdb_float";
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT3:
       return "nanovdb_float3";
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      return "texture_cache";
     case IMAGE_DATA_NUM_TYPES:
       assert(!"System enumerator type, should never be used");
       return "";
@@ -304,6 +308,10 @@ ImageManager::ImageManager(const DeviceInfo &info)
 
   /* Set image limits */
   features.has_nanovdb = info.has_nanovdb;
+
+  /* Only the CPU kernel can read images from the texture cache. */
+  texture_cache_supported = (info.type == DEVICE_CPU);
+  texture_cache = NULL;
 }
 
 ImageManager::~ImageManager()
@@ -474,7 +482,7 @@ void ImageManager::remove_image_user(int slot)
     need_update_ = true;
 }
 
-static bool image_associate_alpha(ImageManager::Image *img)
+static bool image_associate_alpha(const ImageManager::Image *img)
 {
   /* For typical RGBA images we let OIIO convert to associated alpha,
    * but some types we want to leave the RGB channels untouched. */
@@ -639,6 +647,72 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
   return true;
 }
 
+bool ImageManager::use_texture_cache(const Image *img) const
+{
+  if (texture_cache == NULL || img->loader->osl_filepath().empty()) {
+    return false;
+  }
+
+  /* Pixels are returned as stored in the file, so only use the cache for 2D images that need no
+   * color space conversion. Alpha is always associated by the texture system, which would alter
+   * the color of images that must keep their RGB channels untouched. */
+  const ImageMetaData &metadata = img->metadata;
+  const bool has_alpha = (metadata.channels == 2 || metadata.channels == 4);
+  return metadata.channels > 0 && metadata.depth <= 1 &&
+         (metadata.colorspace == u_colorspace_raw || metadata.colorspace == u_colorspace_srgb) &&
+         (!has_alpha || image_associate_alpha(img));
+}
+
+void ImageManager::texture_cache_load_image(Image *img)
+{
+  OIIO::TextureSystem *ts = (OIIO::TextureSystem *)texture_cache;
+  OIIO::TextureSystem::TextureHandle *handle = ts->get_texture_handle(
+      img->loader->osl_filepath());
+
+  thread_scoped_lock device_lock(device_mutex);
+  OIIO::TextureSystem::TextureHandle **data = (OIIO::TextureSystem::TextureHandle **)
+                                                   img->mem->alloc(1, 1);
+  data[0] = handle;
+
+  /* Pixels are read by the kernel when needed, only the handle is stored. */
+  img->mem->info.width = img->metadata.width;
+  img->mem->info.height = img->metadata.height;
+}
+
+void ImageManager::device_update_texture_cache(Device *device, Scene *scene)
+{
+  /* OSL reads images through its own texture system. */
+  if (texture_cache || !scene->params.texture_cache || !texture_cache_supported ||
+      osl_texture_system) {
+    return;
+  }
+
+  OIIO::TextureSystem *ts = OIIO::TextureSystem::create(false);
+  ts->attribute("automip", 1);
+  ts->attribute("autotile", 64);
+  ts->attribute("gray_to_rgb", 1);
+  ts->attribute("max_memory_MB", (float)scene->params.texture_cache_size);
+
+  VLOG(1) << "Using texture cache with " << scene->params.texture_cache_size << " MB.";
+
+  texture_cache = ts;
+  device->set_cpu_texture_cache(texture_cache);
+}
+
+void ImageManager::device_free_texture_cache(Device *device)
+{
+  if (texture_cache == NULL) {
+    return;
+  }
+
+  OIIO::TextureSystem *ts = (OIIO::TextureSystem *)texture_cache;
+  VLOG(1) << "Texture cache statistics:\n" << ts->getstats();
+
+  device->set_cpu_texture_cache(NULL);
+  OIIO::TextureSystem::destroy(ts);
+  texture_cache = NULL;
+}
+
 void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Progress *progress)
 {
   if (progress->get_cancel()) {
@@ -649,11 +723,22 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
 
   progress->set_status("Updating Images", "Loading " + img->loader->name());
 
+  scoped_callback_timer timer([scene, img](double time) {
+    if (scene->update_stats) {
+      scene->update_stats->timeline.add_entry("Image Load", img->loader->name(), time);
+    }
+  });
+
   const int texture_limit = scene->params.texture_limit;
 
   load_image_metadata(img);
   ImageDataType type = img->metadata.type;
 
+  /* Read file images on demand, instead of loading all pixels. */
+  if (use_texture_cache(img)) {
+    type = IMAGE_DATA_TYPE_TEXTURE_CACHE;
+  }
+
   /* Name for debugging. */
   img->mem_name = string_printf("__tex_image_%s_%03d", name_from_type(type), slot);
 
@@ -670,7 +755,10 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   img->mem->info.transform_3d = img->metadata.transform_3d;
 
   /* Create new texture. */
-  if (type == IMAGE_DATA_TYPE_FLOAT4) {
+  if (type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    texture_cache_load_image(img);
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
@@ -791,6 +879,10 @@ void ImageManager::device_free_image(Device *, int slot)
 #endif
   }
 
+  if (img->mem && img->mem->info.data_type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    ((OIIO::TextureSystem *)texture_cache)->invalidate(img->loader->osl_filepath());
+  }
+
   if (img->mem) {
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
@@ -813,6 +905,8 @@ void ImageManager::device_update(Device *device, Scene *scene, Progress &progres
     }
   });
 
+  device_update_texture_cache(device, scene);
+
   TaskPool pool;
   for (size_t slot = 0; slot < images.size(); slot++) {
     Image *img = images[slot];
@@ -879,6 +973,8 @@ void ImageManager::device_free(Device *device)
     device_free_image(device, slot);
   }
   images.clear();
+
+  device_free_texture_cache(device);
 }
 
 void ImageManager::collect_statistics(RenderStats *stats)
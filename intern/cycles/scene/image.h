@@ -228,6 +228,10 @@ class ImageManager {
   vector<Image *> images;
   void *osl_texture_system;
 
+  /* OpenImageIO texture system for images that are read on demand, see use_texture_cache(). */
+  bool texture_cache_supported;
+  void *texture_cache;
+
   int add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(int slot);
   void remove_image_user(int slot);
@@ -237,6 +241,11 @@ class ImageManager {
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, int texture_limit);
 
+  bool use_texture_cache(const Image *img) const;
+  void texture_cache_load_image(Image *img);
+  void device_update_texture_cache(Device *device, Scene *scene);
+  void device_free_texture_cache(Device *device);
+
   void device_load_image(Device *device, Scene *scene, int slot, Progress *progress);
   void device_free_image(Device *device, int slot);
 
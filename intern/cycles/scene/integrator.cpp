@@ -98,6 +98,11 @@ NODE_DEFINE(Integrator)
   SOCKET_INT(adaptive_min_samples, "Adaptive Min Samples", 0);
 
   SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.05f);
+  SOCKET_BOOLEAN(use_light_tree, "Use Light Tree", false);
+
+  SOCKET_BOOLEAN(use_guiding, "Use Guiding", false);
+  SOCKET_FLOAT(guiding_probability, "Guiding Probability", 0.5f);
+  SOCKET_INT(guiding_training_samples, "Guiding Training Samples", 128);
 
   static NodeEnum sampling_pattern_enum;
   sampling_pattern_enum.insert("sobol", SAMPLING_PATTERN_SOBOL);
@@ -138,6 +143,11 @@ Integrator::~Integrator()
 
 void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene)
 {
+  /* Object transforms and geometry only affect the path guiding grid, avoid a full update. */
+  if (guiding_bounds_need_update_) {
+    device_update_guiding_bounds(dscene, scene);
+  }
+
   if (!is_modified())
     return;
 
@@ -290,10 +300,39 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
 
   kintegrator->has_shadow_catcher = scene->has_shadow_catcher();
 
+  /* A fraction of the paths always samples the BSDF, so that directions the guiding distribution
+   * missed are still sampled. */
+  kintegrator->guiding_probability = clamp(guiding_probability, 0.0f, 0.95f);
+
   dscene->sample_pattern_lut.clear_modified();
   clear_modified();
 }
 
+void Integrator::device_update_guiding_bounds(DeviceScene *dscene, Scene *scene)
+{
+  KernelIntegrator *kintegrator = &dscene->data.integrator;
+
+  /* Path guiding grid over the bounds of all objects. Object bounds are computed by the geometry
+   * manager, which is updated before the integrator. */
+  BoundBox guiding_bounds = BoundBox::empty;
+  foreach (Object *object, scene->objects) {
+    if (object->bounds.valid()) {
+      guiding_bounds.grow(object->bounds);
+    }
+  }
+  if (!guiding_bounds.valid()) {
+    guiding_bounds = BoundBox(zero_float3(), one_float3());
+  }
+
+  const float3 guiding_size = max(guiding_bounds.size(), make_float3(1e-5f, 1e-5f, 1e-5f));
+  for (int i = 0; i < 3; i++) {
+    kintegrator->guiding_bounds_min[i] = guiding_bounds.min[i];
+    kintegrator->guiding_inv_cell_size[i] = GUIDING_GRID_RESOLUTION / guiding_size[i];
+  }
+
+  guiding_bounds_need_update_ = false;
+}
+
 void Integrator::device_free(Device *, DeviceScene *dscene, bool force_free)
 {
   dscene->sample_pattern_lut.free_if_need_realloc(force_free);
@@ -301,6 +340,11 @@ void Integrator::device_free(Device *, DeviceScene *dscene, bool force_free)
 
 void Integrator::tag_update(Scene *scene, uint32_t flag)
 {
+  if (flag & GUIDING_BOUNDS_MODIFIED) {
+    guiding_bounds_need_update_ = true;
+    flag &= ~GUIDING_BOUNDS_MODIFIED;
+  }
+
   if (flag & UPDATE_ALL) {
     tag_modified();
   }
@@ -324,9 +368,13 @@ void Integrator::tag_update(Scene *scene, uint32_t flag)
     scene->object_manager->tag_update(scene, ObjectManager::MOTION_BLUR_MODIFIED);
     scene->camera->tag_modified();
   }
+
+  if (use_light_tree_is_modified()) {
+    scene->light_manager->tag_update(scene, LightManager::LIGHT_MODIFIED);
+  }
 }
 
-uint Integrator::get_kernel_features() const
+uint Integrator::get_kernel_features(const Scene *scene) const
 {
   uint kernel_features = 0;
 
@@ -334,6 +382,11 @@ uint Integrator::get_kernel_features() const
     kernel_features |= KERNEL_FEATURE_AO_ADDITIVE;
   }
 
+  /* Path guiding is only implemented for the CPU. */
+  if (use_guiding && scene->device->info.type == DEVICE_CPU) {
+    kernel_features |= KERNEL_FEATURE_PATH_GUIDING;
+  }
+
   return kernel_features;
 }
 
@@ -81,6 +81,11 @@ class Integrator : public Node {
   NODE_SOCKET_API(int, start_sample)
 
   NODE_SOCKET_API(float, light_sampling_threshold)
+  NODE_SOCKET_API(bool, use_light_tree)
+
+  NODE_SOCKET_API(bool, use_guiding)
+  NODE_SOCKET_API(float, guiding_probability)
+  NODE_SOCKET_API(int, guiding_training_samples)
 
   NODE_SOCKET_API(bool, use_adaptive_sampling)
   NODE_SOCKET_API(int, adaptive_min_samples)
@@ -99,6 +104,7 @@ class Integrator : public Node {
   enum : uint32_t {
     AO_PASS_MODIFIED = (1 << 0),
     OBJECT_MANAGER = (1 << 1),
+    GUIDING_BOUNDS_MODIFIED = (1 << 2),
 
     /* tag everything in the manager for an update */
     UPDATE_ALL = ~0u,
@@ -114,10 +120,15 @@ class Integrator : public Node {
 
   void tag_update(Scene *scene, uint32_t flag);
 
-  uint get_kernel_features() const;
+  uint get_kernel_features(const Scene *scene) const;
 
   AdaptiveSampling get_adaptive_sampling() const;
   DenoiseParams get_denoise_params() const;
+
+ protected:
+  void device_update_guiding_bounds(DeviceScene *dscene, Scene *scene);
+
+  bool guiding_bounds_need_update_ = true;
 };
 
 CCL_NAMESPACE_END
@@ -20,6 +20,7 @@
 #include "scene/film.h"
 #include "scene/integrator.h"
 #include "scene/light.h"
+#include "scene/light_tree.h"
 #include "scene/mesh.h"
 #include "scene/object.h"
 #include "scene/scene.h"
@@ -33,6 +34,7 @@
 #include "util/foreach.h"
 #include "util/hash.h"
 #include "util/log.h"
+#include "util/map.h"
 #include "util/path.h"
 #include "util/progress.h"
 #include "util/task.h"
@@ -527,6 +529,282 @@ void LightManager::device_update_distribution(Device *,
   }
 }
 
+static float light_tree_shader_emission(Scene *scene,
+                                        Shader *shader,
+                                        unordered_map<Shader *, float> &emission_cache)
+{
+  if (shader == NULL) {
+    shader = scene->default_light;
+  }
+
+  auto it = emission_cache.find(shader);
+  if (it != emission_cache.end()) {
+    return it->second;
+  }
+
+  /* Shaders with varying emission have no cheap estimate, assume unit strength for them. */
+  float3 constant_emission;
+  const float emission = shader->is_constant_emission(&constant_emission) ?
+                             fabsf(average(constant_emission)) :
+                             1.0f;
+  emission_cache[shader] = emission;
+  return emission;
+}
+
+static void light_tree_emitter_pack(KernelLightTreeEmitter &kemitter,
+                                    const LightTreePrimitive &prim,
+                                    int parent_index)
+{
+  kemitter.bbox_min[0] = prim.bbox.min.x;
+  kemitter.bbox_min[1] = prim.bbox.min.y;
+  kemitter.bbox_min[2] = prim.bbox.min.z;
+  kemitter.energy = prim.energy;
+  kemitter.bbox_max[0] = prim.bbox.max.x;
+  kemitter.bbox_max[1] = prim.bbox.max.y;
+  kemitter.bbox_max[2] = prim.bbox.max.z;
+  kemitter.theta_o = prim.bcone.theta_o;
+  kemitter.axis[0] = prim.bcone.axis.x;
+  kemitter.axis[1] = prim.bcone.axis.y;
+  kemitter.axis[2] = prim.bcone.axis.z;
+  kemitter.theta_e = prim.bcone.theta_e;
+  kemitter.distribution_index = prim.distribution_index;
+  kemitter.parent_index = parent_index;
+  kemitter.flat_pdf = prim.flat_pdf;
+  kemitter.pad = 0;
+}
+
+void LightManager::device_update_tree(Device *,
+                                      DeviceScene *dscene,
+                                      Scene *scene,
+                                      Progress &progress)
+{
+  KernelIntegrator *kintegrator = &dscene->data.integrator;
+
+  kintegrator->use_light_tree = false;
+  kintegrator->num_light_tree_emitters = 0;
+  kintegrator->num_light_tree_infinite = 0;
+  kintegrator->light_tree_pdf_infinite = 0.0f;
+
+  if (!scene->integrator->get_use_light_tree() || !kintegrator->use_direct_light) {
+    return;
+  }
+
+  progress.set_status("Updating Lights", "Building light tree");
+
+  /* The tree is built on top of the light distribution: every emitter references its entry in
+   * the distribution, so that sampling code and PDF evaluation of individual lights remain
+   * shared between both methods. */
+  const int num_distribution = kintegrator->num_distribution;
+  const int num_lights = kintegrator->num_all_lights;
+  const KernelLightDistribution *distribution = dscene->light_distribution.data();
+
+  vector<Light *> enabled_lights;
+  foreach (Light *light, scene->lights) {
+    if (light->is_enabled) {
+      enabled_lights.push_back(light);
+    }
+  }
+  assert(enabled_lights.size() == (size_t)num_lights);
+
+  /* Lookup from object and triangle to emitter, used for multiple importance sampling when a
+   * ray hits an emissive triangle. */
+  int2 *object_triangles = dscene->light_tree_object_triangles.alloc(scene->objects.size());
+  size_t num_object_triangles = 0;
+  for (size_t i = 0; i < scene->objects.size(); i++) {
+    object_triangles[i] = make_int2(-1, 0);
+  }
+
+  vector<LightTreePrimitive> prims;
+  vector<LightTreePrimitive> infinite_prims;
+  prims.reserve(num_distribution);
+  unordered_map<Shader *, float> emission_cache;
+
+  for (int index = 0; index < num_distribution; index++) {
+    if (progress.get_cancel()) {
+      return;
+    }
+
+    const KernelLightDistribution &kdistribution = distribution[index];
+    LightTreePrimitive prim;
+    prim.distribution_index = index;
+
+    if (kdistribution.prim >= 0) {
+      const int object_id = kdistribution.mesh_light.object_id;
+      Object *object = scene->objects[object_id];
+      Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
+      const int triangle = kdistribution.prim - mesh->prim_offset;
+
+      if (object_triangles[object_id].x == -1) {
+        object_triangles[object_id] = make_int2(num_object_triangles, mesh->prim_offset);
+        num_object_triangles += mesh->num_triangles();
+      }
+
+      Mesh::Triangle t = mesh->get_triangle(triangle);
+      float3 p[3] = {zero_float3(), zero_float3(), zero_float3()};
+      if (t.valid(&mesh->get_verts()[0])) {
+        for (int k = 0; k < 3; k++) {
+          p[k] = mesh->get_verts()[t.v[k]];
+          if (!mesh->transform_applied) {
+            p[k] = transform_point(&object->get_tfm(), p[k]);
+          }
+        }
+      }
+
+      const int shader_index = mesh->get_shader()[triangle];
+      Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
+                           static_cast<Shader *>(mesh->get_used_shaders()[shader_index]) :
+                           scene->default_surface;
+
+      const float area = triangle_area(p[0], p[1], p[2]);
+      float3 normal = cross(p[1] - p[0], p[2] - p[0]);
+      normal = (len_squared(normal) > 0.0f) ? normalize(normal) : make_float3(0.0f, 0.0f, 1.0f);
+
+      prim.bbox = BoundBox::empty;
+      prim.bbox.grow(p[0]);
+      prim.bbox.grow(p[1]);
+      prim.bbox.grow(p[2]);
+      prim.centroid = (p[0] + p[1] + p[2]) * (1.0f / 3.0f);
+      /* Mesh lights emit from both sides. */
+      prim.bcone = OrientationBounds(normal, M_PI_F, M_PI_2_F);
+      prim.energy = M_PI_F * area * light_tree_shader_emission(scene, shader, emission_cache);
+      prim.flat_pdf = area * kintegrator->pdf_triangles;
+      prims.push_back(prim);
+      continue;
+    }
+
+    const int lamp = ~kdistribution.prim;
+    Light *light = enabled_lights[lamp];
+    prim.flat_pdf = kintegrator->pdf_lights;
+
+    if (light->light_type == LIGHT_DISTANT || light->light_type == LIGHT_BACKGROUND) {
+      /* Infinitely distant lights have no meaningful spatial bounds, they are sampled separately
+       * from the tree. */
+      prim.bbox = BoundBox::empty;
+      prim.centroid = zero_float3();
+      prim.bcone = OrientationBounds::empty;
+      prim.energy = 0.0f;
+      infinite_prims.push_back(prim);
+      continue;
+    }
+
+    const float strength = fabsf(average(light->strength)) *
+                           light_tree_shader_emission(scene, light->shader, emission_cache);
+
+    prim.centroid = light->co;
+    if (light->light_type == LIGHT_AREA) {
+      const float3 axisu = light->axisu * (light->sizeu * light->size);
+      const float3 axisv = light->axisv * (light->sizev * light->size);
+      prim.bbox = BoundBox::empty;
+      prim.bbox.grow(light->co + 0.5f * axisu + 0.5f * axisv);
+      prim.bbox.grow(light->co + 0.5f * axisu - 0.5f * axisv);
+      prim.bbox.grow(light->co - 0.5f * axisu + 0.5f * axisv);
+      prim.bbox.grow(light->co - 0.5f * axisu - 0.5f * axisv);
+      prim.bcone = OrientationBounds(safe_normalize(light->dir), 0.0f, M_PI_2_F);
+      prim.energy = M_PI_4_F * strength;
+    }
+    else {
+      prim.bbox = BoundBox::empty;
+      prim.bbox.grow(light->co, light->size);
+      if (light->light_type == LIGHT_SPOT) {
+        prim.bcone = OrientationBounds(safe_normalize(light->dir), light->spot_angle * 0.5f, 0.0f);
+      }
+      else {
+        prim.bcone = OrientationBounds(make_float3(0.0f, 0.0f, 1.0f), M_PI_F, M_PI_2_F);
+      }
+      prim.energy = strength;
+    }
+
+    prims.push_back(prim);
+  }
+
+  const int num_local = prims.size();
+  const int num_infinite = infinite_prims.size();
+
+  LightTree light_tree(prims);
+
+  /* Pack nodes. */
+  const vector<LightTreeNode> &nodes = light_tree.get_nodes();
+  const vector<LightTreePrimitive> &tree_prims = light_tree.get_prims();
+
+  KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(max((int)nodes.size(), 1));
+  KernelLightTreeEmitter *kemitters = dscene->light_tree_emitters.alloc(
+      max(num_local + num_infinite, 1));
+  uint *distribution_to_emitter = dscene->light_tree_distribution_to_emitter.alloc(
+      num_distribution);
+
+  for (size_t index = 0; index < nodes.size(); index++) {
+    const LightTreeNode &node = nodes[index];
+    KernelLightTreeNode &knode = knodes[index];
+
+    knode.bbox_min[0] = node.bbox.min.x;
+    knode.bbox_min[1] = node.bbox.min.y;
+    knode.bbox_min[2] = node.bbox.min.z;
+    knode.energy = node.energy;
+    knode.bbox_max[0] = node.bbox.max.x;
+    knode.bbox_max[1] = node.bbox.max.y;
+    knode.bbox_max[2] = node.bbox.max.z;
+    knode.theta_o = node.bcone.theta_o;
+    knode.axis[0] = node.bcone.axis.x;
+    knode.axis[1] = node.bcone.axis.y;
+    knode.axis[2] = node.bcone.axis.z;
+    knode.theta_e = node.bcone.theta_e;
+    knode.child_index = node.child_index;
+    knode.num_emitters = node.num_prims;
+    knode.bit_trail = node.bit_trail;
+    knode.pad = 0;
+
+    if (node.is_leaf()) {
+      for (int i = node.child_index; i < node.child_index + node.num_prims; i++) {
+        light_tree_emitter_pack(kemitters[i], tree_prims[i], index);
+        distribution_to_emitter[tree_prims[i].distribution_index] = i;
+      }
+    }
+  }
+
+  for (int i = 0; i < num_infinite; i++) {
+    light_tree_emitter_pack(kemitters[num_local + i], infinite_prims[i], -1);
+    distribution_to_emitter[infinite_prims[i].distribution_index] = num_local + i;
+  }
+
+  /* Fill triangle lookup. */
+  uint *triangles = dscene->light_tree_triangles.alloc(max((int)num_object_triangles, 1));
+  for (size_t i = 0; i < num_object_triangles; i++) {
+    triangles[i] = ~0u;
+  }
+  for (int i = 0; i < num_local; i++) {
+    const KernelLightTreeEmitter &kemitter = kemitters[i];
+    const KernelLightDistribution &kdistribution = distribution[kemitter.distribution_index];
+    if (kdistribution.prim >= 0) {
+      const int2 object_offset = object_triangles[kdistribution.mesh_light.object_id];
+      triangles[object_offset.x + kdistribution.prim - object_offset.y] = i;
+    }
+  }
+
+  /* Sample infinite lights and the tree with equal probability when both are present, similar
+   * to how triangles and lights share the flat distribution. */
+  kintegrator->use_light_tree = true;
+  kintegrator->num_light_tree_emitters = num_local;
+  kintegrator->num_light_tree_infinite = num_infinite;
+  if (num_infinite == 0) {
+    kintegrator->light_tree_pdf_infinite = 0.0f;
+  }
+  else if (num_local == 0) {
+    kintegrator->light_tree_pdf_infinite = 1.0f;
+  }
+  else {
+    kintegrator->light_tree_pdf_infinite = 0.5f;
+  }
+
+  VLOG(1) << "Light tree built with " << nodes.size() << " nodes for " << num_local
+          << " emitters and " << num_infinite << " distant lights.";
+
+  dscene->light_tree_nodes.copy_to_device();
+  dscene->light_tree_emitters.copy_to_device();
+  dscene->light_tree_distribution_to_emitter.copy_to_device();
+  dscene->light_tree_object_triangles.copy_to_device();
+  dscene->light_tree_triangles.copy_to_device();
+}
+
 static void background_cdf(
     int start, int end, int res_x, int res_y, const vector<float3> *pixels, float2 *cond_cdf)
 {
@@ -992,6 +1270,10 @@ void LightManager::device_update(Device *device,
   if (progress.get_cancel())
     return;
 
+  device_update_tree(device, dscene, scene, progress);
+  if (progress.get_cancel())
+    return;
+
   if (need_update_background) {
     device_update_background(device, dscene, scene, progress);
     if (progress.get_cancel())
@@ -1010,6 +1292,11 @@ void LightManager::device_free(Device *, DeviceScene *dscene, const bool free_ba
 {
   dscene->light_distribution.free();
   dscene->lights.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_emitters.free();
+  dscene->light_tree_distribution_to_emitter.free();
+  dscene->light_tree_object_triangles.free();
+  dscene->light_tree_triangles.free();
   if (free_background) {
     dscene->light_background_marginal_cdf.free();
     dscene->light_background_conditional_cdf.free();
@@ -142,6 +142,10 @@ class LightManager {
                                   DeviceScene *dscene,
                                   Scene *scene,
                                   Progress &progress);
+  void device_update_tree(Device *device,
+                          DeviceScene *dscene,
+                          Scene *scene,
+                          Progress &progress);
   void device_update_background(Device *device,
                                 DeviceScene *dscene,
                                 Scene *scene,
@@ -0,0 +1,281 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scene/light_tree.h"
+
+#include "util/algorithm.h"
+#include "util/math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Orientation Bounds */
+
+float OrientationBounds::calculate_measure() const
+{
+  const float theta_w = fminf(M_PI_F, theta_o + theta_e);
+  const float cos_theta_o = cosf(theta_o);
+  const float sin_theta_o = sinf(theta_o);
+
+  return M_2PI_F * (1.0f - cos_theta_o) +
+         M_PI_2_F * (2.0f * theta_w * sin_theta_o - cosf(theta_o - 2.0f * theta_w) -
+                     2.0f * theta_o * sin_theta_o + cos_theta_o);
+}
+
+OrientationBounds merge(const OrientationBounds &cone_a, const OrientationBounds &cone_b)
+{
+  if (cone_a.is_empty()) {
+    return cone_b;
+  }
+  if (cone_b.is_empty()) {
+    return cone_a;
+  }
+
+  /* Set cone a to always have the greater theta_o. */
+  const OrientationBounds *a = &cone_a;
+  const OrientationBounds *b = &cone_b;
+  if (cone_b.theta_o > cone_a.theta_o) {
+    a = &cone_b;
+    b = &cone_a;
+  }
+
+  const float theta_d = safe_acosf(dot(a->axis, b->axis));
+  const float theta_e = fmaxf(a->theta_e, b->theta_e);
+
+  /* Return axis and theta_o of a if it already contains b.
+   * This should also be called when b is empty. */
+  if (fminf(theta_d + b->theta_o, M_PI_F) <= a->theta_o) {
+    return OrientationBounds(a->axis, a->theta_o, theta_e);
+  }
+
+  /* Compute new theta_o that contains both a and b. */
+  const float theta_o = (theta_d + a->theta_o + b->theta_o) * 0.5f;
+  if (theta_o >= M_PI_F) {
+    return OrientationBounds(a->axis, M_PI_F, theta_e);
+  }
+
+  /* Rotate new axis to be between a and b. */
+  const float theta_r = theta_o - a->theta_o;
+  float3 new_axis = cross(a->axis, b->axis);
+  if (len_squared(new_axis) < 1e-12f) {
+    /* Axes are (anti-)parallel, the rotation is undefined so bound all directions. */
+    return OrientationBounds(a->axis, M_PI_F, theta_e);
+  }
+  new_axis = rotate_around_axis(a->axis, normalize(new_axis), theta_r);
+  new_axis = normalize(new_axis);
+
+  return OrientationBounds(new_axis, theta_o, theta_e);
+}
+
+/* Light Tree */
+
+LightTree::LightTree(vector<LightTreePrimitive> &prims)
+{
+  prims_.swap(prims);
+
+  if (prims_.empty()) {
+    return;
+  }
+
+  nodes_.reserve(prims_.size() * 2);
+  recursive_build(0, prims_.size(), 0, 0);
+  nodes_.shrink_to_fit();
+}
+
+int LightTree::recursive_build(int start, int end, uint bit_trail, int depth)
+{
+  BoundBox bbox = BoundBox::empty;
+  BoundBox centroid_bbox = BoundBox::empty;
+  OrientationBounds bcone = OrientationBounds::empty;
+  float energy_total = 0.0f;
+  const int num_prims = end - start;
+
+  for (int i = start; i < end; i++) {
+    const LightTreePrimitive &prim = prims_[i];
+    bbox.grow(prim.bbox);
+    centroid_bbox.grow(prim.centroid);
+    bcone = merge(bcone, prim.bcone);
+    energy_total += prim.energy;
+  }
+
+  const int current_index = nodes_.size();
+  nodes_.push_back(LightTreeNode());
+  {
+    LightTreeNode &node = nodes_[current_index];
+    node.bbox = bbox;
+    node.bcone = bcone;
+    node.energy = energy_total;
+    node.bit_trail = bit_trail;
+    node.child_index = -1;
+    node.num_prims = 0;
+  }
+
+  /* Check whether a split is possible and worth it. */
+  const float3 centroid_extent = centroid_bbox.size();
+  const bool try_splitting = num_prims > 1 && depth < max_depth - 1 &&
+                             max3(centroid_extent) > 0.0f;
+
+  int split_dim = -1, split_bucket = 0;
+  float min_cost = FLT_MAX;
+  if (try_splitting) {
+    min_cost = min_split_saoh(centroid_bbox, start, end, bbox, bcone, split_dim, split_bucket);
+  }
+
+  /* The leaf cost is the energy of the node. Always split when there are too many emitters for
+   * a single leaf, since all of them are evaluated when sampling from the leaf. */
+  const bool should_split = split_dim != -1 &&
+                            (num_prims > max_prims_in_leaf || min_cost < energy_total);
+
+  if (!should_split) {
+    LightTreeNode &node = nodes_[current_index];
+    node.child_index = start;
+    node.num_prims = num_prims;
+    return current_index;
+  }
+
+  /* Partition the primitives around the selected bucket. */
+  const float inv_extent = 1.0f / centroid_extent[split_dim];
+  const float min_centroid = centroid_bbox.min[split_dim];
+  LightTreePrimitive *middle_prim = std::partition(
+      &prims_[start], &prims_[end - 1] + 1, [&](const LightTreePrimitive &prim) {
+        int bucket = (int)(num_buckets * (prim.centroid[split_dim] - min_centroid) * inv_extent);
+        bucket = clamp(bucket, 0, num_buckets - 1);
+        return bucket <= split_bucket;
+      });
+
+  int middle = middle_prim - &prims_[0];
+  if (middle == start || middle == end) {
+    /* Degenerate partition due to float rounding, fall back to a median split. */
+    middle = (start + end) / 2;
+    std::nth_element(&prims_[start],
+                     &prims_[middle],
+                     &prims_[end - 1] + 1,
+                     [&](const LightTreePrimitive &a, const LightTreePrimitive &b) {
+                       return a.centroid[split_dim] < b.centroid[split_dim];
+                     });
+  }
+
+  recursive_build(start, middle, bit_trail, depth + 1);
+  const int right_index = recursive_build(middle, end, bit_trail | (1u << depth), depth + 1);
+
+  nodes_[current_index].child_index = right_index;
+  return current_index;
+}
+
+float LightTree::min_split_saoh(const BoundBox &centroid_bbox,
+                                int start,
+                                int end,
+                                const BoundBox &bbox,
+                                const OrientationBounds &bcone,
+                                int &split_dim,
+                                int &split_bucket)
+{
+  struct LightTreeBucketInfo {
+    float energy = 0.0f;
+    int count = 0;
+    BoundBox bbox = BoundBox::empty;
+    OrientationBounds bcone = OrientationBounds::empty;
+  };
+
+  /* Precompute values for the cost of the parent node. */
+  const float parent_area = bbox.area();
+  const float parent_measure = bcone.calculate_measure();
+  const float parent_cost = parent_area * parent_measure;
+  const float inv_parent_cost = (parent_cost > 0.0f) ? 1.0f / parent_cost : 1.0f;
+
+  const float3 extent = centroid_bbox.size();
+  const float max_extent = max3(extent);
+
+  float min_cost = FLT_MAX;
+
+  for (int dim = 0; dim < 3; dim++) {
+    if (extent[dim] == 0.0f) {
+      continue;
+    }
+
+    LightTreeBucketInfo buckets[num_buckets];
+
+    const float inv_extent = 1.0f / extent[dim];
+    for (int i = start; i < end; i++) {
+      const LightTreePrimitive &prim = prims_[i];
+      int bucket = (int)(num_buckets * (prim.centroid[dim] - centroid_bbox.min[dim]) *
+                         inv_extent);
+      bucket = clamp(bucket, 0, num_buckets - 1);
+
+      buckets[bucket].count++;
+      buckets[bucket].energy += prim.energy;
+      buckets[bucket].bbox.grow(prim.bbox);
+      buckets[bucket].bcone = merge(buckets[bucket].bcone, prim.bcone);
+    }
+
+    /* Sweep from the right to accumulate the cost of the right side of each split. */
+    float right_costs[num_buckets - 1];
+    {
+      float energy = 0.0f;
+      BoundBox right_bbox = BoundBox::empty;
+      OrientationBounds right_bcone = OrientationBounds::empty;
+      for (int split = num_buckets - 1; split > 0; split--) {
+        const LightTreeBucketInfo &bucket = buckets[split];
+        energy += bucket.energy;
+        if (bucket.count != 0) {
+          right_bbox.grow(bucket.bbox);
+          right_bcone = merge(right_bcone, bucket.bcone);
+        }
+        right_costs[split - 1] = (energy > 0.0f) ? energy * right_bbox.safe_area() *
+                                                       right_bcone.calculate_measure() :
+                                                   0.0f;
+      }
+    }
+
+    /* Sweep from the left and evaluate the heuristic for every split. */
+    float energy = 0.0f;
+    int count = 0;
+    BoundBox left_bbox = BoundBox::empty;
+    OrientationBounds left_bcone = OrientationBounds::empty;
+    for (int split = 0; split < num_buckets - 1; split++) {
+      const LightTreeBucketInfo &bucket = buckets[split];
+      energy += bucket.energy;
+      count += bucket.count;
+      if (bucket.count != 0) {
+        left_bbox.grow(bucket.bbox);
+        left_bcone = merge(left_bcone, bucket.bcone);
+      }
+
+      if (count == 0 || count == end - start) {
+        continue;
+      }
+
+      const float left_cost = (energy > 0.0f) ? energy * left_bbox.safe_area() *
+                                                    left_bcone.calculate_measure() :
+                                                0.0f;
+
+      /* Regularization to avoid long thin nodes. */
+      const float regularization = max_extent / extent[dim];
+
+      /* Cost relative to the parent, which has the same unit as the energy of the node. */
+      const float cost = regularization * (left_cost + right_costs[split]) * inv_parent_cost;
+
+      if (cost < min_cost) {
+        min_cost = cost;
+        split_dim = dim;
+        split_bucket = split;
+      }
+    }
+  }
+
+  return min_cost;
+}
+
+CCL_NAMESPACE_END
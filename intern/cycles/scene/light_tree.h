@@ -0,0 +1,154 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/types.h"
+
+#include "util/boundbox.h"
+#include "util/types.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Orientation Bounds
+ *
+ * Bounds the cone of directions in which a group of emitters emit light. `axis` is the central
+ * direction of the cone, `theta_o` bounds the spread of the emitter normals around the axis and
+ * `theta_e` bounds the spread of emission around each individual normal. */
+
+struct OrientationBounds {
+  float3 axis;
+  float theta_o;
+  float theta_e;
+
+  OrientationBounds()
+  {
+  }
+
+  OrientationBounds(const float3 &axis_, float theta_o_, float theta_e_)
+      : axis(axis_), theta_o(theta_o_), theta_e(theta_e_)
+  {
+  }
+
+  enum empty_t { empty = 0 };
+
+  /* If the orientation bound is set to empty, the values are set to minimums
+   * so that merging it with another non-empty orientation bound guarantees that
+   * the return value is equal to non-empty orientation bound. */
+  OrientationBounds(empty_t) : axis(zero_float3()), theta_o(FLT_MIN), theta_e(FLT_MIN)
+  {
+  }
+
+  bool is_empty() const
+  {
+    return is_zero(axis);
+  }
+
+  /* Measure of the solid angle spanned by the bounds, used by the build heuristic. */
+  float calculate_measure() const;
+};
+
+OrientationBounds merge(const OrientationBounds &cone_a, const OrientationBounds &cone_b);
+
+/* Light Tree Primitive
+ *
+ * An emitter which is stored in the tree: either an emissive triangle or a light with a
+ * position, identified by its index in the light distribution. */
+
+struct LightTreePrimitive {
+  int distribution_index;
+
+  BoundBox bbox;
+  OrientationBounds bcone;
+  float energy;
+  float3 centroid;
+
+  /* Selection probability of the emitter in the flat light distribution. The kernel uses it to
+   * convert the PDF computed against the flat distribution to the tree selection PDF. */
+  float flat_pdf;
+};
+
+/* Light Tree Node
+ *
+ * Intermediate representation of the tree during the build, flattened afterwards. */
+
+struct LightTreeNode {
+  BoundBox bbox;
+  OrientationBounds bcone;
+  float energy;
+  uint bit_trail;
+
+  /* For inner nodes, the index of the right child. The left child directly follows its parent.
+   * For leaves, the index of the first primitive. */
+  int child_index;
+  /* Number of primitives in the leaf, zero for inner nodes. */
+  int num_prims;
+
+  bool is_leaf() const
+  {
+    return num_prims > 0;
+  }
+};
+
+/* Light Tree
+ *
+ * Bounding volume hierarchy over emitters, which stores spatial and orientation bounds together
+ * with the total emitted energy of each node. At render time the kernel traverses the tree from
+ * the shading point to pick an emitter proportionally to its estimated contribution, instead of
+ * sampling proportionally to power alone.
+ *
+ * The tree is built top-down, splitting each node with the surface area orientation heuristic
+ * (SAOH) evaluated over a fixed number of buckets. */
+
+class LightTree {
+ public:
+  /* Maximum depth is limited by the number of bits in the bit trail. */
+  static const int max_depth = 32;
+  static const int max_prims_in_leaf = 8;
+  static const int num_buckets = 12;
+
+  LightTree(vector<LightTreePrimitive> &prims);
+
+  const vector<LightTreeNode> &get_nodes() const
+  {
+    return nodes_;
+  }
+
+  /* Primitives reordered so that each leaf references a contiguous range. */
+  const vector<LightTreePrimitive> &get_prims() const
+  {
+    return prims_;
+  }
+
+ protected:
+  int recursive_build(int start, int end, uint bit_trail, int depth);
+  float min_split_saoh(const BoundBox &centroid_bbox,
+                       int start,
+                       int end,
+                       const BoundBox &bbox,
+                       const OrientationBounds &bcone,
+                       int &split_dim,
+                       int &split_bucket);
+
+  vector<LightTreePrimitive> prims_;
+  vector<LightTreeNode> nodes_;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
@@ -707,7 +707,8 @@ void Mesh::pack_shaders(Scene *scene, uint *tri_shader)
   }
 }
 
-void Mesh::pack_normals(packed_float3 *vnormal)
+/* Vertex normals are written to either of the arrays, depending on the geometry layout. */
+void Mesh::pack_normals(packed_float3 *vnormal, uint *vnormal_oct)
 {
   Attribute *attr_vN = attributes.find(ATTR_STD_VERTEX_NORMAL);
   if (attr_vN == NULL) {
@@ -727,14 +728,22 @@ void Mesh::pack_normals(packed_float3 *vnormal)
     if (do_transform)
       vNi = safe_normalize(transform_direction(&ntfm, vNi));
 
-    vnormal[i] = make_float3(vNi.x, vNi.y, vNi.z);
+    if (vnormal_oct) {
+      vnormal_oct[i] = float3_to_oct_uint(vNi);
+    }
+    else {
+      vnormal[i] = make_float3(vNi.x, vNi.y, vNi.z);
+    }
   }
 }
 
+/* With the compact layout vertex locations are stored once per vertex rather than for every
+ * triangle corner, and tri_verts points to the first vertex of the mesh. */
 void Mesh::pack_verts(packed_float3 *tri_verts,
                       uint4 *tri_vindex,
                       uint *tri_patch,
-                      float2 *tri_patch_uv)
+                      float2 *tri_patch_uv,
+                      const bool compact)
 {
   size_t verts_size = verts.size();
 
@@ -755,9 +764,17 @@ void Mesh::pack_verts(packed_float3 *tri_verts,
 
     tri_patch[i] = (!get_num_subd_faces()) ? -1 : (triangle_patch[i] * 8 + patch_offset);
 
-    tri_verts[i * 3] = verts[t.v[0]];
-    tri_verts[i * 3 + 1] = verts[t.v[1]];
-    tri_verts[i * 3 + 2] = verts[t.v[2]];
+    if (!compact) {
+      tri_verts[i * 3] = verts[t.v[0]];
+      tri_verts[i * 3 + 1] = verts[t.v[1]];
+      tri_verts[i * 3 + 2] = verts[t.v[2]];
+    }
+  }
+
+  if (compact) {
+    for (size_t i = 0; i < verts_size; i++) {
+      tri_verts[i] = verts[i];
+    }
   }
 }
 
@@ -941,6 +941,13 @@ void ObjectManager::tag_update(Scene *scene, uint32_t flag)
   if (flag & (OBJECT_ADDED | OBJECT_REMOVED | OBJECT_MODIFIED)) {
     scene->integrator->tag_update(scene, Integrator::OBJECT_MANAGER);
   }
+
+  /* Path guiding grid covers the bounds of all objects, which change with object transforms and
+   * geometry (the geometry manager tags us in that case). */
+  if (flag & (OBJECT_ADDED | OBJECT_REMOVED | OBJECT_MODIFIED | TRANSFORM_MODIFIED |
+              GEOMETRY_MANAGER)) {
+    scene->integrator->tag_update(scene, Integrator::GUIDING_BOUNDS_MODIFIED);
+  }
 }
 
 bool ObjectManager::need_update() const
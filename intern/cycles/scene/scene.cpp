@@ -57,6 +57,7 @@ DeviceScene::DeviceScene(Device *device)
       tri_verts(device, "__tri_verts", MEM_GLOBAL),
       tri_shader(device, "__tri_shader", MEM_GLOBAL),
       tri_vnormal(device, "__tri_vnormal", MEM_GLOBAL),
+      tri_vnormal_oct(device, "__tri_vnormal_oct", MEM_GLOBAL),
       tri_vindex(device, "__tri_vindex", MEM_GLOBAL),
       tri_patch(device, "__tri_patch", MEM_GLOBAL),
       tri_patch_uv(device, "__tri_patch_uv", MEM_GLOBAL),
@@ -80,6 +81,12 @@ DeviceScene::DeviceScene(Device *device)
       lights(device, "__lights", MEM_GLOBAL),
       light_background_marginal_cdf(device, "__light_background_marginal_cdf", MEM_GLOBAL),
       light_background_conditional_cdf(device, "__light_background_conditional_cdf", MEM_GLOBAL),
+      light_tree_nodes(device, "__light_tree_nodes", MEM_GLOBAL),
+      light_tree_emitters(device, "__light_tree_emitters", MEM_GLOBAL),
+      light_tree_distribution_to_emitter(
+          device, "__light_tree_distribution_to_emitter", MEM_GLOBAL),
+      light_tree_object_triangles(device, "__light_tree_object_triangles", MEM_GLOBAL),
+      light_tree_triangles(device, "__light_tree_triangles", MEM_GLOBAL),
       particles(device, "__particles", MEM_GLOBAL),
       svm_nodes(device, "__svm_nodes", MEM_GLOBAL),
       shaders(device, "__shaders", MEM_GLOBAL),
@@ -523,7 +530,7 @@ void Scene::update_kernel_features()
   }
 
   kernel_features |= film->get_kernel_features(this);
-  kernel_features |= integrator->get_kernel_features();
+  kernel_features |= integrator->get_kernel_features(this);
 
   dscene.data.kernel_features = kernel_features;
 
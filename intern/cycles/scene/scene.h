@@ -84,6 +84,7 @@ class DeviceScene {
   device_vector<packed_float3> tri_verts;
   device_vector<uint> tri_shader;
   device_vector<packed_float3> tri_vnormal;
+  device_vector<uint> tri_vnormal_oct;
   device_vector<uint4> tri_vindex;
   device_vector<uint> tri_patch;
   device_vector<float2> tri_patch_uv;
@@ -117,6 +118,11 @@ class DeviceScene {
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<KernelLightTreeEmitter> light_tree_emitters;
+  device_vector<uint> light_tree_distribution_to_emitter;
+  device_vector<int2> light_tree_object_triangles;
+  device_vector<uint> light_tree_triangles;
 
   /* particles */
   device_vector<KernelParticle> particles;
@@ -156,10 +162,24 @@ class SceneParams {
   bool use_bvh_spatial_split;
   bool use_bvh_unaligned_nodes;
   int num_bvh_time_steps;
+  /* Directory to cache built BVHs in, so following renders of the same geometry and objects
+   * load them from disk. Disabled when empty. */
+  string bvh_cache_path;
+  /* Size limit of the BVH cache directory in megabytes. */
+  int bvh_cache_size;
   int hair_subdivisions;
   CurveShapeType hair_shape;
   int texture_limit;
 
+  /* Read file images on demand through a texture cache with the given memory budget in
+   * megabytes, instead of loading them fully before rendering. Only supported on the CPU. */
+  bool texture_cache;
+  int texture_cache_size;
+
+  /* Store mesh vertex locations once per vertex instead of per triangle corner, and vertex
+   * normals octahedral encoded, to reduce memory usage. Only supported on the CPU. */
+  bool use_compact_geometry;
+
   bool background;
 
   SceneParams()
@@ -170,9 +190,13 @@ class SceneParams {
     use_bvh_spatial_split = false;
     use_bvh_unaligned_nodes = true;
     num_bvh_time_steps = 0;
+    bvh_cache_size = 8192;
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
+    texture_cache = false;
+    texture_cache_size = 4096;
+    use_compact_geometry = false;
     background = true;
   }
 
@@ -183,8 +207,11 @@ class SceneParams {
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
+             bvh_cache_path == params.bvh_cache_path && bvh_cache_size == params.bvh_cache_size &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             texture_limit == params.texture_limit);
+             texture_limit == params.texture_limit && texture_cache == params.texture_cache &&
+             texture_cache_size == params.texture_cache_size &&
+             use_compact_geometry == params.use_compact_geometry);
   }
 
   int curve_subdivisions()
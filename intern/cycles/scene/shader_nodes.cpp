@@ -363,6 +363,26 @@ void ImageTextureNode::attributes(Shader *shader, AttributeRequestSet *attribute
   ShaderNode::attributes(shader, attributes);
 }
 
+/* Whether the vector input reads the default UV map unmodified. Only then the derivatives of the
+ * default UV map match the texture coordinates. */
+static bool image_vector_is_default_uv(ShaderInput *vector_in)
+{
+  if (!vector_in->link) {
+    return true;
+  }
+
+  ShaderNode *node = vector_in->link->parent;
+  if (node->type == UVMapNode::get_node_type()) {
+    UVMapNode *uvmap = (UVMapNode *)node;
+    return uvmap->get_attribute().empty() && !uvmap->get_from_dupli();
+  }
+  if (node->type == TextureCoordinateNode::get_node_type()) {
+    TextureCoordinateNode *texco = (TextureCoordinateNode *)node;
+    return vector_in->link == node->output("UV") && !texco->get_from_dupli();
+  }
+  return false;
+}
+
 void ImageTextureNode::compile(SVMCompiler &compiler)
 {
   ShaderInput *vector_in = input("Vector");
@@ -395,6 +415,10 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
       flags |= NODE_IMAGE_ALPHA_UNASSOCIATE;
     }
   }
+  if (projection == NODE_IMAGE_PROJ_FLAT && tex_mapping.skip() &&
+      image_vector_is_default_uv(vector_in)) {
+    flags |= NODE_IMAGE_DEFAULT_UV;
+  }
 
   if (projection != NODE_IMAGE_PROJ_BOX) {
     /* If there only is one image (a very common case), we encode it as a negative value. */
@@ -19,6 +19,7 @@
 #include "util/algorithm.h"
 #include "util/foreach.h"
 #include "util/string.h"
+#include "util/time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -40,6 +41,12 @@ bool namedTimeEntryComparator(const NamedTimeEntry &a, const NamedTimeEntry &b)
   return a.time > b.time;
 }
 
+bool namedTimelineEntryComparator(const NamedTimelineEntry &a, const NamedTimelineEntry &b)
+{
+  /* We sort in descending order. */
+  return a.time > b.time;
+}
+
 bool namedTimeSampleEntryComparator(const NamedNestedSampleStats &a,
                                     const NamedNestedSampleStats &b)
 {
@@ -115,6 +122,117 @@ string NamedTimeStats::full_report(int indent_level)
   return result;
 }
 
+/* Named timeline statistics. */
+
+NamedTimelineEntry::NamedTimelineEntry()
+    : stage(""), name(""), start_time(0.0), time(0.0), thread_index(0)
+{
+}
+
+NamedTimelineEntry::NamedTimelineEntry(
+    const string &stage, const string &name, double start_time, double time, int thread_index)
+    : stage(stage), name(name), start_time(start_time), time(time), thread_index(thread_index)
+{
+}
+
+NamedTimelineStats::NamedTimelineStats()
+{
+}
+
+void NamedTimelineStats::add_entry(const string &stage, const string &name, double time)
+{
+  const double end_time = time_dt();
+
+  thread_scoped_lock lock(mutex_);
+  const int thread_index = thread_indices_
+                               .insert(std::make_pair(std::this_thread::get_id(),
+                                                      (int)thread_indices_.size()))
+                               .first->second;
+  entries.push_back(NamedTimelineEntry(stage, name, end_time - time, time, thread_index));
+}
+
+string NamedTimelineStats::full_report(int indent_level, int max_entries)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  const string double_indent = indent + indent;
+  string result = "";
+  result += string_printf("%sNumber of entries: %d\n", indent.c_str(), (int)entries.size());
+  sort(entries.begin(), entries.end(), namedTimelineEntryComparator);
+  for (int i = 0; i < min((int)entries.size(), max_entries); i++) {
+    const NamedTimelineEntry &entry = entries[i];
+    result += string_printf("%s%-24s %-40s %fs\n",
+                            double_indent.c_str(),
+                            entry.stage.c_str(),
+                            entry.name.c_str(),
+                            entry.time);
+  }
+  return result;
+}
+
+static string json_escape(const string &str)
+{
+  string result;
+  foreach (const char c, str) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          result += string_printf("\\u%04x", (int)c);
+        }
+        else {
+          result += c;
+        }
+        break;
+    }
+  }
+  return result;
+}
+
+string NamedTimelineStats::trace_json()
+{
+  double first_start_time = 0.0;
+  if (!entries.empty()) {
+    first_start_time = entries[0].start_time;
+    foreach (const NamedTimelineEntry &entry, entries) {
+      first_start_time = min(first_start_time, entry.start_time);
+    }
+  }
+
+  /* Complete events, with times in microseconds. */
+  string result = "{\"traceEvents\": [";
+  for (size_t i = 0; i < entries.size(); i++) {
+    const NamedTimelineEntry &entry = entries[i];
+    const string &name = entry.name.empty() ? entry.stage : entry.name;
+    result += string_printf(
+        "%s\n  {\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, "
+        "\"dur\": %.3f, \"pid\": 0, \"tid\": %d, \"args\": {\"stage\": \"%s\"}}",
+        (i == 0) ? "" : ",",
+        json_escape(name).c_str(),
+        json_escape(entry.stage).c_str(),
+        (entry.start_time - first_start_time) * 1e6,
+        entry.time * 1e6,
+        entry.thread_index,
+        json_escape(entry.stage).c_str());
+  }
+  result += "\n], \"displayTimeUnit\": \"ms\"}\n";
+  return result;
+}
+
+void NamedTimelineStats::clear()
+{
+  thread_scoped_lock lock(mutex_);
+  entries.clear();
+  thread_indices_.clear();
+}
+
 /* Named time sample statistics. */
 
 NamedNestedSampleStats::NamedNestedSampleStats() : name(""), self_samples(0), sum_samples(0)
@@ -357,6 +475,7 @@ string SceneUpdateStats::full_report()
   result += "SVM:\n" + svm.full_report(1);
   result += "Tables:\n" + tables.full_report(1);
   result += "Procedurals:\n" + procedurals.full_report(1);
+  result += "Slowest items:\n" + timeline.full_report(1);
   return result;
 }
 
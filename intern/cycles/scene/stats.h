@@ -19,8 +19,10 @@
 
 #include "scene/scene.h"
 
+#include "util/map.h"
 #include "util/stats.h"
 #include "util/string.h"
+#include "util/thread.h"
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -102,6 +104,48 @@ class NamedTimeStats {
   }
 };
 
+/* Named entry of a stage of updating a single item, like exporting or building the BVH of one
+ * mesh, with the time it started at. */
+class NamedTimelineEntry {
+ public:
+  NamedTimelineEntry();
+  NamedTimelineEntry(
+      const string &stage, const string &name, double start_time, double time, int thread_index);
+
+  string stage;
+  string name;
+  double start_time;
+  double time;
+  /* Index of the thread which did the work, in order of their first entry. */
+  int thread_index;
+};
+
+/* Container of timeline entries, which can be added from multiple threads. Used to find the
+ * individual items which make synchronization and update of the scene slow. */
+class NamedTimelineStats {
+ public:
+  NamedTimelineStats();
+
+  /* Add entry for a stage which took the given time and ended now. */
+  void add_entry(const string &stage, const string &name, double time);
+
+  /* Generate human-readable report of the slowest entries. */
+  string full_report(int indent_level = 0, int max_entries = 25);
+
+  /* Generate JSON in the Chrome trace event format, which can be viewed in the browser's
+   * tracing tools or further processed by scripts. */
+  string trace_json();
+
+  void clear();
+
+  /* NOTE: Only read when no more entries are being added. */
+  vector<NamedTimelineEntry> entries;
+
+ protected:
+  thread_mutex mutex_;
+  unordered_map<std::thread::id, int> thread_indices_;
+};
+
 class NamedNestedSampleStats {
  public:
   NamedNestedSampleStats();
@@ -221,6 +265,10 @@ class SceneUpdateStats {
   UpdateTimeStats tables;
   UpdateTimeStats procedurals;
 
+  /* Per item timing of the stages of synchronization and device update. This is not cleared
+   * with the other statistics, as synchronization from Blender happens before the update. */
+  NamedTimelineStats timeline;
+
   string full_report();
 
   void clear();
@@ -40,8 +40,14 @@ class OutputDriver {
          const int2 size,
          const int2 full_size,
          const string_view layer,
-         const string_view view)
-        : offset(offset), size(size), full_size(full_size), layer(layer), view(view)
+         const string_view view,
+         const int num_samples)
+        : offset(offset),
+          size(size),
+          full_size(full_size),
+          layer(layer),
+          view(view),
+          num_samples(num_samples)
     {
     }
     virtual ~Tile() = default;
@@ -51,6 +57,8 @@ class OutputDriver {
     const int2 full_size;
     const string layer;
     const string view;
+    /* Number of samples rendered into the tile so far. */
+    const int num_samples;
 
     virtual bool get_pass_pixels(const string_view pass_name,
                                  const int num_channels,
@@ -261,6 +261,14 @@ RenderWork Session::run_update_for_next_iteration()
     path_trace_->set_adaptive_sampling(adaptive_sampling);
   }
 
+  /* Update path guiding training. */
+  {
+    const bool use_guiding = scene->integrator->get_use_guiding() &&
+                             params.device.type == DEVICE_CPU;
+    render_scheduler_.set_guiding_training_samples(
+        use_guiding ? scene->integrator->get_guiding_training_samples() : 0);
+  }
+
   render_scheduler_.set_num_samples(params.samples);
   render_scheduler_.set_start_sample(params.sample_offset);
   render_scheduler_.set_time_limit(params.time_limit);
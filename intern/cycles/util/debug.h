@@ -79,6 +79,9 @@ class DebugFlags {
      * CPUs and GPUs can be selected here instead.
      */
     BVHLayout bvh_layout;
+
+    /* Trace batches of paths together instead of one path at a time. */
+    bool wavefront;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
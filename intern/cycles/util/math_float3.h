@@ -569,6 +569,41 @@ ccl_device_inline float3 ensure_finite3(float3 v)
   return v;
 }
 
+/* Octahedral encoding of a unit vector in 32 bits, with 16 bits per component. The error of the
+ * decoded direction is below 0.005 degrees. */
+
+ccl_device_inline uint float3_to_oct_uint(const float3 N)
+{
+  const float len = fabsf(N.x) + fabsf(N.y) + fabsf(N.z);
+  if (!(len > 0.0f)) {
+    return 0;
+  }
+
+  float x = N.x / len;
+  float y = N.y / len;
+  if (N.z < 0.0f) {
+    const float fx = (1.0f - fabsf(y)) * ((x >= 0.0f) ? 1.0f : -1.0f);
+    const float fy = (1.0f - fabsf(x)) * ((y >= 0.0f) ? 1.0f : -1.0f);
+    x = fx;
+    y = fy;
+  }
+
+  const int ix = (int)floorf(clamp(x, -1.0f, 1.0f) * 32767.0f + 0.5f);
+  const int iy = (int)floorf(clamp(y, -1.0f, 1.0f) * 32767.0f + 0.5f);
+  return ((uint)ix & 0xFFFF) | (((uint)iy & 0xFFFF) << 16);
+}
+
+ccl_device_inline float3 oct_uint_to_float3(const uint v)
+{
+  /* Arithmetic shifts to sign extend the components. */
+  const float x = (float)(((int)(v << 16)) >> 16) * (1.0f / 32767.0f);
+  const float y = (float)(((int)v) >> 16) * (1.0f / 32767.0f);
+  const float z = 1.0f - fabsf(x) - fabsf(y);
+  const float t = max(-z, 0.0f);
+  const float3 N = make_float3(x + ((x >= 0.0f) ? -t : t), y + ((y >= 0.0f) ? -t : t), z);
+  return normalize(N);
+}
+
 CCL_NAMESPACE_END
 
 #endif /* __UTIL_MATH_FLOAT3_H__ */
@@ -24,6 +24,7 @@
 
 OIIO_NAMESPACE_USING
 
+#include <algorithm>
 #include <stdio.h>
 
 #include <sys/stat.h>
@@ -32,12 +33,14 @@ OIIO_NAMESPACE_USING
 #  define DIR_SEP '\\'
 #  define DIR_SEP_ALT '/'
 #  include <direct.h>
+#  include <sys/utime.h>
 #else
 #  define DIR_SEP '/'
 #  include <dirent.h>
 #  include <pwd.h>
 #  include <sys/types.h>
 #  include <unistd.h>
+#  include <utime.h>
 #endif
 
 #ifdef HAVE_SHLWAPI_H
@@ -750,6 +753,16 @@ bool path_remove(const string &path)
   return remove(path.c_str()) == 0;
 }
 
+bool path_touch(const string &path)
+{
+#ifdef _WIN32
+  wstring path_wc = string_to_wstring(path);
+  return _wutime(path_wc.c_str(), NULL) == 0;
+#else
+  return utime(path.c_str(), NULL) == 0;
+#endif
+}
+
 FILE *path_fopen(const string &path, const string &mode)
 {
 #ifdef _WIN32
@@ -778,4 +791,48 @@ void path_cache_clear_except(const string &name, const set<string> &except)
   }
 }
 
+void path_cache_limit_size(const string &dir, const string &prefix, const size_t max_size)
+{
+  if (!path_exists(dir)) {
+    return;
+  }
+
+  struct CacheFile {
+    uint64_t modified_time;
+    size_t size;
+    string path;
+  };
+  vector<CacheFile> files;
+  size_t total_size = 0;
+
+  directory_iterator it(dir), it_end;
+  for (; it != it_end; ++it) {
+    const string filepath = it->path();
+    path_stat_t st;
+    if (!string_startswith(path_filename(filepath), prefix.c_str()) ||
+        path_stat(filepath, &st) != 0 || S_ISDIR(st.st_mode)) {
+      continue;
+    }
+    files.push_back({(uint64_t)st.st_mtime, (size_t)st.st_size, filepath});
+    total_size += st.st_size;
+  }
+
+  if (total_size <= max_size) {
+    return;
+  }
+
+  std::sort(files.begin(), files.end(), [](const CacheFile &a, const CacheFile &b) {
+    return a.modified_time < b.modified_time;
+  });
+
+  for (const CacheFile &file : files) {
+    if (total_size <= max_size) {
+      break;
+    }
+    if (path_remove(file.path)) {
+      total_size -= file.size;
+    }
+  }
+}
+
 CCL_NAMESPACE_END
@@ -65,9 +65,14 @@ bool path_read_text(const string &path, string &text);
 
 /* File manipulation. */
 bool path_remove(const string &path);
+/* Set the modification time of the file to the current time. */
+bool path_touch(const string &path);
 
 /* cache utility */
 void path_cache_clear_except(const string &name, const set<string> &except);
+/* Remove the least recently modified files in the directory whose name starts with the prefix,
+ * until the total size of these files is at most max_size bytes. */
+void path_cache_limit_size(const string &dir, const string &prefix, const size_t max_size);
 
 CCL_NAMESPACE_END
 
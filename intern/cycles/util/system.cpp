@@ -39,6 +39,14 @@ OIIO_NAMESPACE_USING
 #  include <unistd.h>
 #endif
 
+#ifndef _WIN32
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <spawn.h>
+#  include <sys/wait.h>
+extern char **environ;
+#endif
+
 CCL_NAMESPACE_BEGIN
 
 bool system_cpu_ensure_initialized()
@@ -362,24 +370,116 @@ bool system_cpu_support_avx2()
 
 #endif
 
-bool system_call_self(const vector<string> &args)
+#ifdef _WIN32
+/* Quote an argument so that CommandLineToArgvW gives back the original string. Backslashes are
+ * only special in front of quotes. */
+static wstring system_quote_argument(const wstring &arg)
 {
-  /* Escape program and arguments in case they contain spaces. */
-  string cmd = "\"" + Sysutil::this_program_path() + "\"";
+  if (!arg.empty() && arg.find_first_of(L" \t\n\v\"") == wstring::npos) {
+    return arg;
+  }
 
-  for (int i = 0; i < args.size(); i++) {
-    cmd += " \"" + args[i] + "\"";
+  wstring quoted = L"\"";
+  size_t num_backslashes = 0;
+  for (const wchar_t c : arg) {
+    if (c == L'\\') {
+      num_backslashes++;
+      continue;
+    }
+    if (c == L'"') {
+      quoted.append(num_backslashes * 2 + 1, L'\\');
+    }
+    else {
+      quoted.append(num_backslashes, L'\\');
+    }
+    quoted.push_back(c);
+    num_backslashes = 0;
   }
+  quoted.append(num_backslashes * 2, L'\\');
+  quoted.push_back(L'"');
+  return quoted;
+}
+#endif
+
+bool system_call_self(const vector<string> &args)
+{
+  /* Start the process directly instead of through a shell, so arguments are passed unchanged. The
+   * output is discarded. */
+  const string program = Sysutil::this_program_path();
 
 #ifdef _WIN32
-  /* Use cmd /S to avoid issues with spaces in arguments. */
-  cmd = "cmd /S /C \"" + cmd + " > nul \"";
+  wstring cmd = system_quote_argument(string_to_wstring(program));
+  for (const string &arg : args) {
+    cmd += L" " + system_quote_argument(string_to_wstring(arg));
+  }
+
+  SECURITY_ATTRIBUTES security_attributes = {sizeof(security_attributes), NULL, TRUE};
+  HANDLE null_handle = CreateFileW(L"NUL",
+                                   GENERIC_WRITE,
+                                   FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                   &security_attributes,
+                                   OPEN_EXISTING,
+                                   0,
+                                   NULL);
+
+  STARTUPINFOW startup_info = {sizeof(startup_info)};
+  startup_info.dwFlags = STARTF_USESTDHANDLES;
+  startup_info.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+  startup_info.hStdOutput = null_handle;
+  startup_info.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+  PROCESS_INFORMATION process_info;
+  const bool started = CreateProcessW(NULL,
+                                      &cmd[0],
+                                      NULL,
+                                      NULL,
+                                      TRUE,
+                                      0,
+                                      NULL,
+                                      NULL,
+                                      &startup_info,
+                                      &process_info);
+  if (null_handle != INVALID_HANDLE_VALUE) {
+    CloseHandle(null_handle);
+  }
+  if (!started) {
+    return false;
+  }
+
+  WaitForSingleObject(process_info.hProcess, INFINITE);
+  DWORD exit_code = 1;
+  GetExitCodeProcess(process_info.hProcess, &exit_code);
+  CloseHandle(process_info.hProcess);
+  CloseHandle(process_info.hThread);
+  return (exit_code == 0);
 #else
-  /* Quiet output. */
-  cmd += " > /dev/null";
-#endif
+  vector<char *> argv;
+  argv.push_back(const_cast<char *>(program.c_str()));
+  for (const string &arg : args) {
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  }
+  argv.push_back(NULL);
+
+  posix_spawn_file_actions_t file_actions;
+  posix_spawn_file_actions_init(&file_actions);
+  posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+  pid_t pid;
+  const int spawn_result = posix_spawn(
+      &pid, program.c_str(), &file_actions, NULL, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&file_actions);
+  if (spawn_result != 0) {
+    return false;
+  }
 
-  return (system(cmd.c_str()) == 0);
+  int status;
+  while (waitpid(pid, &status, 0) == -1) {
+    if (errno != EINTR) {
+      return false;
+    }
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
 }
 
 size_t system_physical_ram()
@@ -62,7 +62,8 @@ bool system_cpu_support_avx2();
 
 size_t system_physical_ram();
 
-/* Start a new process of the current application with the given arguments. */
+/* Start a new process of the current application with the given arguments and wait for it to
+ * finish. Returns true if it exited successfully. */
 bool system_call_self(const vector<string> &args);
 
 /* Get identifier of the currently running process. */
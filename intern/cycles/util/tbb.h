@@ -24,6 +24,8 @@
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_for_each.h>
+#include <tbb/parallel_invoke.h>
+#include <tbb/parallel_sort.h>
 #include <tbb/task_arena.h>
 #include <tbb/task_group.h>
 
@@ -37,6 +39,8 @@ CCL_NAMESPACE_BEGIN
 using tbb::blocked_range;
 using tbb::enumerable_thread_specific;
 using tbb::parallel_for;
+using tbb::parallel_invoke;
+using tbb::parallel_sort;
 
 static inline void parallel_for_cancel()
 {
@@ -50,6 +50,8 @@ typedef enum ImageDataType {
   IMAGE_DATA_TYPE_USHORT = 7,
   IMAGE_DATA_TYPE_NANOVDB_FLOAT = 8,
   IMAGE_DATA_TYPE_NANOVDB_FLOAT3 = 9,
+  /* Image read on demand by the texture cache on the CPU, the data is a texture handle. */
+  IMAGE_DATA_TYPE_TEXTURE_CACHE = 10,
 
   IMAGE_DATA_NUM_TYPES
 } ImageDataType;
@@ -694,6 +694,10 @@ class NODE_PT_quality(bpy.types.Panel):
         col.prop(tree, "use_opencl")
         col.prop(tree, "use_groupnode_buffer")
         col.prop(tree, "use_two_pass")
+        if prefs.experimental.use_full_frame_compositor:
+            col.prop(tree, "use_half_precision_buffers")
+            col.prop(tree, "use_result_cache")
+            col.prop(tree, "use_viewer_view_border")
         col.prop(tree, "use_viewer_border")
         col.separator()
         col.prop(snode, "use_auto_render")
@@ -22,6 +22,7 @@
 
 #include <atomic>
 #include <iostream>
+#include <mutex>
 
 #include "BLI_float3.hh"
 #include "BLI_float4x4.hh"
@@ -57,7 +58,8 @@ enum class GeometryOwnershipType {
 
 namespace blender::bke {
 class ComponentAttributeProviders;
-}
+class GeometryFieldInput;
+}  // namespace blender::bke
 
 class GeometryComponent;
 
@@ -71,6 +73,16 @@ class GeometryComponent {
   mutable std::atomic<int> users_ = 1;
   GeometryComponentType type_;
 
+  struct FieldInputCacheItem {
+    std::shared_ptr<const blender::bke::GeometryFieldInput> field_input;
+    AttributeDomain domain;
+    blender::fn::GVArray varray;
+  };
+  /* Values of geometry field inputs that have been evaluated on the component while it was
+   * shared, see #blender::bke::GeometryFieldInput. */
+  mutable std::mutex field_input_cache_mutex_;
+  mutable blender::Vector<FieldInputCacheItem> field_input_cache_;
+
  public:
   GeometryComponent(GeometryComponentType type);
   virtual ~GeometryComponent() = default;
@@ -239,6 +251,18 @@ class GeometryComponent {
     return this->attribute_try_get_for_output_only(attribute_id, domain, data_type);
   }
 
+  /**
+   * Get the values of the field input on the domain from the cache, or compute them with the
+   * given function and add them to the cache. Only used while the component is shared, because
+   * it can not be changed until it becomes mutable again.
+   */
+  blender::fn::GVArray field_input_cache_lookup_or_compute(
+      const std::shared_ptr<const blender::bke::GeometryFieldInput> &field_input,
+      const AttributeDomain domain,
+      blender::FunctionRef<blender::fn::GVArray()> compute_fn) const;
+  /* Remove all cached field input values, called when the component may be changed. */
+  void field_input_cache_clear() const;
+
  private:
   virtual const blender::bke::ComponentAttributeProviders *get_attribute_providers() const;
 
@@ -755,6 +779,25 @@ class GeometryComponentFieldContext : public fn::FieldContext {
   }
 };
 
+/**
+ * A field input whose values only depend on the geometry component and the domain it is evaluated
+ * on, like normals. Evaluating the same input on an unchanged geometry in multiple nodes only
+ * computes the values once, because they are cached on the component.
+ */
+class GeometryFieldInput : public fn::FieldInput,
+                           public std::enable_shared_from_this<GeometryFieldInput> {
+ public:
+  using fn::FieldInput::FieldInput;
+
+  GVArray get_varray_for_context(const fn::FieldContext &context,
+                                 IndexMask mask,
+                                 ResourceScope &scope) const final;
+
+  virtual GVArray get_varray_for_geometry(const GeometryComponent &component,
+                                          AttributeDomain domain,
+                                          IndexMask mask) const = 0;
+};
+
 class AttributeFieldInput : public fn::FieldInput {
  private:
   std::string name_;
@@ -0,0 +1,61 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ *
+ * Storage of evaluated geometry sets in files, used to bake the result of a geometry node tree
+ * for every frame. The file contains the raw arrays of the geometry in the same layout as in
+ * memory, aligned so that they can be copied directly from a memory mapped file without any
+ * conversion or parsing.
+ *
+ * Meshes, point clouds, curves and instances are stored with all of their named attributes.
+ * Anonymous attributes and volumes are not stored. Materials, and the objects and collections
+ * that are instanced, are stored by name and looked up again when the file is read.
+ */
+
+#include <optional>
+
+#include "BLI_function_ref.hh"
+#include "BLI_string_ref.hh"
+
+#include "BKE_geometry_set.hh"
+
+struct ID;
+
+namespace blender::bke {
+
+/**
+ * Return the ID with the given type code, name and library file path (empty for local IDs), or
+ * null if it does not exist.
+ */
+using BakeIDLookupFn = FunctionRef<ID *(short id_code, StringRef name, StringRef library_path)>;
+
+/**
+ * Write the geometry to the file. The data is written to a temporary file first, so the file at
+ * the path is never partially written. Return false if the file could not be written.
+ */
+bool geometry_set_bake_write(const GeometrySet &geometry_set, const char *filepath);
+
+/**
+ * Read a geometry written by #geometry_set_bake_write. Return nothing if the file does not exist
+ * or is not a valid bake file.
+ */
+std::optional<GeometrySet> geometry_set_bake_read(const char *filepath, BakeIDLookupFn lookup_id);
+
+}  // namespace blender::bke
@@ -1408,6 +1408,39 @@ OutputAttribute GeometryComponent::attribute_try_get_for_output_only(
 
 namespace blender::bke {
 
+GVArray GeometryFieldInput::get_varray_for_context(const fn::FieldContext &context,
+                                                   IndexMask mask,
+                                                   ResourceScope &UNUSED(scope)) const
+{
+  const GeometryComponentFieldContext *geometry_context =
+      dynamic_cast<const GeometryComponentFieldContext *>(&context);
+  if (geometry_context == nullptr) {
+    return {};
+  }
+  const GeometryComponent &component = geometry_context->geometry_component();
+  const AttributeDomain domain = geometry_context->domain();
+
+  /* A mutable component may be changed by the caller after the evaluation, so values computed on
+   * it are not cached. Shared components are copied before they are changed. */
+  std::shared_ptr<const GeometryFieldInput> self = this->weak_from_this().lock();
+  if (component.is_mutable() || !self) {
+    return this->get_varray_for_geometry(component, domain, mask);
+  }
+
+  return component.field_input_cache_lookup_or_compute(self, domain, [&]() -> GVArray {
+    /* Compute the values for the entire domain, so that they can be reused for any mask. */
+    const int domain_size = component.attribute_domain_size(domain);
+    GVArray varray = this->get_varray_for_geometry(component, domain, IndexRange(domain_size));
+    if (!varray || varray.is_span() || varray.is_single()) {
+      /* The values are cheap to access already. */
+      return varray;
+    }
+    fn::GArray<> values(varray.type(), domain_size);
+    varray.materialize(values.data());
+    return GVArray::ForGArray(std::move(values));
+  });
+}
+
 GVArray AttributeFieldInput::get_varray_for_context(const fn::FieldContext &context,
                                                     IndexMask UNUSED(mask),
                                                     ResourceScope &UNUSED(scope)) const
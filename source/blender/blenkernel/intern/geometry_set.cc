@@ -99,6 +99,48 @@ bool GeometryComponent::is_empty() const
   return false;
 }
 
+blender::fn::GVArray GeometryComponent::field_input_cache_lookup_or_compute(
+    const std::shared_ptr<const blender::bke::GeometryFieldInput> &field_input,
+    const AttributeDomain domain,
+    blender::FunctionRef<blender::fn::GVArray()> compute_fn) const
+{
+  BLI_assert(!this->is_mutable());
+
+  auto lookup = [&]() -> const FieldInputCacheItem * {
+    for (const FieldInputCacheItem &item : field_input_cache_) {
+      if (item.domain == domain && *item.field_input == *field_input) {
+        return &item;
+      }
+    }
+    return nullptr;
+  };
+
+  {
+    std::lock_guard lock{field_input_cache_mutex_};
+    if (const FieldInputCacheItem *item = lookup()) {
+      return item->varray;
+    }
+  }
+
+  /* Compute without holding the lock, so that other inputs can be evaluated on the component in
+   * the meantime, possibly by the input itself. */
+  blender::fn::GVArray varray = compute_fn();
+
+  std::lock_guard lock{field_input_cache_mutex_};
+  if (const FieldInputCacheItem *item = lookup()) {
+    /* Another thread computed the same values in the meantime. */
+    return item->varray;
+  }
+  field_input_cache_.append({field_input, domain, varray});
+  return varray;
+}
+
+void GeometryComponent::field_input_cache_clear() const
+{
+  std::lock_guard lock{field_input_cache_mutex_};
+  field_input_cache_.clear();
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -128,7 +170,9 @@ GeometryComponent &GeometrySet::get_component_for_write(GeometryComponentType co
       [&](GeometryComponentPtr *value_ptr) -> GeometryComponent & {
         GeometryComponentPtr &value = *value_ptr;
         if (value->is_mutable()) {
-          /* If the referenced component is already mutable, return it directly. */
+          /* If the referenced component is already mutable, return it directly. Cached field
+           * inputs become invalid, because the caller may change it. */
+          value->field_input_cache_clear();
           return *value;
         }
         /* If the referenced component is shared, make a copy. The copy is not shared and is
@@ -0,0 +1,945 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bke
+ *
+ * The file starts with a #BakeFileHeader, followed by the geometry set. Every array is preceded
+ * by its size in bytes and starts at an offset that is a multiple of #array_alignment, so that
+ * it can be used in place from the memory mapped file.
+ */
+
+#include <algorithm>
+#include <fcntl.h>
+#include <mutex>
+
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.h"
+#include "BLI_float4x4.hh"
+#include "BLI_mmap.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+
+#include "DNA_collection_types.h"
+#include "DNA_material_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_geometry_set_bake.hh"
+#include "BKE_mesh.h"
+#include "BKE_pointcloud.h"
+#include "BKE_spline.hh"
+
+namespace blender::bke {
+
+using fn::CPPType;
+using fn::GMutableSpan;
+using fn::GSpan;
+using fn::GVArray;
+using fn::GVArray_GSpan;
+
+static constexpr char bake_file_magic[8] = {'B', 'G', 'E', 'O', 'B', 'A', 'K', 'E'};
+/** Increment when the layout of the file changes, older files are not read anymore. */
+static constexpr uint32_t bake_file_version = 3;
+static constexpr int64_t array_alignment = 16;
+
+struct BakeFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t _pad;
+};
+
+/** Matches the order of the values in #InstanceReference::Type. */
+enum class BakeInstanceReferenceType : int8_t {
+  None = 0,
+  Object = 1,
+  Collection = 2,
+  GeometrySet = 3,
+};
+
+/* -------------------------------------------------------------------- */
+/** \name Writing
+ * \{ */
+
+class BakeWriter {
+ private:
+  FILE *file_;
+  int64_t offset_ = 0;
+  bool failed_ = false;
+
+ public:
+  BakeWriter(FILE *file) : file_(file)
+  {
+  }
+
+  bool failed() const
+  {
+    return failed_;
+  }
+
+  void write_bytes(const void *data, const int64_t size)
+  {
+    if (failed_ || size == 0) {
+      return;
+    }
+    if (fwrite(data, size, 1, file_) != 1) {
+      failed_ = true;
+      return;
+    }
+    offset_ += size;
+  }
+
+  template<typename T> void write(const T &value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    this->write_bytes(&value, sizeof(T));
+  }
+
+  void write_string(const StringRef str)
+  {
+    this->write<int32_t>(str.size());
+    this->write_bytes(str.data(), str.size());
+  }
+
+  /** Write the size of the array and padding, so that the data starts at an aligned offset. */
+  void write_array(const void *data, const int64_t size_in_bytes)
+  {
+    this->write<int64_t>(size_in_bytes);
+    static const char zeros[array_alignment] = {0};
+    this->write_bytes(zeros, (array_alignment - offset_ % array_alignment) % array_alignment);
+    this->write_bytes(data, size_in_bytes);
+  }
+
+  template<typename T> void write_array(const Span<T> data)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    this->write_array(data.data(), data.size_in_bytes());
+  }
+
+  void write_array(const GSpan data)
+  {
+    BLI_assert(data.type().is_trivial());
+    this->write_array(data.data(), data.size() * data.type().size());
+  }
+};
+
+static void write_geometry_set(BakeWriter &writer, const GeometrySet &geometry_set);
+
+/**
+ * Write the named attributes of the component, except for the builtin attributes that are
+ * already stored as part of the component's own data.
+ */
+static void write_component_attributes(BakeWriter &writer,
+                                       const GeometryComponent &component,
+                                       const bool skip_builtin)
+{
+  Vector<std::pair<std::string, AttributeMetaData>> attributes;
+  component.attribute_foreach(
+      [&](const AttributeIDRef &attribute_id, const AttributeMetaData &meta_data) {
+        if (!attribute_id.is_named()) {
+          return true;
+        }
+        if (skip_builtin && component.attribute_is_builtin(attribute_id)) {
+          return true;
+        }
+        const CPPType *type = custom_data_type_to_cpp_type(meta_data.data_type);
+        if (type == nullptr || !type->is_trivial()) {
+          return true;
+        }
+        attributes.append({attribute_id.name(), meta_data});
+        return true;
+      });
+
+  writer.write<int32_t>(attributes.size());
+  for (const auto &[name, meta_data] : attributes) {
+    writer.write_string(name);
+    writer.write<int8_t>(meta_data.domain);
+    writer.write<int16_t>(meta_data.data_type);
+    GVArray varray = component.attribute_try_get_for_read(name, meta_data.domain);
+    GVArray_GSpan span{varray};
+    writer.write_array(span);
+  }
+}
+
+static void write_custom_data_attributes(BakeWriter &writer,
+                                         const CustomDataAttributes &attributes,
+                                         const AttributeDomain domain)
+{
+  Vector<std::pair<std::string, CustomDataType>> names;
+  attributes.foreach_attribute(
+      [&](const AttributeIDRef &attribute_id, const AttributeMetaData &meta_data) {
+        if (attribute_id.is_named()) {
+          names.append({attribute_id.name(), meta_data.data_type});
+        }
+        return true;
+      },
+      domain);
+
+  writer.write<int32_t>(names.size());
+  for (const auto &[name, data_type] : names) {
+    writer.write_string(name);
+    writer.write<int16_t>(data_type);
+    writer.write_array(*attributes.get_for_read(name));
+  }
+}
+
+/**
+ * IDs are referenced by name and library path, so that a linked ID is not confused with a local
+ * ID with the same name.
+ */
+static void write_id_reference(BakeWriter &writer, const ID *id)
+{
+  writer.write_string(id == nullptr ? "" : id->name + 2);
+  writer.write_string((id == nullptr || id->lib == nullptr) ? "" : id->lib->filepath);
+}
+
+static void write_mesh(BakeWriter &writer, const MeshComponent &component)
+{
+  const Mesh &mesh = *component.get_for_read();
+  writer.write<int32_t>(mesh.totvert);
+  writer.write<int32_t>(mesh.totedge);
+  writer.write<int32_t>(mesh.totloop);
+  writer.write<int32_t>(mesh.totpoly);
+  writer.write<int8_t>((mesh.runtime.cd_dirty_vert & CD_MASK_NORMAL) != 0);
+  writer.write_array(Span(mesh.mvert, mesh.totvert));
+  writer.write_array(Span(mesh.medge, mesh.totedge));
+  writer.write_array(Span(mesh.mloop, mesh.totloop));
+  writer.write_array(Span(mesh.mpoly, mesh.totpoly));
+
+  writer.write<int32_t>(mesh.totcol);
+  for (const int i : IndexRange(mesh.totcol)) {
+    const Material *material = mesh.mat[i];
+    write_id_reference(writer, material == nullptr ? nullptr : &material->id);
+  }
+
+  /* Positions, material indices, smooth shading and edge creases are stored in the arrays above,
+   * but the ID attribute is stored in a separate layer. */
+  write_component_attributes(writer, component, true);
+  const GVArray ids = component.attribute_try_get_for_read("id", ATTR_DOMAIN_POINT);
+  writer.write<int8_t>(bool(ids));
+  if (ids) {
+    writer.write_array(GVArray_GSpan(ids));
+  }
+}
+
+static void write_pointcloud(BakeWriter &writer, const PointCloudComponent &component)
+{
+  const PointCloud &pointcloud = *component.get_for_read();
+  writer.write<int32_t>(pointcloud.totpoint);
+  write_component_attributes(writer, component, false);
+}
+
+/**
+ * The named point attributes of the curve, which exist on every spline with the same type, see
+ * #CurveEval::assert_valid_point_attributes.
+ */
+static Vector<std::pair<std::string, CustomDataType>> curve_point_attributes(
+    const CurveEval &curve)
+{
+  Vector<std::pair<std::string, CustomDataType>> attributes;
+  if (curve.splines().is_empty()) {
+    return attributes;
+  }
+  curve.splines().first()->attributes.foreach_attribute(
+      [&](const AttributeIDRef &attribute_id, const AttributeMetaData &meta_data) {
+        const CPPType *type = custom_data_type_to_cpp_type(meta_data.data_type);
+        if (attribute_id.is_named() && type != nullptr && type->is_trivial()) {
+          attributes.append({attribute_id.name(), meta_data.data_type});
+        }
+        return true;
+      },
+      ATTR_DOMAIN_POINT);
+  return attributes;
+}
+
+static void write_curve(BakeWriter &writer, const CurveComponent &component)
+{
+  const CurveEval &curve = *component.get_for_read();
+  const Vector<std::pair<std::string, CustomDataType>> point_attributes = curve_point_attributes(
+      curve);
+
+  writer.write<int32_t>(point_attributes.size());
+  for (const auto &[name, data_type] : point_attributes) {
+    writer.write_string(name);
+    writer.write<int16_t>(data_type);
+  }
+
+  writer.write<int32_t>(curve.splines().size());
+  for (const SplinePtr &spline_ptr : curve.splines()) {
+    const Spline &spline = *spline_ptr;
+    writer.write<int8_t>(static_cast<int8_t>(spline.type()));
+    writer.write<int8_t>(spline.is_cyclic());
+    writer.write<int8_t>(spline.normal_mode);
+    writer.write<int32_t>(spline.size());
+    writer.write_array(spline.positions());
+    writer.write_array(spline.radii());
+    writer.write_array(spline.tilts());
+
+    switch (spline.type()) {
+      case Spline::Type::Bezier: {
+        const BezierSpline &bezier_spline = static_cast<const BezierSpline &>(spline);
+        writer.write<int32_t>(bezier_spline.resolution());
+        writer.write_array(bezier_spline.handle_positions_left());
+        writer.write_array(bezier_spline.handle_positions_right());
+        writer.write_array(bezier_spline.handle_types_left());
+        writer.write_array(bezier_spline.handle_types_right());
+        break;
+      }
+      case Spline::Type::NURBS: {
+        const NURBSpline &nurbs_spline = static_cast<const NURBSpline &>(spline);
+        writer.write<int32_t>(nurbs_spline.resolution());
+        writer.write<uint8_t>(nurbs_spline.order());
+        writer.write<int8_t>(static_cast<int8_t>(nurbs_spline.knots_mode));
+        writer.write_array(nurbs_spline.weights());
+        break;
+      }
+      case Spline::Type::Poly:
+        break;
+    }
+
+    for (const auto &item : point_attributes) {
+      writer.write_array(*spline.attributes.get_for_read(item.first));
+    }
+  }
+
+  write_custom_data_attributes(writer, curve.attributes, ATTR_DOMAIN_CURVE);
+}
+
+static void write_instances(BakeWriter &writer, const InstancesComponent &component)
+{
+  writer.write<int32_t>(component.references_amount());
+  for (const InstanceReference &reference : component.references()) {
+    switch (reference.type()) {
+      case InstanceReference::Type::None:
+        writer.write(BakeInstanceReferenceType::None);
+        break;
+      case InstanceReference::Type::Object:
+        writer.write(BakeInstanceReferenceType::Object);
+        write_id_reference(writer, &reference.object().id);
+        break;
+      case InstanceReference::Type::Collection:
+        writer.write(BakeInstanceReferenceType::Collection);
+        write_id_reference(writer, &reference.collection().id);
+        break;
+      case InstanceReference::Type::GeometrySet:
+        writer.write(BakeInstanceReferenceType::GeometrySet);
+        write_geometry_set(writer, reference.geometry_set());
+        break;
+    }
+  }
+
+  writer.write<int32_t>(component.instances_amount());
+  writer.write_array(component.instance_reference_handles());
+  writer.write_array(component.instance_transforms());
+  writer.write<int8_t>(!component.instance_ids().is_empty());
+  if (!component.instance_ids().is_empty()) {
+    writer.write_array(component.instance_ids());
+  }
+  /* The position and ID attributes are stored in the transforms and IDs. */
+  write_component_attributes(writer, component, true);
+}
+
+static void write_geometry_set(BakeWriter &writer, const GeometrySet &geometry_set)
+{
+  Vector<const GeometryComponent *> components;
+  for (const GeometryComponent *component : geometry_set.get_components_for_read()) {
+    if (component->is_empty()) {
+      continue;
+    }
+    if (ELEM(component->type(),
+             GEO_COMPONENT_TYPE_MESH,
+             GEO_COMPONENT_TYPE_POINT_CLOUD,
+             GEO_COMPONENT_TYPE_CURVE,
+             GEO_COMPONENT_TYPE_INSTANCES)) {
+      components.append(component);
+    }
+  }
+
+  writer.write<int32_t>(components.size());
+  for (const GeometryComponent *component : components) {
+    writer.write<int8_t>(component->type());
+    switch (component->type()) {
+      case GEO_COMPONENT_TYPE_MESH:
+        write_mesh(writer, *static_cast<const MeshComponent *>(component));
+        break;
+      case GEO_COMPONENT_TYPE_POINT_CLOUD:
+        write_pointcloud(writer, *static_cast<const PointCloudComponent *>(component));
+        break;
+      case GEO_COMPONENT_TYPE_CURVE:
+        write_curve(writer, *static_cast<const CurveComponent *>(component));
+        break;
+      case GEO_COMPONENT_TYPE_INSTANCES:
+        write_instances(writer, *static_cast<const InstancesComponent *>(component));
+        break;
+      default:
+        BLI_assert_unreachable();
+        break;
+    }
+  }
+}
+
+bool geometry_set_bake_write(const GeometrySet &geometry_set, const char *filepath)
+{
+  char filepath_tmp[FILE_MAX];
+  BLI_snprintf(filepath_tmp, sizeof(filepath_tmp), "%s@", filepath);
+
+  FILE *file = BLI_fopen(filepath_tmp, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  BakeWriter writer{file};
+  BakeFileHeader header;
+  memcpy(header.magic, bake_file_magic, sizeof(header.magic));
+  header.version = bake_file_version;
+  header._pad = 0;
+  writer.write(header);
+  write_geometry_set(writer, geometry_set);
+
+  const bool success = fclose(file) == 0 && !writer.failed();
+  if (!success || BLI_rename(filepath_tmp, filepath) != 0) {
+    BLI_delete(filepath_tmp, false, false);
+    return false;
+  }
+  return true;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Reading
+ * \{ */
+
+/** Memory mapped files register a signal handler, which is not thread-safe. */
+static std::mutex mmap_mutex;
+
+/**
+ * Reads values from the memory mapped file. All reads are checked against the size of the file,
+ * after a failed read all following reads fail as well.
+ */
+class BakeReader {
+ private:
+  BLI_mmap_file *file_;
+  int64_t size_;
+  int64_t offset_ = 0;
+  bool failed_ = false;
+
+ public:
+  BakeIDLookupFn lookup_id;
+
+  BakeReader(BLI_mmap_file *file, const int64_t size, BakeIDLookupFn lookup_id)
+      : file_(file), size_(size), lookup_id(lookup_id)
+  {
+  }
+
+  bool failed() const
+  {
+    return failed_;
+  }
+
+  /** Used when the data read so far is invalid. */
+  void set_failed()
+  {
+    failed_ = true;
+  }
+
+  /**
+   * Check that the file is large enough to contain the given number of bytes after the current
+   * position, to avoid allocating huge arrays when reading invalid files.
+   */
+  bool ensure_remaining(const int64_t size)
+  {
+    if (size > size_ - offset_) {
+      failed_ = true;
+    }
+    return !failed_;
+  }
+
+  bool read_bytes(void *dst, const int64_t size)
+  {
+    if (failed_ || size < 0 || offset_ + size > size_) {
+      failed_ = true;
+      return false;
+    }
+    if (size > 0 && !BLI_mmap_read(file_, dst, offset_, size)) {
+      failed_ = true;
+      return false;
+    }
+    offset_ += size;
+    return true;
+  }
+
+  template<typename T> T read()
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value;
+    if (!this->read_bytes(&value, sizeof(T))) {
+      return T{};
+    }
+    return value;
+  }
+
+  /** Read a count, which fails when it is negative, so that it can be used as a size. */
+  int read_size()
+  {
+    const int32_t size = this->read<int32_t>();
+    if (size < 0) {
+      failed_ = true;
+      return 0;
+    }
+    return size;
+  }
+
+  std::string read_string()
+  {
+    const int size = this->read_size();
+    if (failed_ || offset_ + size > size_) {
+      failed_ = true;
+      return {};
+    }
+    std::string str(size, '\0');
+    this->read_bytes(str.data(), size);
+    return str;
+  }
+
+  /** Read an ID reference written by #write_id_reference and find the ID with the callback. */
+  ID *read_id_reference(const short id_code)
+  {
+    const std::string name = this->read_string();
+    const std::string library_path = this->read_string();
+    if (failed_ || name.empty()) {
+      return nullptr;
+    }
+    return lookup_id(id_code, name, library_path);
+  }
+
+  /** Read an array written by #BakeWriter::write_array, which must have the expected size. */
+  bool read_array(void *dst, const int64_t size_in_bytes)
+  {
+    if (this->read<int64_t>() != size_in_bytes) {
+      failed_ = true;
+      return false;
+    }
+    offset_ += (array_alignment - offset_ % array_alignment) % array_alignment;
+    return this->read_bytes(dst, size_in_bytes);
+  }
+
+  template<typename T> bool read_array(MutableSpan<T> dst)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return this->read_array(dst.data(), dst.size() * sizeof(T));
+  }
+
+  bool read_array(GMutableSpan dst)
+  {
+    return this->read_array(dst.data(), dst.size() * dst.type().size());
+  }
+};
+
+static void read_geometry_set(BakeReader &reader, GeometrySet &geometry_set);
+
+static CustomDataType read_attribute_data_type(BakeReader &reader)
+{
+  const CustomDataType data_type = static_cast<CustomDataType>(reader.read<int16_t>());
+  const CPPType *type = custom_data_type_to_cpp_type(data_type);
+  if (type == nullptr || !type->is_trivial()) {
+    /* The file was not written by #write_component_attributes. */
+    reader.set_failed();
+    return CD_PROP_FLOAT;
+  }
+  return data_type;
+}
+
+static void read_component_attributes(BakeReader &reader, GeometryComponent &component)
+{
+  const int attributes_num = reader.read_size();
+  for ([[maybe_unused]] const int i : IndexRange(attributes_num)) {
+    const std::string name = reader.read_string();
+    const AttributeDomain domain = static_cast<AttributeDomain>(reader.read<int8_t>());
+    const CustomDataType data_type = read_attribute_data_type(reader);
+    if (reader.failed()) {
+      return;
+    }
+    OutputAttribute attribute = component.attribute_try_get_for_output_only(
+        name, domain, data_type);
+    if (!attribute) {
+      reader.set_failed();
+      return;
+    }
+    reader.read_array(attribute.as_span());
+    attribute.save();
+  }
+}
+
+static void read_custom_data_attributes(BakeReader &reader, CustomDataAttributes &attributes)
+{
+  const int attributes_num = reader.read_size();
+  for ([[maybe_unused]] const int i : IndexRange(attributes_num)) {
+    const std::string name = reader.read_string();
+    const CustomDataType data_type = read_attribute_data_type(reader);
+    if (reader.failed()) {
+      return;
+    }
+    attributes.create(name, data_type);
+    reader.read_array(*attributes.get_for_write(name));
+  }
+}
+
+/** Check the indices stored in the topology arrays, which are used without bounds checks. */
+static bool mesh_topology_indices_valid(const Mesh &mesh)
+{
+  for (const MEdge &edge : Span(mesh.medge, mesh.totedge)) {
+    if (edge.v1 >= uint(mesh.totvert) || edge.v2 >= uint(mesh.totvert)) {
+      return false;
+    }
+  }
+  for (const MLoop &loop : Span(mesh.mloop, mesh.totloop)) {
+    if (loop.v >= uint(mesh.totvert) || loop.e >= uint(mesh.totedge)) {
+      return false;
+    }
+  }
+  for (const MPoly &poly : Span(mesh.mpoly, mesh.totpoly)) {
+    if (poly.loopstart < 0 || poly.totloop < 0 || poly.loopstart > mesh.totloop - poly.totloop) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void read_mesh(BakeReader &reader, GeometrySet &geometry_set)
+{
+  const int verts_num = reader.read_size();
+  const int edges_num = reader.read_size();
+  const int loops_num = reader.read_size();
+  const int polys_num = reader.read_size();
+  const bool normals_dirty = reader.read<int8_t>();
+  if (!reader.ensure_remaining(int64_t(sizeof(MVert)) * verts_num +
+                               int64_t(sizeof(MEdge)) * edges_num +
+                               int64_t(sizeof(MLoop)) * loops_num +
+                               int64_t(sizeof(MPoly)) * polys_num)) {
+    return;
+  }
+
+  Mesh *mesh = BKE_mesh_new_nomain(verts_num, edges_num, 0, loops_num, polys_num);
+  geometry_set.replace_mesh(mesh);
+  reader.read_array(MutableSpan(mesh->mvert, mesh->totvert));
+  reader.read_array(MutableSpan(mesh->medge, mesh->totedge));
+  reader.read_array(MutableSpan(mesh->mloop, mesh->totloop));
+  reader.read_array(MutableSpan(mesh->mpoly, mesh->totpoly));
+  /* Invalid indices would make later access to the mesh read out of bounds. */
+  if (reader.failed() || !mesh_topology_indices_valid(*mesh)) {
+    reader.set_failed();
+    return;
+  }
+  if (normals_dirty) {
+    BKE_mesh_normals_tag_dirty(mesh);
+  }
+  else {
+    /* The vertex normals are stored in the vertices. */
+    mesh->runtime.cd_dirty_poly |= CD_MASK_NORMAL;
+  }
+
+  const int materials_num = reader.read_size();
+  if (materials_num > 0 && reader.ensure_remaining(int64_t(sizeof(int32_t)) * 2 * materials_num)) {
+    mesh->mat = (Material **)MEM_calloc_arrayN(materials_num, sizeof(Material *), __func__);
+    mesh->totcol = materials_num;
+    for (const int i : IndexRange(materials_num)) {
+      mesh->mat[i] = reinterpret_cast<Material *>(reader.read_id_reference(ID_MA));
+    }
+  }
+
+  MeshComponent &component = geometry_set.get_component_for_write<MeshComponent>();
+  read_component_attributes(reader, component);
+  if (reader.read<int8_t>()) {
+    OutputAttribute ids = component.attribute_try_get_for_output_only(
+        "id", ATTR_DOMAIN_POINT, CD_PROP_INT32);
+    reader.read_array(ids.as_span());
+    ids.save();
+  }
+}
+
+static void read_pointcloud(BakeReader &reader, GeometrySet &geometry_set)
+{
+  const int points_num = reader.read_size();
+  if (!reader.ensure_remaining(points_num)) {
+    return;
+  }
+  geometry_set.replace_pointcloud(BKE_pointcloud_new_nomain(points_num));
+  read_component_attributes(reader,
+                            geometry_set.get_component_for_write<PointCloudComponent>());
+}
+
+static bool handle_type_valid(const BezierSpline::HandleType type)
+{
+  return ELEM(type,
+              BezierSpline::HandleType::Free,
+              BezierSpline::HandleType::Auto,
+              BezierSpline::HandleType::Vector,
+              BezierSpline::HandleType::Align);
+}
+
+static SplinePtr read_spline(BakeReader &reader)
+{
+  const Spline::Type type = static_cast<Spline::Type>(reader.read<int8_t>());
+  const bool cyclic = reader.read<int8_t>();
+  const Spline::NormalCalculationMode normal_mode = static_cast<Spline::NormalCalculationMode>(
+      reader.read<int8_t>());
+  const int points_num = reader.read_size();
+  if (!ELEM(normal_mode,
+            Spline::NormalCalculationMode::ZUp,
+            Spline::NormalCalculationMode::Minimum,
+            Spline::NormalCalculationMode::Tangent) ||
+      !reader.ensure_remaining(int64_t(sizeof(float3)) * points_num)) {
+    reader.set_failed();
+    return {};
+  }
+
+  SplinePtr spline;
+  switch (type) {
+    case Spline::Type::Bezier:
+      spline = std::make_unique<BezierSpline>();
+      break;
+    case Spline::Type::NURBS:
+      spline = std::make_unique<NURBSpline>();
+      break;
+    case Spline::Type::Poly:
+      spline = std::make_unique<PolySpline>();
+      break;
+    default:
+      reader.set_failed();
+      return {};
+  }
+  spline->resize(points_num);
+  spline->set_cyclic(cyclic);
+  spline->normal_mode = normal_mode;
+  reader.read_array(spline->positions());
+  reader.read_array(spline->radii());
+  reader.read_array(spline->tilts());
+
+  if (BezierSpline *bezier_spline = dynamic_cast<BezierSpline *>(spline.get())) {
+    bezier_spline->set_resolution(reader.read<int32_t>());
+    reader.read_array(bezier_spline->handle_positions_left(true));
+    reader.read_array(bezier_spline->handle_positions_right(true));
+    reader.read_array(bezier_spline->handle_types_left());
+    reader.read_array(bezier_spline->handle_types_right());
+    if (!std::all_of(bezier_spline->handle_types_left().begin(),
+                     bezier_spline->handle_types_left().end(),
+                     handle_type_valid) ||
+        !std::all_of(bezier_spline->handle_types_right().begin(),
+                     bezier_spline->handle_types_right().end(),
+                     handle_type_valid)) {
+      reader.set_failed();
+      return {};
+    }
+  }
+  else if (NURBSpline *nurbs_spline = dynamic_cast<NURBSpline *>(spline.get())) {
+    nurbs_spline->set_resolution(reader.read<int32_t>());
+    const uint8_t order = reader.read<uint8_t>();
+    const NURBSpline::KnotsMode knots_mode = static_cast<NURBSpline::KnotsMode>(
+        reader.read<int8_t>());
+    if (order < 2 || order > 6 ||
+        !ELEM(knots_mode,
+              NURBSpline::KnotsMode::Normal,
+              NURBSpline::KnotsMode::EndPoint,
+              NURBSpline::KnotsMode::Bezier)) {
+      reader.set_failed();
+      return {};
+    }
+    nurbs_spline->set_order(order);
+    nurbs_spline->knots_mode = knots_mode;
+    reader.read_array(nurbs_spline->weights());
+  }
+  return spline;
+}
+
+static void read_curve(BakeReader &reader, GeometrySet &geometry_set)
+{
+  Vector<std::pair<std::string, CustomDataType>> point_attributes;
+  const int point_attributes_num = reader.read_size();
+  for ([[maybe_unused]] const int i : IndexRange(point_attributes_num)) {
+    std::string name = reader.read_string();
+    const CustomDataType data_type = read_attribute_data_type(reader);
+    if (reader.failed()) {
+      return;
+    }
+    point_attributes.append({std::move(name), data_type});
+  }
+
+  const int splines_num = reader.read_size();
+  if (!reader.ensure_remaining(splines_num)) {
+    return;
+  }
+  std::unique_ptr<CurveEval> curve = std::make_unique<CurveEval>();
+  curve->resize(splines_num);
+  MutableSpan<SplinePtr> splines = curve->splines();
+  for (const int i : IndexRange(splines_num)) {
+    SplinePtr spline = read_spline(reader);
+    if (reader.failed()) {
+      return;
+    }
+    /* Every spline gets the same attributes, as expected by #CurveEval. */
+    spline->attributes.reallocate(spline->size());
+    for (const auto &[name, data_type] : point_attributes) {
+      spline->attributes.create(name, data_type);
+      reader.read_array(*spline->attributes.get_for_write(name));
+    }
+    spline->mark_cache_invalid();
+    splines[i] = std::move(spline);
+  }
+
+  read_custom_data_attributes(reader, curve->attributes);
+  if (reader.failed()) {
+    return;
+  }
+  geometry_set.replace_curve(curve.release());
+}
+
+static void read_instances(BakeReader &reader, GeometrySet &geometry_set)
+{
+  InstancesComponent &component = geometry_set.get_component_for_write<InstancesComponent>();
+
+  const int references_num = reader.read_size();
+  for ([[maybe_unused]] const int i : IndexRange(references_num)) {
+    if (reader.failed()) {
+      return;
+    }
+    switch (reader.read<BakeInstanceReferenceType>()) {
+      case BakeInstanceReferenceType::None: {
+        component.add_reference(InstanceReference());
+        break;
+      }
+      case BakeInstanceReferenceType::Object: {
+        ID *id = reader.read_id_reference(ID_OB);
+        component.add_reference(id == nullptr ? InstanceReference() :
+                                                InstanceReference(*(Object *)id));
+        break;
+      }
+      case BakeInstanceReferenceType::Collection: {
+        ID *id = reader.read_id_reference(ID_GR);
+        component.add_reference(id == nullptr ? InstanceReference() :
+                                                InstanceReference(*(Collection *)id));
+        break;
+      }
+      case BakeInstanceReferenceType::GeometrySet: {
+        GeometrySet instance_geometry;
+        read_geometry_set(reader, instance_geometry);
+        component.add_reference(std::move(instance_geometry));
+        break;
+      }
+      default: {
+        reader.set_failed();
+        return;
+      }
+    }
+  }
+
+  const int instances_num = reader.read_size();
+  if (!reader.ensure_remaining(int64_t(sizeof(float4x4)) * instances_num)) {
+    return;
+  }
+  component.resize(instances_num);
+  reader.read_array(component.instance_reference_handles());
+  reader.read_array(component.instance_transforms());
+  if (reader.read<int8_t>()) {
+    reader.read_array(component.instance_ids_ensure());
+  }
+  for (const int handle : component.instance_reference_handles()) {
+    if (handle < 0 || handle >= references_num) {
+      reader.set_failed();
+      return;
+    }
+  }
+  read_component_attributes(reader, component);
+}
+
+static void read_geometry_set(BakeReader &reader, GeometrySet &geometry_set)
+{
+  const int components_num = reader.read_size();
+  for ([[maybe_unused]] const int i : IndexRange(components_num)) {
+    if (reader.failed()) {
+      return;
+    }
+    switch (reader.read<int8_t>()) {
+      case GEO_COMPONENT_TYPE_MESH:
+        read_mesh(reader, geometry_set);
+        break;
+      case GEO_COMPONENT_TYPE_POINT_CLOUD:
+        read_pointcloud(reader, geometry_set);
+        break;
+      case GEO_COMPONENT_TYPE_CURVE:
+        read_curve(reader, geometry_set);
+        break;
+      case GEO_COMPONENT_TYPE_INSTANCES:
+        read_instances(reader, geometry_set);
+        break;
+      default:
+        reader.set_failed();
+        return;
+    }
+  }
+}
+
+std::optional<GeometrySet> geometry_set_bake_read(const char *filepath, BakeIDLookupFn lookup_id)
+{
+  const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    return std::nullopt;
+  }
+  const size_t size = BLI_file_descriptor_size(file);
+
+  BLI_mmap_file *mmap_file;
+  {
+    std::lock_guard lock{mmap_mutex};
+    mmap_file = BLI_mmap_open(file);
+  }
+  if (mmap_file == nullptr) {
+    close(file);
+    return std::nullopt;
+  }
+
+  BakeReader reader{mmap_file, int64_t(size), lookup_id};
+  std::optional<GeometrySet> result;
+  const BakeFileHeader header = reader.read<BakeFileHeader>();
+  if (!reader.failed() && memcmp(header.magic, bake_file_magic, sizeof(header.magic)) == 0 &&
+      header.version == bake_file_version) {
+    GeometrySet geometry_set;
+    read_geometry_set(reader, geometry_set);
+    if (!reader.failed()) {
+      result = std::move(geometry_set);
+    }
+  }
+
+  {
+    std::lock_guard lock{mmap_mutex};
+    BLI_mmap_free(mmap_file);
+  }
+  close(file);
+  return result;
+}
+
+/** \} */
+
+}  // namespace blender::bke
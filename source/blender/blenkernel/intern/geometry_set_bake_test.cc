@@ -0,0 +1,222 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "CLG_log.h"
+
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_pointcloud_types.h"
+
+#include "BKE_appdir.h"
+#include "BKE_geometry_set_bake.hh"
+#include "BKE_idtype.h"
+#include "BKE_mesh.h"
+#include "BKE_pointcloud.h"
+#include "BKE_spline.hh"
+
+namespace blender::bke::tests {
+
+class GeometrySetBakeTest : public testing::Test {
+ protected:
+  std::string filepath_;
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    BKE_tempdir_init("");
+    filepath_ = std::string(BKE_tempdir_session()) + "geometry_set_bake_test.bgeo";
+  }
+
+  void TearDown() override
+  {
+    BLI_delete(filepath_.c_str(), false, false);
+  }
+
+  std::optional<GeometrySet> write_and_read(const GeometrySet &geometry_set)
+  {
+    EXPECT_TRUE(geometry_set_bake_write(geometry_set, filepath_.c_str()));
+    return geometry_set_bake_read(
+        filepath_.c_str(),
+        [](short UNUSED(id_code), StringRef UNUSED(name), StringRef UNUSED(library_path)) -> ID * {
+          return nullptr;
+        });
+  }
+};
+
+static GeometrySet create_point_cloud(const int size)
+{
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(size);
+  for (const int i : IndexRange(size)) {
+    copy_v3_fl3(pointcloud->co[i], float(i), 0.0f, 0.0f);
+  }
+  GeometrySet geometry_set = GeometrySet::create_with_pointcloud(pointcloud);
+  OutputAttribute_Typed<float> attribute =
+      geometry_set.get_component_for_write<PointCloudComponent>()
+          .attribute_try_get_for_output_only<float>("test", ATTR_DOMAIN_POINT);
+  for (const int i : IndexRange(size)) {
+    attribute->set(i, i * 2.0f);
+  }
+  attribute.save();
+  return geometry_set;
+}
+
+TEST_F(GeometrySetBakeTest, Empty)
+{
+  std::optional<GeometrySet> result = this->write_and_read(GeometrySet());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(result->is_empty());
+}
+
+TEST_F(GeometrySetBakeTest, PointCloud)
+{
+  std::optional<GeometrySet> result = this->write_and_read(create_point_cloud(100));
+  ASSERT_TRUE(result.has_value());
+  const PointCloudComponent &component = *result->get_component_for_read<PointCloudComponent>();
+  EXPECT_EQ(component.attribute_domain_size(ATTR_DOMAIN_POINT), 100);
+  const VArray<float3> positions = component.attribute_get_for_read<float3>(
+      "position", ATTR_DOMAIN_POINT, float3(0));
+  EXPECT_EQ(positions[42], float3(42.0f, 0.0f, 0.0f));
+  const VArray<float> test = component.attribute_get_for_read<float>(
+      "test", ATTR_DOMAIN_POINT, 0.0f);
+  EXPECT_EQ(test[42], 84.0f);
+}
+
+TEST_F(GeometrySetBakeTest, Mesh)
+{
+  Mesh *mesh = BKE_mesh_new_nomain(4, 0, 0, 4, 1);
+  for (const int i : IndexRange(4)) {
+    copy_v3_fl3(mesh->mvert[i].co, float(i % 2), float(i / 2), 0.0f);
+    mesh->mloop[i].v = i;
+    mesh->mloop[i].e = i;
+  }
+  mesh->mpoly[0].totloop = 4;
+  mesh->mpoly[0].mat_nr = 1;
+  BKE_mesh_calc_edges(mesh, false, false);
+
+  std::optional<GeometrySet> result = this->write_and_read(GeometrySet::create_with_mesh(mesh));
+  ASSERT_TRUE(result.has_value());
+  const Mesh *result_mesh = result->get_mesh_for_read();
+  ASSERT_NE(result_mesh, nullptr);
+  EXPECT_EQ(result_mesh->totvert, 4);
+  EXPECT_EQ(result_mesh->totedge, 4);
+  EXPECT_EQ(result_mesh->totpoly, 1);
+  EXPECT_EQ(result_mesh->mloop[3].v, 3);
+  EXPECT_EQ(result_mesh->mpoly[0].mat_nr, 1);
+  EXPECT_EQ(float3(result_mesh->mvert[3].co), float3(1.0f, 1.0f, 0.0f));
+}
+
+TEST_F(GeometrySetBakeTest, MeshInvalidIndices)
+{
+  Mesh *mesh = BKE_mesh_new_nomain(4, 0, 0, 4, 1);
+  for (const int i : IndexRange(4)) {
+    mesh->mloop[i].v = i;
+    mesh->mloop[i].e = i;
+  }
+  mesh->mpoly[0].totloop = 4;
+  BKE_mesh_calc_edges(mesh, false, false);
+  mesh->medge[2].v2 = 4;
+
+  EXPECT_FALSE(this->write_and_read(GeometrySet::create_with_mesh(mesh)).has_value());
+}
+
+TEST_F(GeometrySetBakeTest, Curve)
+{
+  std::unique_ptr<CurveEval> curve = std::make_unique<CurveEval>();
+  for (const int i : IndexRange(2)) {
+    std::unique_ptr<BezierSpline> spline = std::make_unique<BezierSpline>();
+    spline->resize(10);
+    spline->set_cyclic(i == 1);
+    for (const int j : IndexRange(10)) {
+      spline->positions()[j] = {float(i * 10 + j), 0.0f, 0.0f};
+    }
+    spline->radii().fill(1.0f);
+    spline->tilts().fill(0.0f);
+    spline->handle_types_left().fill(BezierSpline::HandleType::Vector);
+    spline->handle_types_right().fill(BezierSpline::HandleType::Vector);
+    spline->attributes.reallocate(10);
+    spline->attributes.create("weight", CD_PROP_FLOAT);
+    spline->attributes.get_for_write("weight")->typed<float>().fill(float(i));
+    curve->add_spline(std::move(spline));
+  }
+  curve->attributes.reallocate(2);
+
+  std::optional<GeometrySet> result = this->write_and_read(
+      GeometrySet::create_with_curve(curve.release()));
+  ASSERT_TRUE(result.has_value());
+  const CurveEval *result_curve = result->get_curve_for_read();
+  ASSERT_NE(result_curve, nullptr);
+  ASSERT_EQ(result_curve->splines().size(), 2);
+  EXPECT_TRUE(result_curve->splines()[1]->is_cyclic());
+  EXPECT_EQ(result_curve->splines()[1]->positions()[3], float3(13.0f, 0.0f, 0.0f));
+  EXPECT_EQ(result_curve->splines()[1]->type(), Spline::Type::Bezier);
+  EXPECT_EQ(result_curve->splines()[1]->attributes.get_for_read("weight")->typed<float>()[0],
+            1.0f);
+}
+
+TEST_F(GeometrySetBakeTest, Instances)
+{
+  GeometrySet geometry_set;
+  InstancesComponent &instances = geometry_set.get_component_for_write<InstancesComponent>();
+  const int handle = instances.add_reference(create_point_cloud(10));
+  instances.add_instance(handle, float4x4::from_location({1.0f, 2.0f, 3.0f}));
+  instances.add_instance(handle, float4x4::identity());
+  instances.instance_ids_ensure()[1] = 7;
+
+  std::optional<GeometrySet> result = this->write_and_read(geometry_set);
+  ASSERT_TRUE(result.has_value());
+  const InstancesComponent &result_instances =
+      *result->get_component_for_read<InstancesComponent>();
+  ASSERT_EQ(result_instances.instances_amount(), 2);
+  ASSERT_EQ(result_instances.references_amount(), 1);
+  EXPECT_EQ(result_instances.instance_transforms()[0].translation(), float3(1.0f, 2.0f, 3.0f));
+  EXPECT_EQ(result_instances.instance_ids()[1], 7);
+  const InstanceReference &reference = result_instances.references()[0];
+  ASSERT_EQ(reference.type(), InstanceReference::Type::GeometrySet);
+  EXPECT_TRUE(reference.geometry_set().has<PointCloudComponent>());
+}
+
+TEST_F(GeometrySetBakeTest, InvalidFile)
+{
+  FILE *file = BLI_fopen(filepath_.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  fputs("BGEOBAKE but not really", file);
+  fclose(file);
+
+  EXPECT_FALSE(geometry_set_bake_read(filepath_.c_str(), [](short, StringRef, StringRef) -> ID * {
+                 return nullptr;
+               }).has_value());
+  EXPECT_FALSE(
+      geometry_set_bake_read("", [](short, StringRef, StringRef) -> ID * { return nullptr; })
+          .has_value());
+}
+
+}  // namespace blender::bke::tests
@@ -14,6 +14,8 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "BLI_task.hh"
+
 #include "BKE_collection.h"
 #include "BKE_geometry_set_instances.hh"
 #include "BKE_material.h"
@@ -203,6 +205,10 @@ void geometry_set_gather_instances_attribute_info(Span<GeometryInstanceGroup> se
             if (attribute_id.is_named() && ignored_attributes.contains(attribute_id.name())) {
               return true;
             }
+            if (!attribute_id.should_be_kept()) {
+              /* Anonymous attributes without strong references can't be used anymore. */
+              return true;
+            }
             auto add_info = [&](AttributeKind *attribute_kind) {
               attribute_kind->domain = meta_data.domain;
               attribute_kind->data_type = meta_data.data_type;
@@ -220,6 +226,77 @@ void geometry_set_gather_instances_attribute_info(Span<GeometryInstanceGroup> se
   }
 }
 
+/**
+ * The data needed to copy one instance of a mesh into the realized mesh. The offsets of all
+ * instances are computed before copying, so that the instances can be copied in parallel.
+ */
+struct MeshRealizeTask {
+  const Mesh *mesh;
+  float4x4 transform;
+  int material_map_index;
+  int vert_offset;
+  int edge_offset;
+  int loop_offset;
+  int poly_offset;
+};
+
+static void realize_mesh_instance(const MeshRealizeTask &task,
+                                  Span<int> material_index_map,
+                                  Mesh &new_mesh)
+{
+  const Mesh &mesh = *task.mesh;
+  const float4x4 &transform = task.transform;
+  const int vert_offset = task.vert_offset;
+  const int edge_offset = task.edge_offset;
+  const int loop_offset = task.loop_offset;
+  const int poly_offset = task.poly_offset;
+
+  threading::parallel_for(IndexRange(mesh.totvert), 2048, [&](IndexRange range) {
+    for (const int i : range) {
+      const MVert &old_vert = mesh.mvert[i];
+      MVert &new_vert = new_mesh.mvert[vert_offset + i];
+
+      new_vert = old_vert;
+
+      const float3 new_position = transform * float3(old_vert.co);
+      copy_v3_v3(new_vert.co, new_position);
+    }
+  });
+  threading::parallel_for(IndexRange(mesh.totedge), 2048, [&](IndexRange range) {
+    for (const int i : range) {
+      const MEdge &old_edge = mesh.medge[i];
+      MEdge &new_edge = new_mesh.medge[edge_offset + i];
+      new_edge = old_edge;
+      new_edge.v1 += vert_offset;
+      new_edge.v2 += vert_offset;
+    }
+  });
+  threading::parallel_for(IndexRange(mesh.totloop), 2048, [&](IndexRange range) {
+    for (const int i : range) {
+      const MLoop &old_loop = mesh.mloop[i];
+      MLoop &new_loop = new_mesh.mloop[loop_offset + i];
+      new_loop = old_loop;
+      new_loop.v += vert_offset;
+      new_loop.e += edge_offset;
+    }
+  });
+  threading::parallel_for(IndexRange(mesh.totpoly), 2048, [&](IndexRange range) {
+    for (const int i : range) {
+      const MPoly &old_poly = mesh.mpoly[i];
+      MPoly &new_poly = new_mesh.mpoly[poly_offset + i];
+      new_poly = old_poly;
+      new_poly.loopstart += loop_offset;
+      if (old_poly.mat_nr >= 0 && old_poly.mat_nr < mesh.totcol) {
+        new_poly.mat_nr = material_index_map[new_poly.mat_nr];
+      }
+      else {
+        /* The material index was invalid before. */
+        new_poly.mat_nr = 0;
+      }
+    }
+  });
+}
+
 static Mesh *join_mesh_topology_and_builtin_attributes(Span<GeometryInstanceGroup> set_groups)
 {
   int totverts = 0;
@@ -276,6 +353,9 @@ static Mesh *join_mesh_topology_and_builtin_attributes(Span<GeometryInstanceGrou
   new_mesh->runtime.cd_dirty_edge = cd_dirty_edge;
   new_mesh->runtime.cd_dirty_loop = cd_dirty_loop;
 
+  /* Compute where every instance is stored in the new mesh. */
+  Vector<Array<int>> material_index_maps;
+  Vector<MeshRealizeTask> tasks;
   int vert_offset = 0;
   int loop_offset = 0;
   int edge_offset = 0;
@@ -291,45 +371,16 @@ static Mesh *join_mesh_topology_and_builtin_attributes(Span<GeometryInstanceGrou
         const int new_material_index = materials.index_of(material);
         material_index_map[i] = new_material_index;
       }
+      material_index_maps.append(std::move(material_index_map));
 
       for (const float4x4 &transform : set_group.transforms) {
-        for (const int i : IndexRange(mesh.totvert)) {
-          const MVert &old_vert = mesh.mvert[i];
-          MVert &new_vert = new_mesh->mvert[vert_offset + i];
-
-          new_vert = old_vert;
-
-          const float3 new_position = transform * float3(old_vert.co);
-          copy_v3_v3(new_vert.co, new_position);
-        }
-        for (const int i : IndexRange(mesh.totedge)) {
-          const MEdge &old_edge = mesh.medge[i];
-          MEdge &new_edge = new_mesh->medge[edge_offset + i];
-          new_edge = old_edge;
-          new_edge.v1 += vert_offset;
-          new_edge.v2 += vert_offset;
-        }
-        for (const int i : IndexRange(mesh.totloop)) {
-          const MLoop &old_loop = mesh.mloop[i];
-          MLoop &new_loop = new_mesh->mloop[loop_offset + i];
-          new_loop = old_loop;
-          new_loop.v += vert_offset;
-          new_loop.e += edge_offset;
-        }
-        for (const int i : IndexRange(mesh.totpoly)) {
-          const MPoly &old_poly = mesh.mpoly[i];
-          MPoly &new_poly = new_mesh->mpoly[poly_offset + i];
-          new_poly = old_poly;
-          new_poly.loopstart += loop_offset;
-          if (old_poly.mat_nr >= 0 && old_poly.mat_nr < mesh.totcol) {
-            new_poly.mat_nr = material_index_map[new_poly.mat_nr];
-          }
-          else {
-            /* The material index was invalid before. */
-            new_poly.mat_nr = 0;
-          }
-        }
-
+        tasks.append({&mesh,
+                      transform,
+                      int(material_index_maps.size() - 1),
+                      vert_offset,
+                      edge_offset,
+                      loop_offset,
+                      poly_offset});
         vert_offset += mesh.totvert;
         loop_offset += mesh.totloop;
         edge_offset += mesh.totedge;
@@ -338,6 +389,13 @@ static Mesh *join_mesh_topology_and_builtin_attributes(Span<GeometryInstanceGrou
     }
   }
 
+  threading::parallel_for(tasks.index_range(), 16, [&](IndexRange range) {
+    for (const int i : range) {
+      const MeshRealizeTask &task = tasks[i];
+      realize_mesh_instance(task, material_index_maps[task.material_map_index], *new_mesh);
+    }
+  });
+
   /* A possible optimization is to only tag the normals dirty when there are transforms that change
    * normals. */
   BKE_mesh_normals_tag_dirty(new_mesh);
@@ -345,6 +403,13 @@ static Mesh *join_mesh_topology_and_builtin_attributes(Span<GeometryInstanceGrou
   return new_mesh;
 }
 
+/** A source attribute array and where it is copied to in the joined attribute. */
+struct AttributeCopyTask {
+  const void *src;
+  int size;
+  int dst_offset;
+};
+
 static void join_attributes(Span<GeometryInstanceGroup> set_groups,
                             Span<GeometryComponentType> component_types,
                             const Map<AttributeIDRef, AttributeKind> &attribute_info,
@@ -367,6 +432,9 @@ static void join_attributes(Span<GeometryInstanceGroup> set_groups,
 
     fn::GVMutableArray_GSpan dst_span{write_attribute.varray};
 
+    /* Materialize every source attribute once, even if it has many instances. */
+    Vector<std::unique_ptr<fn::GVArray_GSpan>> src_spans;
+    Vector<AttributeCopyTask> tasks;
     int offset = 0;
     for (const GeometryInstanceGroup &set_group : set_groups) {
       const GeometrySet &set = set_group.geometry_set;
@@ -381,11 +449,10 @@ static void join_attributes(Span<GeometryInstanceGroup> set_groups,
               attribute_id, domain_output, data_type_output);
 
           if (source_attribute) {
-            fn::GVArray_GSpan src_span{source_attribute};
-            const void *src_buffer = src_span.data();
+            src_spans.append(std::make_unique<fn::GVArray_GSpan>(std::move(source_attribute)));
+            const void *src_buffer = src_spans.last()->data();
             for (const int UNUSED(i) : set_group.transforms.index_range()) {
-              void *dst_buffer = dst_span[offset];
-              cpp_type->copy_assign_n(src_buffer, dst_buffer, domain_size);
+              tasks.append({src_buffer, domain_size, offset});
               offset += domain_size;
             }
           }
@@ -396,19 +463,33 @@ static void join_attributes(Span<GeometryInstanceGroup> set_groups,
       }
     }
 
+    threading::parallel_for(tasks.index_range(), 64, [&](IndexRange range) {
+      for (const int i : range) {
+        const AttributeCopyTask &task = tasks[i];
+        cpp_type->copy_assign_n(task.src, dst_span[task.dst_offset], task.size);
+      }
+    });
+
     dst_span.save();
   }
 }
 
 static PointCloud *join_pointcloud_position_attribute(Span<GeometryInstanceGroup> set_groups)
 {
-  /* Count the total number of points. */
+  /* Count the total number of points and where every instance starts in the new point cloud. */
+  Vector<std::pair<const PointCloud *, const float4x4 *>> instances;
+  Vector<int> offsets;
   int totpoint = 0;
   for (const GeometryInstanceGroup &set_group : set_groups) {
     const GeometrySet &set = set_group.geometry_set;
-    if (set.has<PointCloudComponent>()) {
-      const PointCloudComponent &component = *set.get_component_for_read<PointCloudComponent>();
-      totpoint += component.attribute_domain_size(ATTR_DOMAIN_POINT);
+    const PointCloud *pointcloud = set.get_pointcloud_for_read();
+    if (pointcloud == nullptr) {
+      continue;
+    }
+    for (const float4x4 &transform : set_group.transforms) {
+      instances.append({pointcloud, &transform});
+      offsets.append(totpoint);
+      totpoint += pointcloud->totpoint;
     }
   }
   if (totpoint == 0) {
@@ -419,27 +500,25 @@ static PointCloud *join_pointcloud_position_attribute(Span<GeometryInstanceGroup
   MutableSpan new_positions{(float3 *)new_pointcloud->co, new_pointcloud->totpoint};
 
   /* Transform each instance's point locations into the new point cloud. */
-  int offset = 0;
-  for (const GeometryInstanceGroup &set_group : set_groups) {
-    const GeometrySet &set = set_group.geometry_set;
-    const PointCloud *pointcloud = set.get_pointcloud_for_read();
-    if (pointcloud == nullptr) {
-      continue;
-    }
-    for (const float4x4 &transform : set_group.transforms) {
-      for (const int i : IndexRange(pointcloud->totpoint)) {
-        new_positions[offset + i] = transform * float3(pointcloud->co[i]);
-      }
-      offset += pointcloud->totpoint;
+  threading::parallel_for(instances.index_range(), 16, [&](IndexRange instances_range) {
+    for (const int instance_index : instances_range) {
+      const PointCloud &pointcloud = *instances[instance_index].first;
+      const float4x4 &transform = *instances[instance_index].second;
+      const int offset = offsets[instance_index];
+      threading::parallel_for(IndexRange(pointcloud.totpoint), 2048, [&](IndexRange range) {
+        for (const int i : range) {
+          new_positions[offset + i] = transform * float3(pointcloud.co[i]);
+        }
+      });
     }
-  }
+  });
 
   return new_pointcloud;
 }
 
 static CurveEval *join_curve_splines_and_builtin_attributes(Span<GeometryInstanceGroup> set_groups)
 {
-  Vector<SplinePtr> new_splines;
+  Vector<std::pair<const Spline *, const float4x4 *>> sources;
   for (const GeometryInstanceGroup &set_group : set_groups) {
     const GeometrySet &set = set_group.geometry_set;
     if (!set.has_curve()) {
@@ -449,22 +528,26 @@ static CurveEval *join_curve_splines_and_builtin_attributes(Span<GeometryInstanc
     const CurveEval &source_curve = *set.get_curve_for_read();
     for (const SplinePtr &source_spline : source_curve.splines()) {
       for (const float4x4 &transform : set_group.transforms) {
-        SplinePtr new_spline = source_spline->copy_without_attributes();
-        new_spline->transform(transform);
-        new_splines.append(std::move(new_spline));
+        sources.append({source_spline.get(), &transform});
       }
     }
   }
-  if (new_splines.is_empty()) {
+  if (sources.is_empty()) {
     return nullptr;
   }
 
   CurveEval *new_curve = new CurveEval();
-  for (SplinePtr &new_spline : new_splines) {
-    new_curve->add_spline(std::move(new_spline));
-  }
+  new_curve->resize(sources.size());
+  MutableSpan<SplinePtr> new_splines = new_curve->splines();
+
+  threading::parallel_for(sources.index_range(), 128, [&](IndexRange range) {
+    for (const int i : range) {
+      SplinePtr new_spline = sources[i].first->copy_without_attributes();
+      new_spline->transform(*sources[i].second);
+      new_splines[i] = std::move(new_spline);
+    }
+  });
 
-  new_curve->attributes.reallocate(new_curve->splines().size());
   return new_curve;
 }
 
@@ -5989,6 +5989,8 @@ void BKE_node_system_init(void)
 
 void BKE_node_system_exit(void)
 {
+  MOD_nodes_free_cache();
+
   if (nodetypes_hash) {
     NODE_TYPES_BEGIN (nt) {
       if (nt->rna_ext.free) {
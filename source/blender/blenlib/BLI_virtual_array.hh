@@ -1172,4 +1172,44 @@ inline void devirtualize_varray2(const VArray<T1> &varray1,
   func(varray1, varray2);
 }
 
+/**
+ * Same as `devirtualize_varray2`, but devirtualizes three virtual arrays at the same time. Only the
+ * case in which every virtual array is a span or a single value is optimized. All of those
+ * combinations are common in multi-function procedures, where intermediate values are stored in
+ * spans and unconnected inputs are single values.
+ */
+template<typename T1, typename T2, typename T3, typename Func>
+inline void devirtualize_varray3(const VArray<T1> &varray1,
+                                 const VArray<T2> &varray2,
+                                 const VArray<T3> &varray3,
+                                 const Func &func,
+                                 bool enable = true)
+{
+  auto is_span_or_single = [](const auto &varray) {
+    return varray.is_span() || varray.is_single();
+  };
+  auto devirtualize_span_or_single = [](const auto &varray, const auto &fn) {
+    if (varray.is_single()) {
+      fn(SingleAsSpan(varray));
+    }
+    else {
+      fn(varray.get_internal_span());
+    }
+  };
+
+  /* Support disabling the devirtualization to simplify benchmarking. */
+  if (enable) {
+    if (is_span_or_single(varray1) && is_span_or_single(varray2) && is_span_or_single(varray3)) {
+      devirtualize_span_or_single(varray1, [&](const auto &devi1) {
+        devirtualize_span_or_single(varray2, [&](const auto &devi2) {
+          devirtualize_span_or_single(varray3,
+                                      [&](const auto &devi3) { func(devi1, devi2, devi3); });
+        });
+      });
+      return;
+    }
+  }
+  func(varray1, varray2, varray3);
+}
+
 }  // namespace blender
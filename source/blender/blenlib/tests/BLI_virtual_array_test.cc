@@ -180,4 +180,43 @@ TEST(virtual_array, MutableToImmutable)
   }
 }
 
+TEST(virtual_array, Devirtualize3)
+{
+  std::array<int, 4> array = {1, 2, 3, 4};
+  VArray<int> span_varray = VArray<int>::ForSpan(array);
+  VArray<int> single_varray = VArray<int>::ForSingle(10, 4);
+  VArray<int> func_varray = VArray<int>::ForFunc(4, [](const int64_t i) { return int(i) * 2; });
+
+  auto sum = [](const VArray<int> &a, const VArray<int> &b, const VArray<int> &c) {
+    Array<int> result(4);
+    bool is_devirtualized = false;
+    devirtualize_varray3(a, b, c, [&](const auto &a_devi, const auto &b_devi, const auto &c_devi) {
+      is_devirtualized = !std::is_same_v<std::decay_t<decltype(a_devi)>, VArray<int>>;
+      for (const int64_t i : result.index_range()) {
+        result[i] = a_devi[i] + b_devi[i] + c_devi[i];
+      }
+    });
+    return std::make_pair(result, is_devirtualized);
+  };
+
+  {
+    auto [result, is_devirtualized] = sum(span_varray, span_varray, span_varray);
+    EXPECT_TRUE(is_devirtualized);
+    EXPECT_EQ(result[0], 3);
+    EXPECT_EQ(result[3], 12);
+  }
+  {
+    auto [result, is_devirtualized] = sum(span_varray, single_varray, span_varray);
+    EXPECT_TRUE(is_devirtualized);
+    EXPECT_EQ(result[0], 12);
+    EXPECT_EQ(result[3], 18);
+  }
+  {
+    auto [result, is_devirtualized] = sum(single_varray, span_varray, func_varray);
+    EXPECT_FALSE(is_devirtualized);
+    EXPECT_EQ(result[0], 11);
+    EXPECT_EQ(result[3], 20);
+  }
+}
+
 }  // namespace blender::tests
@@ -357,7 +357,7 @@ void COM_deinitialize(void);
  * \brief Clear all compositor caches. (Compositor system will still remain available).
  * To deinitialize the compositor use the COM_deinitialize method.
  */
-// void COM_clear_caches(void); // NOT YET WRITTEN
+void COM_clear_caches(void);
 
 #ifdef __cplusplus
 }
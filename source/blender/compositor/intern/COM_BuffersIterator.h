@@ -68,6 +68,28 @@ template<typename T> class BuffersIteratorBuilder {
       return ins_.size();
     }
 
+    /**
+     * Get stride between elements of an input. Zero for single element inputs.
+     */
+    int get_in_elem_stride(int input_index) const
+    {
+      BLI_assert(input_index < ins_.size());
+      return ins_[input_index].elem_stride;
+    }
+
+    int get_out_elem_stride() const
+    {
+      return out_elem_stride_;
+    }
+
+    /**
+     * Number of elements from the current one to the end of the current row.
+     */
+    int get_row_remaining() const
+    {
+      return x_end_ - x;
+    }
+
     /**
      * Has the end of the area been reached.
      */
@@ -96,6 +118,28 @@ template<typename T> class BuffersIteratorBuilder {
       }
     }
 
+    /**
+     * Go forward a number of elements of the current row, moving to the next row when its end is
+     * reached. Used to process several elements at once.
+     */
+    void skip(const int num_elems)
+    {
+      BLI_assert(num_elems > 0 && num_elems <= get_row_remaining());
+      out += (intptr_t)num_elems * out_elem_stride_;
+      for (In &in : ins_) {
+        in.in += (intptr_t)num_elems * in.elem_stride;
+      }
+      x += num_elems;
+      if (x == x_end_) {
+        x = x_start_;
+        y++;
+        out += out_rows_gap_;
+        for (In &in : ins_) {
+          in.in += in.rows_gap;
+        }
+      }
+    }
+
     Iterator &operator++()
     {
       this->next();
@@ -276,6 +276,21 @@ class CompositorContext {
     return (this->get_bnodetree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0;
   }
 
+  bool is_half_buffers_enabled() const
+  {
+    return (this->get_bnodetree()->flag & NTREE_COM_HALF_BUFFERS) != 0;
+  }
+
+  /**
+   * Whether operation results are kept in the #ResultCache for later executions. Final renders
+   * don't use the cache.
+   */
+  bool is_result_cache_enabled() const
+  {
+    return (this->get_bnodetree()->flag & NTREE_COM_RESULT_CACHE) && !this->is_rendering() &&
+           this->get_execution_model() == eExecutionModel::FullFrame;
+  }
+
   /**
    * \brief Get the render percentage as a factor.
    * The compositor uses a factor i.o. a percentage.
@@ -32,6 +32,13 @@ ExecutionModel::ExecutionModel(CompositorContext &context, Span<NodeOperation *>
                               viewer_border->ymin < viewer_border->ymax;
   border_.viewer_border = viewer_border;
 
+  const rctf *viewer_view_border = &node_tree->viewer_view_border;
+  border_.use_viewer_view_border = (node_tree->flag & NTREE_COM_VIEWER_VIEW_BORDER) &&
+                                   !context.is_rendering() &&
+                                   viewer_view_border->xmin < viewer_view_border->xmax &&
+                                   viewer_view_border->ymin < viewer_view_border->ymax;
+  border_.viewer_view_border = viewer_view_border;
+
   const RenderData *rd = context_.get_render_data();
   /* Case when cropping to render border happens is handled in
    * compositor output and render layer nodes. */
@@ -45,6 +45,9 @@ class ExecutionModel {
     const rctf *render_border;
     bool use_viewer_border;
     const rctf *viewer_border;
+    /** Part of the viewer visible in the node editor backdrop. */
+    bool use_viewer_view_border;
+    const rctf *viewer_view_border;
   } border_;
 
   /**
@@ -18,8 +18,20 @@
 
 #include "COM_FullFrameExecutionModel.h"
 
+#include <typeinfo>
+
 #include "BLT_translation.h"
 
+#include "BLI_hash_md5.h"
+#include "BLI_set.hh"
+#include "BLI_task.h"
+
+#include "BKE_camera.h"
+
+#include "DNA_camera_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
 #include "COM_Debug.h"
 #include "COM_ViewerOperation.h"
 #include "COM_WorkScheduler.h"
@@ -30,18 +42,55 @@
 
 namespace blender::compositor {
 
+/**
+ * Identifies the execution settings that operations use without them being part of the node
+ * settings.
+ */
+static ResultCacheKey compute_context_key(const CompositorContext &context)
+{
+  ResultCacheKeyBuilder key_builder;
+  key_builder.add(context.get_framenumber());
+  key_builder.add(context.get_quality());
+  key_builder.add(context.is_fast_calculation());
+  key_builder.add_string(context.get_view_name() ? context.get_view_name() : "");
+
+  const RenderData *rd = context.get_render_data();
+  key_builder.add(rd->xsch);
+  key_builder.add(rd->ysch);
+  key_builder.add(rd->size);
+  key_builder.add(rd->xasp);
+  key_builder.add(rd->yasp);
+
+  /* Defocus uses the scene camera when no scene is set in the node. */
+  const Scene *scene = context.get_scene();
+  key_builder.add(scene);
+  if (scene && scene->camera && scene->camera->type == OB_CAMERA) {
+    const Camera *camera = static_cast<const Camera *>(scene->camera->data);
+    key_builder.add(camera->lens);
+    key_builder.add(camera->sensor_x);
+    key_builder.add(camera->sensor_y);
+    key_builder.add(camera->sensor_fit);
+    key_builder.add(BKE_camera_object_dof_distance(scene->camera));
+  }
+  return key_builder.build();
+}
+
 FullFrameExecutionModel::FullFrameExecutionModel(CompositorContext &context,
                                                  SharedOperationBuffers &shared_buffers,
                                                  Span<NodeOperation *> operations)
     : ExecutionModel(context, operations),
       active_buffers_(shared_buffers),
-      num_operations_finished_(0)
+      num_operations_finished_(0),
+      use_result_cache_(context.is_result_cache_enabled())
 {
   priorities_.append(eCompositorPriority::High);
   if (!context.is_fast_calculation()) {
     priorities_.append(eCompositorPriority::Medium);
     priorities_.append(eCompositorPriority::Low);
   }
+  if (use_result_cache_) {
+    context_key_ = compute_context_key(context);
+  }
 }
 
 void FullFrameExecutionModel::execute(ExecutionSystem &exec_system)
@@ -117,12 +166,33 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
   constexpr int output_y = 0;
 
   const bool has_outputs = op->get_number_of_output_sockets() > 0;
+  const int op_offset_x = output_x - op->get_canvas().xmin;
+  const int op_offset_y = output_y - op->get_canvas().ymin;
+  Vector<rcti> areas = active_buffers_.get_areas_to_render(op, op_offset_x, op_offset_y);
+
+  std::optional<ResultCacheKey> result_key;
+  if (use_result_cache_ && has_outputs) {
+    result_key = get_result_key_from_inputs(op);
+    if (result_key && use_cached_result(op, *result_key, areas)) {
+      operation_finished(op);
+      return;
+    }
+  }
+
+  if (context_.is_half_buffers_enabled()) {
+    /* Reduce memory of the buffers that are not read by this operation before allocating its
+     * output buffer. */
+    const int num_inputs = op->get_number_of_input_sockets();
+    Vector<NodeOperation *> inputs;
+    for (int i = 0; i < num_inputs; i++) {
+      inputs.append(op->get_input_operation(i));
+    }
+    active_buffers_.store_buffers_as_half(inputs);
+  }
+
   MemoryBuffer *op_buf = has_outputs ? create_operation_buffer(op, output_x, output_y) : nullptr;
   if (op->get_width() > 0 && op->get_height() > 0) {
     Vector<MemoryBuffer *> input_bufs = get_input_buffers(op, output_x, output_y);
-    const int op_offset_x = output_x - op->get_canvas().xmin;
-    const int op_offset_y = output_y - op->get_canvas().ymin;
-    Vector<rcti> areas = active_buffers_.get_areas_to_render(op, op_offset_x, op_offset_y);
     op->render(op_buf, areas, input_bufs);
     DebugInfo::operation_rendered(op, op_buf);
 
@@ -130,6 +200,9 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
       delete buf;
     }
   }
+  if (use_result_cache_ && op_buf) {
+    op_buf = store_result(op, op_buf, result_key, areas);
+  }
   /* Even if operation has no resolution set the empty buffer. It will be clipped with a
    * TranslateOperation from convert resolutions if linked to an operation with resolution. */
   active_buffers_.set_rendered_buffer(op, std::unique_ptr<MemoryBuffer>(op_buf));
@@ -137,6 +210,148 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
   operation_finished(op);
 }
 
+/**
+ * Key of an operation result created from the settings of its node and the keys of its inputs.
+ * Returns nothing for results that can only be identified by their pixels, or when an input has
+ * no key.
+ */
+std::optional<ResultCacheKey> FullFrameExecutionModel::get_result_key_from_inputs(
+    NodeOperation *op)
+{
+  const int num_inputs = op->get_number_of_input_sockets();
+  if (num_inputs == 0 || op->get_flags().uses_external_data) {
+    return std::nullopt;
+  }
+
+  ResultCacheKeyBuilder key_builder;
+  key_builder.add(context_key_);
+  key_builder.add_string(typeid(*op).name());
+  const std::optional<ResultCacheKey> &node_key = op->get_node_key();
+  key_builder.add(node_key.has_value());
+  if (node_key) {
+    key_builder.add(*node_key);
+  }
+  key_builder.add(op->get_canvas());
+  key_builder.add(op->get_output_socket()->get_data_type());
+  for (int i = 0; i < num_inputs; i++) {
+    const ResultCacheKey *input_key = result_keys_.lookup_ptr(op->get_input_operation(i));
+    if (input_key == nullptr) {
+      return std::nullopt;
+    }
+    key_builder.add(*input_key);
+  }
+  return key_builder.build();
+}
+
+/**
+ * Sets the operation buffer from a previous execution, when the cached result has all the areas
+ * to render.
+ */
+bool FullFrameExecutionModel::use_cached_result(NodeOperation *op,
+                                                const ResultCacheKey &key,
+                                                Span<rcti> areas)
+{
+  std::shared_ptr<const CachedResult> result = ResultCache::get().lookup(key);
+  if (!result || !result->contains_areas(areas)) {
+    return false;
+  }
+
+  /* The buffer is owned by the cache, readers get a buffer that doesn't own its data. */
+  MemoryBuffer *buffer = result->buffer.get();
+  active_buffers_.set_rendered_buffer(
+      op,
+      std::make_unique<MemoryBuffer>(buffer->get_buffer(),
+                                     buffer->get_num_channels(),
+                                     buffer->get_rect(),
+                                     buffer->is_a_single_elem()));
+  result_keys_.add_new(op, key);
+  used_results_.append(std::move(result));
+  return true;
+}
+
+struct RowDigestData {
+  const MemoryBuffer *buffer;
+  /** Row y coordinate and the area it belongs to. */
+  Span<std::pair<int, const rcti *>> rows;
+  MutableSpan<ResultCacheKey> digests;
+};
+
+static void compute_row_digest(void *__restrict userdata,
+                               const int index,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RowDigestData *data = static_cast<RowDigestData *>(userdata);
+  const auto [y, area] = data->rows[index];
+  const float *row = data->buffer->get_elem(area->xmin, y);
+  const size_t row_len = size_t(BLI_rcti_size_x(area)) * data->buffer->elem_stride;
+  BLI_hash_md5_buffer(
+      reinterpret_cast<const char *>(row), row_len * sizeof(float), data->digests[index].digest);
+}
+
+/**
+ * Identifies a result by the pixels of the rendered areas, for operations that depend on data
+ * outside of the node tree. The key changes when, for example, an image is painted.
+ */
+static ResultCacheKey compute_content_key(const MemoryBuffer &buffer, Span<rcti> areas)
+{
+  ResultCacheKeyBuilder key_builder;
+  key_builder.add(buffer.get_rect());
+  key_builder.add(buffer.get_num_channels());
+  if (buffer.is_a_single_elem()) {
+    key_builder.add_bytes(buffer.get_elem(0, 0), buffer.get_elem_bytes_len());
+    return key_builder.build();
+  }
+
+  Vector<std::pair<int, const rcti *>> rows;
+  for (const rcti &area : areas) {
+    for (int y = area.ymin; y < area.ymax; y++) {
+      rows.append({y, &area});
+    }
+  }
+  Array<ResultCacheKey> digests(rows.size());
+  RowDigestData data = {&buffer, rows, digests};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(0, rows.size(), &data, compute_row_digest, &settings);
+
+  key_builder.add_bytes(digests.data(), digests.size() * sizeof(ResultCacheKey));
+  return key_builder.build();
+}
+
+/**
+ * Adds the rendered buffer to the cache when it has a key, or computes its key from its pixels
+ * when the operation depends on external data. Returns the buffer to use for readers.
+ */
+MemoryBuffer *FullFrameExecutionModel::store_result(NodeOperation *op,
+                                                    MemoryBuffer *op_buf,
+                                                    const std::optional<ResultCacheKey> &key,
+                                                    Span<rcti> areas)
+{
+  if (op->get_width() == 0 || op->get_height() == 0) {
+    return op_buf;
+  }
+  /* Constant buffers are cheaper to identify by their value than to keep in the cache. */
+  if (!key || op_buf->is_a_single_elem()) {
+    const bool is_identified_by_content = op->get_number_of_input_sockets() == 0 ||
+                                          op->get_flags().uses_external_data ||
+                                          op_buf->is_a_single_elem();
+    if (is_identified_by_content) {
+      result_keys_.add_new(op, compute_content_key(*op_buf, areas));
+    }
+    return op_buf;
+  }
+
+  std::shared_ptr<const CachedResult> result = std::make_shared<const CachedResult>(
+      std::unique_ptr<MemoryBuffer>(op_buf), Vector<rcti>(areas));
+  MemoryBuffer *reader_buf = new MemoryBuffer(
+      op_buf->get_buffer(), op_buf->get_num_channels(), op_buf->get_rect());
+  ResultCache::get().add(*key, result);
+  result_keys_.add_new(op, *key);
+  used_results_.append(std::move(result));
+  return reader_buf;
+}
+
 /**
  * Render output operations in order of priority.
  */
@@ -163,29 +378,36 @@ void FullFrameExecutionModel::render_operations()
 }
 
 /**
- * Returns all dependencies from inputs to outputs. A dependency may be repeated when
- * several operations depend on it.
+ * Returns all dependencies from inputs to outputs, depth first. The inputs of each operation are
+ * rendered right before it, so that input buffers are read and disposed as soon as possible
+ * instead of rendering all operations furthest from the output first and keeping all their
+ * buffers at the same time.
  */
 static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation)
 {
-  /* Get dependencies from outputs to inputs. */
   Vector<NodeOperation *> dependencies;
-  Vector<NodeOperation *> next_outputs;
-  next_outputs.append(operation);
-  while (next_outputs.size() > 0) {
-    Vector<NodeOperation *> outputs(next_outputs);
-    next_outputs.clear();
-    for (NodeOperation *output : outputs) {
-      for (int i = 0; i < output->get_number_of_input_sockets(); i++) {
-        next_outputs.append(output->get_input_operation(i));
+  Set<NodeOperation *> visited;
+  /* Operations with the index of the next input to visit. */
+  Vector<std::pair<NodeOperation *, int>> stack;
+  stack.append({operation, 0});
+  visited.add(operation);
+  while (stack.size() > 0) {
+    auto &[op, next_input] = stack.last();
+    const int num_inputs = op->get_number_of_input_sockets();
+    if (next_input < num_inputs) {
+      NodeOperation *input = op->get_input_operation(next_input);
+      next_input++;
+      if (visited.add(input)) {
+        stack.append({input, 0});
       }
+      continue;
     }
-    dependencies.extend(next_outputs);
+    if (op != operation) {
+      dependencies.append(op);
+    }
+    stack.pop_last();
   }
 
-  /* Reverse to get dependencies from inputs to outputs. */
-  std::reverse(dependencies.begin(), dependencies.end());
-
   return dependencies;
 }
 
@@ -286,6 +508,20 @@ void FullFrameExecutionModel::get_output_render_area(NodeOperation *output_op, r
     r_area.ymin = canvas.ymin + norm_border->ymin * h;
     r_area.ymax = canvas.ymin + norm_border->ymax * h;
   }
+
+  if (border_.use_viewer_view_border && output_op->get_flags().is_viewer_operation) {
+    /* Only compute the part of the viewer visible in the node editor backdrop. */
+    const rctf *view_border = border_.viewer_view_border;
+    const int w = output_op->get_width();
+    const int h = output_op->get_height();
+    rcti view_area;
+    BLI_rcti_init(&view_area,
+                  canvas.xmin + floorf(view_border->xmin * w),
+                  canvas.xmin + ceilf(view_border->xmax * w),
+                  canvas.ymin + floorf(view_border->ymin * h),
+                  canvas.ymin + ceilf(view_border->ymax * h));
+    BLI_rcti_isect(&r_area, &view_area, &r_area);
+  }
 }
 
 void FullFrameExecutionModel::operation_finished(NodeOperation *operation)
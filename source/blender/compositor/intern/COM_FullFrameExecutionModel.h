@@ -18,10 +18,15 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
+
+#include "BLI_map.hh"
 #include "BLI_vector.hh"
 
 #include "COM_Enums.h"
 #include "COM_ExecutionModel.h"
+#include "COM_ResultCache.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
@@ -57,6 +62,28 @@ class FullFrameExecutionModel : public ExecutionModel {
    */
   Vector<eCompositorPriority> priorities_;
 
+  /**
+   * Whether results are looked up in and added to the #ResultCache.
+   */
+  bool use_result_cache_;
+
+  /**
+   * Identifies the execution settings all results depend on, like the current frame.
+   */
+  ResultCacheKey context_key_;
+
+  /**
+   * Keys of the results of rendered operations, used to create the keys of the operations that
+   * read them.
+   */
+  Map<NodeOperation *, ResultCacheKey> result_keys_;
+
+  /**
+   * Cached results used by this execution. Keeps their buffers alive when they are removed from
+   * the cache before the execution has finished.
+   */
+  Vector<std::shared_ptr<const CachedResult>> used_results_;
+
  public:
   FullFrameExecutionModel(CompositorContext &context,
                           SharedOperationBuffers &shared_buffers,
@@ -74,6 +101,13 @@ class FullFrameExecutionModel : public ExecutionModel {
   MemoryBuffer *create_operation_buffer(NodeOperation *op, const int output_x, const int output_y);
   void render_operation(NodeOperation *op);
 
+  std::optional<ResultCacheKey> get_result_key_from_inputs(NodeOperation *op);
+  bool use_cached_result(NodeOperation *op, const ResultCacheKey &key, Span<rcti> areas);
+  MemoryBuffer *store_result(NodeOperation *op,
+                             MemoryBuffer *op_buf,
+                             const std::optional<ResultCacheKey> &key,
+                             Span<rcti> areas);
+
   void operation_finished(NodeOperation *operation);
 
   void get_output_render_area(NodeOperation *output_op, rcti &r_area);
@@ -20,6 +20,8 @@
 
 #include "COM_MemoryProxy.h"
 
+#include "BLI_task.h"
+
 #include "IMB_colormanagement.h"
 #include "IMB_imbuf_types.h"
 
@@ -52,6 +54,7 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memory_proxy, const rcti &rect, MemoryBu
   num_channels_ = COM_data_type_num_channels(memory_proxy->get_data_type());
   buffer_ = (float *)MEM_mallocN_aligned(
       sizeof(float) * buffer_len() * num_channels_, 16, "COM_MemoryBuffer");
+  half_buffer_ = nullptr;
   owns_data_ = true;
   state_ = state;
   datatype_ = memory_proxy->get_data_type();
@@ -67,6 +70,7 @@ MemoryBuffer::MemoryBuffer(DataType data_type, const rcti &rect, bool is_a_singl
   num_channels_ = COM_data_type_num_channels(data_type);
   buffer_ = (float *)MEM_mallocN_aligned(
       sizeof(float) * buffer_len() * num_channels_, 16, "COM_MemoryBuffer");
+  half_buffer_ = nullptr;
   owns_data_ = true;
   state_ = MemoryBufferState::Temporary;
   datatype_ = data_type;
@@ -99,6 +103,7 @@ MemoryBuffer::MemoryBuffer(float *buffer,
   num_channels_ = num_channels;
   datatype_ = COM_num_channels_data_type(num_channels);
   buffer_ = buffer;
+  half_buffer_ = nullptr;
   owns_data_ = false;
   state_ = MemoryBufferState::Temporary;
 
@@ -198,6 +203,146 @@ MemoryBuffer::~MemoryBuffer()
     MEM_freeN(buffer_);
     buffer_ = nullptr;
   }
+  if (half_buffer_) {
+    MEM_freeN(half_buffer_);
+    half_buffer_ = nullptr;
+  }
+}
+
+/**
+ * Convert to half float, rounding to the nearest even value. Values that are too large become
+ * infinite and small values become denormals or zero.
+ */
+static uint16_t float_to_half(const float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint16_t sign = (bits >> 16) & 0x8000;
+  const uint32_t abs_bits = bits & 0x7fffffff;
+
+  if (abs_bits >= 0x7f800000) {
+    /* Infinity or NaN, keep NaN a NaN. */
+    return sign | 0x7c00 | (abs_bits > 0x7f800000 ? 0x200 : 0);
+  }
+  if (abs_bits >= 0x477ff000) {
+    /* Rounds to a value larger than the largest half (65504). */
+    return sign | 0x7c00;
+  }
+  if (abs_bits < 0x38800000) {
+    /* Smaller than the smallest normal half, 2^-14. */
+    if (abs_bits <= 0x33000000) {
+      return sign;
+    }
+    const uint32_t exponent = abs_bits >> 23;
+    const uint32_t mantissa = (abs_bits & 0x7fffff) | 0x800000;
+    const uint32_t shift = 126 - exponent;
+    uint32_t result = mantissa >> shift;
+    const uint32_t remainder = mantissa & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (result & 1))) {
+      result++;
+    }
+    return sign | result;
+  }
+
+  /* Rebias the exponent from 127 to 15, a carry of the rounding correctly increases it. */
+  uint32_t result = (abs_bits - 0x38000000) >> 13;
+  const uint32_t remainder = abs_bits & 0x1fff;
+  if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1))) {
+    result++;
+  }
+  return sign | result;
+}
+
+static float half_to_float(const uint16_t value)
+{
+  const uint32_t sign = uint32_t(value & 0x8000) << 16;
+  const uint32_t exponent = (value >> 10) & 0x1f;
+  const uint32_t mantissa = value & 0x3ff;
+
+  uint32_t bits;
+  if (exponent == 0x1f) {
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  }
+  else if (exponent != 0) {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  else {
+    /* Zero or denormal, a multiple of 2^-24. */
+    const float result = mantissa * 5.9604644775390625e-8f;
+    return sign ? -result : result;
+  }
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+struct HalfConversionData {
+  float *buffer;
+  uint16_t *half_buffer;
+  int64_t row_len;
+};
+
+void MemoryBuffer::store_as_half()
+{
+  if (!owns_data_ || is_a_single_elem_ || buffer_ == nullptr || is_stored_as_half()) {
+    return;
+  }
+  const int64_t row_len = int64_t(get_memory_width()) * num_channels_;
+  half_buffer_ = (uint16_t *)MEM_mallocN_aligned(
+      sizeof(uint16_t) * row_len * get_memory_height(), 16, "COM_MemoryBuffer half");
+
+  HalfConversionData data = {buffer_, half_buffer_, row_len};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(
+      0,
+      get_memory_height(),
+      &data,
+      [](void *__restrict userdata, const int y, const TaskParallelTLS *__restrict UNUSED(tls)) {
+        const HalfConversionData &data = *static_cast<HalfConversionData *>(userdata);
+        const float *src = data.buffer + y * data.row_len;
+        uint16_t *dst = data.half_buffer + y * data.row_len;
+        for (int64_t i = 0; i < data.row_len; i++) {
+          dst[i] = float_to_half(src[i]);
+        }
+      },
+      &settings);
+
+  MEM_freeN(buffer_);
+  buffer_ = nullptr;
+}
+
+void MemoryBuffer::restore_from_half()
+{
+  if (!is_stored_as_half()) {
+    return;
+  }
+  const int64_t row_len = int64_t(get_memory_width()) * num_channels_;
+  buffer_ = (float *)MEM_mallocN_aligned(
+      sizeof(float) * row_len * get_memory_height(), 16, "COM_MemoryBuffer");
+
+  HalfConversionData data = {buffer_, half_buffer_, row_len};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(
+      0,
+      get_memory_height(),
+      &data,
+      [](void *__restrict userdata, const int y, const TaskParallelTLS *__restrict UNUSED(tls)) {
+        const HalfConversionData &data = *static_cast<HalfConversionData *>(userdata);
+        const uint16_t *src = data.half_buffer + y * data.row_len;
+        float *dst = data.buffer + y * data.row_len;
+        for (int64_t i = 0; i < data.row_len; i++) {
+          dst[i] = half_to_float(src[i]);
+        }
+      },
+      &settings);
+
+  MEM_freeN(half_buffer_);
+  half_buffer_ = nullptr;
 }
 
 void MemoryBuffer::copy_from(const MemoryBuffer *src, const rcti &area)
@@ -99,6 +99,12 @@ class MemoryBuffer {
    */
   float *buffer_;
 
+  /**
+   * The data with half float precision while the buffer is stored as half, see #store_as_half.
+   * The float buffer is freed in the meantime.
+   */
+  uint16_t *half_buffer_;
+
   /**
    * \brief the number of channels of a single value in the buffer.
    * For value buffers this is 1, vector 3 and color 4
@@ -368,6 +374,7 @@ class MemoryBuffer {
    */
   float *get_buffer()
   {
+    BLI_assert(!is_stored_as_half());
     return buffer_;
   }
 
@@ -379,6 +386,19 @@ class MemoryBuffer {
 
   MemoryBuffer *inflate() const;
 
+  /**
+   * Convert the data to half float precision and free the float data, halving the memory usage
+   * of a buffer that is kept to be read later. The data can't be accessed until
+   * #restore_from_half is called. Buffers that don't own their data or are a single element are
+   * not converted.
+   */
+  void store_as_half();
+  void restore_from_half();
+  bool is_stored_as_half() const
+  {
+    return half_buffer_ != nullptr;
+  }
+
   inline void wrap_pixel(int &x, int &y, MemoryBufferExtend extend_x, MemoryBufferExtend extend_y)
   {
     const int w = get_width();
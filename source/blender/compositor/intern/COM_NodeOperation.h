@@ -31,6 +31,7 @@
 #include "COM_Enums.h"
 #include "COM_MemoryBuffer.h"
 #include "COM_MetaData.h"
+#include "COM_ResultCache.h"
 
 #include "clew.h"
 
@@ -249,6 +250,12 @@ struct NodeOperationFlags {
    */
   bool can_be_constant : 1;
 
+  /**
+   * Whether the result depends on data outside of the node tree, like images or movie clips. In
+   * the #ResultCache such results are identified by their pixels instead of their inputs.
+   */
+  bool uses_external_data : 1;
+
   NodeOperationFlags()
   {
     complex = false;
@@ -267,6 +274,7 @@ struct NodeOperationFlags {
     is_fullframe_operation = false;
     is_constant_operation = false;
     can_be_constant = false;
+    uses_external_data = false;
   }
 };
 
@@ -322,6 +330,12 @@ class NodeOperation {
   size_t params_hash_;
   bool is_hash_output_params_implemented_;
 
+  /**
+   * Identifies the settings of the node this operation was created from and the position of the
+   * operation among the node operations. Not set for operations that were not created by a node.
+   */
+  std::optional<ResultCacheKey> node_key_;
+
   /**
    * \brief the index of the input socket that will be used to determine the canvas
    */
@@ -395,6 +409,21 @@ class NodeOperation {
 
   std::optional<NodeOperationHash> generate_hash();
 
+  void set_node_key(const ResultCacheKey &key)
+  {
+    node_key_ = key;
+  }
+
+  const std::optional<ResultCacheKey> &get_node_key() const
+  {
+    return node_key_;
+  }
+
+  void set_uses_external_data()
+  {
+    flags_.uses_external_data = true;
+  }
+
   unsigned int get_number_of_input_sockets() const
   {
     return inputs_.size();
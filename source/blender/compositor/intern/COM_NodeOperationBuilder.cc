@@ -20,6 +20,12 @@
 
 #include "BLI_multi_value_map.hh"
 
+#include "DNA_color_types.h"
+
+#include "BKE_node.h"
+
+#include "MEM_guardedalloc.h"
+
 #include "COM_Converter.h"
 #include "COM_Debug.h"
 
@@ -40,11 +46,80 @@ namespace blender::compositor {
 NodeOperationBuilder::NodeOperationBuilder(const CompositorContext *context,
                                            bNodeTree *b_nodetree,
                                            ExecutionSystem *system)
-    : context_(context), exec_system_(system), current_node_(nullptr), active_viewer_(nullptr)
+    : context_(context),
+      exec_system_(system),
+      current_node_(nullptr),
+      current_node_num_operations_(0),
+      active_viewer_(nullptr)
 {
   graph_.from_bNodeTree(*context, b_nodetree);
 }
 
+static void add_socket_value_to_key(ResultCacheKeyBuilder &key_builder, const bNodeSocket *socket)
+{
+  if (socket != nullptr && socket->default_value != nullptr) {
+    key_builder.add_bytes(socket->default_value, MEM_allocN_len(socket->default_value));
+  }
+}
+
+static void add_curve_mapping_to_key(ResultCacheKeyBuilder &key_builder,
+                                     const CurveMapping &curve_mapping)
+{
+  /* Pointers and evaluation tables change for every localized node tree, only add the points. */
+  key_builder.add(curve_mapping.flag);
+  key_builder.add(curve_mapping.preset);
+  key_builder.add(curve_mapping.clipr);
+  key_builder.add(curve_mapping.black);
+  key_builder.add(curve_mapping.white);
+  key_builder.add(curve_mapping.tone);
+  for (const CurveMap &curve_map : curve_mapping.cm) {
+    key_builder.add(curve_map.totpoint);
+    key_builder.add(curve_map.ext_in);
+    key_builder.add(curve_map.ext_out);
+    if (curve_map.curve != nullptr) {
+      key_builder.add_bytes(curve_map.curve, sizeof(CurveMapPoint) * curve_map.totpoint);
+    }
+  }
+}
+
+/**
+ * Identifies the settings of a node, or returns nothing when the result of its operations depends
+ * on data that is not stored in the node tree.
+ */
+static std::optional<ResultCacheKey> compute_node_key(const Node &node)
+{
+  const bNode *b_node = node.get_bnode();
+  const char *storagename = b_node->typeinfo->storagename;
+  if (b_node->id != nullptr || STREQ(storagename, "NodeCryptomatte")) {
+    return std::nullopt;
+  }
+
+  ResultCacheKeyBuilder key_builder;
+  key_builder.add_string(b_node->idname);
+  key_builder.add(b_node->custom1);
+  key_builder.add(b_node->custom2);
+  key_builder.add(b_node->custom3);
+  key_builder.add(b_node->custom4);
+  if (b_node->storage != nullptr) {
+    if (STREQ(storagename, "CurveMapping")) {
+      add_curve_mapping_to_key(key_builder, *static_cast<const CurveMapping *>(b_node->storage));
+    }
+    else {
+      key_builder.add_bytes(b_node->storage, MEM_allocN_len(b_node->storage));
+    }
+  }
+  /* Which operations a node creates can depend on which inputs are linked. */
+  for (const NodeInput *input : node.get_input_sockets()) {
+    key_builder.add(input->is_linked());
+    add_socket_value_to_key(key_builder, input->get_bnode_socket());
+  }
+  /* Value and color nodes store their value in the output socket. */
+  for (const NodeOutput *output : node.get_output_sockets()) {
+    add_socket_value_to_key(key_builder, output->get_bnode_socket());
+  }
+  return key_builder.build();
+}
+
 void NodeOperationBuilder::convert_to_operations(ExecutionSystem *system)
 {
   /* interface handle for nodes */
@@ -52,12 +127,16 @@ void NodeOperationBuilder::convert_to_operations(ExecutionSystem *system)
 
   for (Node *node : graph_.nodes()) {
     current_node_ = node;
+    current_node_num_operations_ = 0;
+    current_node_key_ = context_->is_result_cache_enabled() ? compute_node_key(*node) :
+                                                              std::nullopt;
 
     DebugInfo::node_to_operations(node);
     node->convert_to_operations(converter, *context_);
   }
 
   current_node_ = nullptr;
+  current_node_key_ = std::nullopt;
 
   /* The input map constructed by nodes maps operation inputs to node inputs.
    * Inverting yields a map of node inputs to all connected operation inputs,
@@ -136,6 +215,16 @@ void NodeOperationBuilder::add_operation(NodeOperation *operation)
   operations_.append(operation);
   if (current_node_) {
     operation->set_name(current_node_->get_bnode()->name);
+    if (current_node_key_) {
+      ResultCacheKeyBuilder key_builder;
+      key_builder.add(*current_node_key_);
+      key_builder.add(current_node_num_operations_);
+      operation->set_node_key(key_builder.build());
+    }
+    else if (context_->is_result_cache_enabled()) {
+      operation->set_uses_external_data();
+    }
+    current_node_num_operations_++;
   }
   operation->set_execution_model(context_->get_execution_model());
   operation->set_execution_system(exec_system_);
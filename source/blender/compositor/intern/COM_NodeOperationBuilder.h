@@ -79,6 +79,9 @@ class NodeOperationBuilder {
   Map<NodeOutput *, NodeOperationOutput *> output_map_;
 
   Node *current_node_;
+  /** Settings of the current node, when results are cached. See #NodeOperation::get_node_key. */
+  std::optional<ResultCacheKey> current_node_key_;
+  int current_node_num_operations_;
 
   /** Operation that will be writing to the viewer image
    *  Only one operation can occupy this place at a time,
@@ -0,0 +1,152 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_ResultCache.h"
+#include "COM_MemoryBuffer.h"
+
+#include "BLI_hash_md5.h"
+#include "BLI_rect.h"
+
+namespace blender::compositor {
+
+/** Results are removed when the cache becomes larger than this. */
+static constexpr int64_t result_cache_memory_limit = int64_t(1024) * 1024 * 1024;
+
+void ResultCacheKeyBuilder::add_bytes(const void *data, const int64_t size)
+{
+  buffer_.extend(Span<char>(static_cast<const char *>(data), size));
+}
+
+void ResultCacheKeyBuilder::add_string(const char *str)
+{
+  /* Include the null terminator to separate consecutive strings. */
+  this->add_bytes(str, strlen(str) + 1);
+}
+
+ResultCacheKey ResultCacheKeyBuilder::build() const
+{
+  ResultCacheKey key;
+  BLI_hash_md5_buffer(buffer_.data(), buffer_.size(), key.digest);
+  return key;
+}
+
+CachedResult::CachedResult(std::unique_ptr<MemoryBuffer> buffer, Vector<rcti> rendered_areas)
+    : buffer(std::move(buffer)), rendered_areas(std::move(rendered_areas))
+{
+}
+
+CachedResult::~CachedResult() = default;
+
+/**
+ * Whether all given areas have been rendered. Like #SharedOperationBuffers::is_area_registered,
+ * areas only partially covered by several rendered areas are not detected.
+ */
+bool CachedResult::contains_areas(Span<rcti> areas) const
+{
+  for (const rcti &area : areas) {
+    bool is_contained = BLI_rcti_is_empty(&area);
+    for (const rcti &rendered_area : rendered_areas) {
+      if (BLI_rcti_inside_rcti(&rendered_area, &area)) {
+        is_contained = true;
+        break;
+      }
+    }
+    if (!is_contained) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int64_t CachedResult::memory_size() const
+{
+  const int64_t num_elems = buffer->is_a_single_elem() ?
+                                1 :
+                                int64_t(buffer->get_width()) * buffer->get_height();
+  return num_elems * buffer->get_num_channels() * sizeof(float);
+}
+
+ResultCache::ResultCache(const int64_t memory_limit) : memory_limit_(memory_limit)
+{
+}
+
+std::shared_ptr<const CachedResult> ResultCache::lookup(const ResultCacheKey &key)
+{
+  std::lock_guard lock{mutex_};
+  Entry *entry = entries_.lookup_ptr(key);
+  if (entry == nullptr) {
+    return {};
+  }
+  entry->last_use = ++use_counter_;
+  return entry->result;
+}
+
+void ResultCache::add(const ResultCacheKey &key, std::shared_ptr<const CachedResult> result)
+{
+  const int64_t memory_size = result->memory_size();
+  if (memory_size > memory_limit_) {
+    return;
+  }
+
+  std::lock_guard lock{mutex_};
+  Entry new_entry{std::move(result), ++use_counter_};
+  entries_.add_or_modify(
+      key,
+      [&](Entry *entry) {
+        new (entry) Entry(std::move(new_entry));
+        memory_size_ += memory_size;
+      },
+      [&](Entry *entry) {
+        memory_size_ += memory_size - entry->result->memory_size();
+        *entry = std::move(new_entry);
+      });
+  while (memory_size_ > memory_limit_) {
+    this->remove_least_recently_used();
+  }
+}
+
+void ResultCache::clear()
+{
+  std::lock_guard lock{mutex_};
+  entries_.clear();
+  memory_size_ = 0;
+}
+
+void ResultCache::remove_least_recently_used()
+{
+  BLI_assert(!entries_.is_empty());
+  const ResultCacheKey *oldest_key = nullptr;
+  uint64_t oldest_use = UINT64_MAX;
+  for (auto item : entries_.items()) {
+    if (item.value.last_use < oldest_use) {
+      oldest_key = &item.key;
+      oldest_use = item.value.last_use;
+    }
+  }
+  const ResultCacheKey key = *oldest_key;
+  memory_size_ -= entries_.lookup(key).result->memory_size();
+  entries_.remove(key);
+}
+
+ResultCache &ResultCache::get()
+{
+  static ResultCache cache{result_cache_memory_limit};
+  return cache;
+}
+
+}  // namespace blender::compositor
@@ -0,0 +1,129 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "BLI_map.hh"
+#include "BLI_span.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_vec_types.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+
+/**
+ * Identifies the result of an operation across executions. It is a digest of everything the
+ * result depends on: the settings of the node the operation was created from, the keys of its
+ * inputs and the execution settings.
+ */
+struct ResultCacheKey {
+  uint64_t digest[2] = {0, 0};
+
+  uint64_t hash() const
+  {
+    return digest[0];
+  }
+
+  friend bool operator==(const ResultCacheKey &a, const ResultCacheKey &b)
+  {
+    return a.digest[0] == b.digest[0] && a.digest[1] == b.digest[1];
+  }
+};
+
+/**
+ * Collects the bytes of all values that affect a result to create its #ResultCacheKey.
+ */
+class ResultCacheKeyBuilder {
+ private:
+  Vector<char> buffer_;
+
+ public:
+  void add_bytes(const void *data, int64_t size);
+  void add_string(const char *str);
+
+  template<typename T> void add(const T &value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    this->add_bytes(&value, sizeof(T));
+  }
+
+  ResultCacheKey build() const;
+};
+
+/**
+ * A rendered operation buffer. Only the rendered areas have valid pixels, so the result can only
+ * be used again when the operation needs to render areas inside of them.
+ */
+class CachedResult {
+ public:
+  std::unique_ptr<MemoryBuffer> buffer;
+  Vector<rcti> rendered_areas;
+
+  CachedResult(std::unique_ptr<MemoryBuffer> buffer, Vector<rcti> rendered_areas);
+  ~CachedResult();
+
+  bool contains_areas(Span<rcti> areas) const;
+  int64_t memory_size() const;
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:CachedResult")
+#endif
+};
+
+/**
+ * Keeps operation results between executions, so that editing a node only requires to compute
+ * again the operations that depend on it. When the memory limit is exceeded the least recently
+ * used results are removed.
+ */
+class ResultCache {
+ private:
+  struct Entry {
+    std::shared_ptr<const CachedResult> result;
+    uint64_t last_use;
+  };
+
+  std::mutex mutex_;
+  Map<ResultCacheKey, Entry> entries_;
+  uint64_t use_counter_ = 0;
+  int64_t memory_size_ = 0;
+  int64_t memory_limit_;
+
+ public:
+  ResultCache(int64_t memory_limit);
+
+  /** The shared pointer keeps the result alive even when the entry is removed. */
+  std::shared_ptr<const CachedResult> lookup(const ResultCacheKey &key);
+  void add(const ResultCacheKey &key, std::shared_ptr<const CachedResult> result);
+  void clear();
+
+  static ResultCache &get();
+
+ private:
+  void remove_least_recently_used();
+};
+
+}  // namespace blender::compositor
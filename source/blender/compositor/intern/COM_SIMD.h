@@ -0,0 +1,137 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_assert.h"
+#include "BLI_simd.h"
+#include "BLI_utildefines.h"
+
+#include "COM_BuffersIterator.h"
+
+/* SSE2 helpers for operations processing several elements at once. Callers must keep a scalar
+ * fallback for platforms without #BLI_HAVE_SSE2. */
+
+#ifdef BLI_HAVE_SSE2
+
+namespace blender::compositor {
+
+/** Number of single channel elements in an SSE register. */
+constexpr int SSE_NUM_ELEMS = 4;
+
+/**
+ * Iterates all elements of \a it. Runs of #SSE_NUM_ELEMS elements in the same row are processed
+ * by \a sse_fn and the remaining elements at the end of each row by \a scalar_fn. Both functions
+ * process the current elements of the iterator and must not advance it.
+ */
+template<typename SSEFn, typename ScalarFn>
+inline void iterate_sse(BuffersIterator<float> &it, const SSEFn &sse_fn, const ScalarFn &scalar_fn)
+{
+  while (!it.is_end()) {
+    if (it.get_row_remaining() >= SSE_NUM_ELEMS) {
+      sse_fn();
+      it.skip(SSE_NUM_ELEMS);
+    }
+    else {
+      scalar_fn();
+      it.next();
+    }
+  }
+}
+
+/**
+ * Load #SSE_NUM_ELEMS consecutive single channel elements. Single element buffers (zero stride)
+ * have their element in all lanes.
+ */
+BLI_INLINE __m128 load_values_sse(const float *elem, const int elem_stride)
+{
+  BLI_assert(ELEM(elem_stride, 0, 1));
+  return elem_stride == 0 ? _mm_set1_ps(*elem) : _mm_loadu_ps(elem);
+}
+
+/**
+ * Load the channels of #SSE_NUM_ELEMS consecutive RGBA elements, one register per channel.
+ * Single element buffers (zero stride) have their element in all lanes.
+ */
+BLI_INLINE void load_channels_sse(const float *elem, const int elem_stride, __m128 r_channels[4])
+{
+  BLI_assert(ELEM(elem_stride, 0, 4));
+  if (elem_stride == 0) {
+    for (int i = 0; i < 4; i++) {
+      r_channels[i] = _mm_set1_ps(elem[i]);
+    }
+    return;
+  }
+  __m128 elem0 = _mm_loadu_ps(elem);
+  __m128 elem1 = _mm_loadu_ps(elem + 4);
+  __m128 elem2 = _mm_loadu_ps(elem + 8);
+  __m128 elem3 = _mm_loadu_ps(elem + 12);
+  _MM_TRANSPOSE4_PS(elem0, elem1, elem2, elem3);
+  r_channels[0] = elem0;
+  r_channels[1] = elem1;
+  r_channels[2] = elem2;
+  r_channels[3] = elem3;
+}
+
+/**
+ * Store the channels of #SSE_NUM_ELEMS consecutive RGBA elements given one register per channel.
+ */
+BLI_INLINE void store_channels_sse(float *elem, const int elem_stride, const __m128 channels[4])
+{
+  BLI_assert(elem_stride == 4);
+  UNUSED_VARS_NDEBUG(elem_stride);
+  __m128 elem0 = channels[0];
+  __m128 elem1 = channels[1];
+  __m128 elem2 = channels[2];
+  __m128 elem3 = channels[3];
+  _MM_TRANSPOSE4_PS(elem0, elem1, elem2, elem3);
+  _mm_storeu_ps(elem, elem0);
+  _mm_storeu_ps(elem + 4, elem1);
+  _mm_storeu_ps(elem + 8, elem2);
+  _mm_storeu_ps(elem + 12, elem3);
+}
+
+/**
+ * Clamp all lanes like #CLAMP does, NaN values are kept.
+ */
+BLI_INLINE __m128 clamp_sse(const __m128 value, const float min, const float max)
+{
+  /* Min/max return their second operand when a lane is NaN. */
+  return _mm_min_ps(_mm_set1_ps(max), _mm_max_ps(_mm_set1_ps(min), value));
+}
+
+/**
+ * Combine the RGB lanes of \a rgb with the alpha lane of \a alpha.
+ */
+BLI_INLINE __m128 with_alpha_sse(const __m128 rgb, const __m128 alpha)
+{
+  const __m128 rgb_mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  return _mm_or_ps(_mm_and_ps(rgb_mask, rgb), _mm_andnot_ps(rgb_mask, alpha));
+}
+
+/**
+ * Absolute value of all lanes.
+ */
+BLI_INLINE __m128 abs_sse(const __m128 value)
+{
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+}
+
+}  // namespace blender::compositor
+
+#endif
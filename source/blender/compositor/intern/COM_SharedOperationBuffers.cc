@@ -110,12 +110,16 @@ void SharedOperationBuffers::set_rendered_buffer(NodeOperation *op,
 }
 
 /**
- * Get given operation rendered buffer.
+ * Get given operation rendered buffer. Buffers stored as half float are converted back first.
  */
 MemoryBuffer *SharedOperationBuffers::get_rendered_buffer(NodeOperation *op)
 {
   BLI_assert(is_operation_rendered(op));
-  return get_buffer_data(op).buffer.get();
+  MemoryBuffer *buffer = get_buffer_data(op).buffer.get();
+  if (buffer) {
+    buffer->restore_from_half();
+  }
+  return buffer;
 }
 
 /**
@@ -133,4 +137,18 @@ void SharedOperationBuffers::read_finished(NodeOperation *read_op)
   }
 }
 
+/**
+ * Stores the buffers that are waiting to be read with half float precision, except the buffers of
+ * given operations (usually the inputs of the operation rendered next).
+ */
+void SharedOperationBuffers::store_buffers_as_half(Span<NodeOperation *> except_ops)
+{
+  for (auto item : buffers_.items()) {
+    MemoryBuffer *buffer = item.value.buffer.get();
+    if (buffer && !buffer->is_stored_as_half() && !except_ops.contains(item.key)) {
+      buffer->store_as_half();
+    }
+  }
+}
+
 }  // namespace blender::compositor
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "BLI_map.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
 
 #include "DNA_vec_types.h"
@@ -63,6 +64,8 @@ class SharedOperationBuffers {
 
   void read_finished(NodeOperation *read_op);
 
+  void store_buffers_as_half(Span<NodeOperation *> except_ops);
+
  private:
   BufferData &get_buffer_data(NodeOperation *op);
 
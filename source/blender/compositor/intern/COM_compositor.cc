@@ -24,6 +24,7 @@
 #include "BKE_scene.h"
 
 #include "COM_ExecutionSystem.h"
+#include "COM_ResultCache.h"
 #include "COM_WorkScheduler.h"
 #include "COM_compositor.h"
 
@@ -85,6 +86,11 @@ void COM_execute(RenderData *render_data,
     return;
   }
 
+  if (!(node_tree->flag & NTREE_COM_RESULT_CACHE)) {
+    /* Free the results of previous executions when the cache has been disabled. */
+    blender::compositor::ResultCache::get().clear();
+  }
+
   compositor_init_node_previews(render_data, node_tree);
   compositor_reset_node_tree_status(node_tree);
 
@@ -118,8 +124,14 @@ void COM_execute(RenderData *render_data,
   BLI_mutex_unlock(&g_compositor.mutex);
 }
 
+void COM_clear_caches()
+{
+  blender::compositor::ResultCache::get().clear();
+}
+
 void COM_deinitialize()
 {
+  COM_clear_caches();
   if (g_compositor.is_initialized) {
     BLI_mutex_lock(&g_compositor.mutex);
     blender::compositor::WorkScheduler::deinitialize();
@@ -72,10 +72,18 @@ void AlphaOverKeyOperation::update_memory_buffer_row(PixelCursor &p)
       const float premul = value * over_color[3];
       const float mul = 1.0f - premul;
 
+#ifdef BLI_HAVE_SSE2
+      /* Alpha of the over color is multiplied by the factor only. */
+      const __m128 over_factor = _mm_setr_ps(premul, premul, premul, value);
+      const __m128 result = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(mul), _mm_loadu_ps(color1)),
+                                       _mm_mul_ps(over_factor, _mm_loadu_ps(over_color)));
+      _mm_storeu_ps(p.out, result);
+#else
       p.out[0] = (mul * color1[0]) + premul * over_color[0];
       p.out[1] = (mul * color1[1]) + premul * over_color[1];
       p.out[2] = (mul * color1[2]) + premul * over_color[2];
       p.out[3] = (mul * color1[3]) + value * over_color[3];
+#endif
     }
   }
 }
@@ -17,6 +17,7 @@
  */
 
 #include "COM_BrightnessOperation.h"
+#include "COM_SIMD.h"
 
 namespace blender::compositor {
 
@@ -120,10 +121,16 @@ void BrightnessOperation::update_memory_buffer_partial(MemoryBuffer *output,
     else {
       color = in_color;
     }
+#ifdef BLI_HAVE_SSE2
+    const __m128 color_sse = _mm_loadu_ps(color);
+    const __m128 result = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a), color_sse), _mm_set1_ps(b));
+    _mm_storeu_ps(it.out, with_alpha_sse(result, color_sse));
+#else
     it.out[0] = a * color[0] + b;
     it.out[1] = a * color[1] + b;
     it.out[2] = a * color[2] + b;
     it.out[3] = color[3];
+#endif
     if (use_premultiply_) {
       straight_to_premul_v4(it.out);
     }
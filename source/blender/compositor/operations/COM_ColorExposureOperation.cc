@@ -17,6 +17,7 @@
  */
 
 #include "COM_ColorExposureOperation.h"
+#include "COM_SIMD.h"
 
 namespace blender::compositor {
 
@@ -59,10 +60,16 @@ void ExposureOperation::update_memory_buffer_row(PixelCursor &p)
     const float *in_value = p.ins[0];
     const float *in_exposure = p.ins[1];
     const float exposure = pow(2, in_exposure[0]);
+#ifdef BLI_HAVE_SSE2
+    /* Alpha is multiplied by one to keep it unchanged. */
+    const __m128 multiplier = _mm_setr_ps(exposure, exposure, exposure, 1.0f);
+    _mm_storeu_ps(p.out, _mm_mul_ps(_mm_loadu_ps(in_value), multiplier));
+#else
     p.out[0] = in_value[0] * exposure;
     p.out[1] = in_value[1] * exposure;
     p.out[2] = in_value[2] * exposure;
     p.out[3] = in_value[3];
+#endif
   }
 }
 
@@ -17,6 +17,7 @@
  */
 
 #include "COM_ConvertOperation.h"
+#include "COM_SIMD.h"
 
 #include "BLI_color.hh"
 
@@ -73,10 +74,26 @@ void ConvertValueToColorOperation::execute_pixel_sampled(float output[4],
 
 void ConvertValueToColorOperation::update_memory_buffer_partial(BuffersIterator<float> &it)
 {
+#ifdef BLI_HAVE_SSE2
+  const int out_stride = it.get_out_elem_stride();
+  const int in_stride = it.get_in_elem_stride(0);
+  iterate_sse(
+      it,
+      [&]() {
+        const __m128 value = load_values_sse(it.in(0), in_stride);
+        const __m128 channels[4] = {value, value, value, _mm_set1_ps(1.0f)};
+        store_channels_sse(it.out, out_stride, channels);
+      },
+      [&]() {
+        it.out[0] = it.out[1] = it.out[2] = *it.in(0);
+        it.out[3] = 1.0f;
+      });
+#else
   for (; !it.is_end(); ++it) {
     it.out[0] = it.out[1] = it.out[2] = *it.in(0);
     it.out[3] = 1.0f;
   }
+#endif
 }
 
 /* ******** Color to Value ******** */
@@ -99,10 +116,27 @@ void ConvertColorToValueOperation::execute_pixel_sampled(float output[4],
 
 void ConvertColorToValueOperation::update_memory_buffer_partial(BuffersIterator<float> &it)
 {
+#ifdef BLI_HAVE_SSE2
+  BLI_assert(it.get_out_elem_stride() == 1);
+  const int in_stride = it.get_in_elem_stride(0);
+  iterate_sse(
+      it,
+      [&]() {
+        __m128 in[4];
+        load_channels_sse(it.in(0), in_stride, in);
+        const __m128 sum = _mm_add_ps(_mm_add_ps(in[0], in[1]), in[2]);
+        _mm_storeu_ps(it.out, _mm_div_ps(sum, _mm_set1_ps(3.0f)));
+      },
+      [&]() {
+        const float *in = it.in(0);
+        it.out[0] = (in[0] + in[1] + in[2]) / 3.0f;
+      });
+#else
   for (; !it.is_end(); ++it) {
     const float *in = it.in(0);
     it.out[0] = (in[0] + in[1] + in[2]) / 3.0f;
   }
+#endif
 }
 
 /* ******** Color to BW ******** */
@@ -125,9 +159,30 @@ void ConvertColorToBWOperation::execute_pixel_sampled(float output[4],
 
 void ConvertColorToBWOperation::update_memory_buffer_partial(BuffersIterator<float> &it)
 {
+#ifdef BLI_HAVE_SSE2
+  BLI_assert(it.get_out_elem_stride() == 1);
+  /* Luminance of the primaries are the luminance coefficients. */
+  const float primaries[3][3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+  const __m128 coefficients[3] = {_mm_set1_ps(IMB_colormanagement_get_luminance(primaries[0])),
+                                  _mm_set1_ps(IMB_colormanagement_get_luminance(primaries[1])),
+                                  _mm_set1_ps(IMB_colormanagement_get_luminance(primaries[2]))};
+  const int in_stride = it.get_in_elem_stride(0);
+  iterate_sse(
+      it,
+      [&]() {
+        __m128 in[4];
+        load_channels_sse(it.in(0), in_stride, in);
+        const __m128 luminance = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(coefficients[0], in[0]), _mm_mul_ps(coefficients[1], in[1])),
+            _mm_mul_ps(coefficients[2], in[2]));
+        _mm_storeu_ps(it.out, luminance);
+      },
+      [&]() { it.out[0] = IMB_colormanagement_get_luminance(it.in(0)); });
+#else
   for (; !it.is_end(); ++it) {
     it.out[0] = IMB_colormanagement_get_luminance(it.in(0));
   }
+#endif
 }
 
 /* ******** Color to Vector ******** */
@@ -526,9 +581,27 @@ void ConvertStraightToPremulOperation::execute_pixel_sampled(float output[4],
 
 void ConvertStraightToPremulOperation::update_memory_buffer_partial(BuffersIterator<float> &it)
 {
+#ifdef BLI_HAVE_SSE2
+  const int out_stride = it.get_out_elem_stride();
+  const int in_stride = it.get_in_elem_stride(0);
+  iterate_sse(
+      it,
+      [&]() {
+        __m128 color[4];
+        load_channels_sse(it.in(0), in_stride, color);
+        for (int i = 0; i < 3; i++) {
+          color[i] = _mm_mul_ps(color[i], color[3]);
+        }
+        store_channels_sse(it.out, out_stride, color);
+      },
+      [&]() {
+        copy_v4_v4(it.out, ColorSceneLinear4f<eAlpha::Straight>(it.in(0)).premultiply_alpha());
+      });
+#else
   for (; !it.is_end(); ++it) {
     copy_v4_v4(it.out, ColorSceneLinear4f<eAlpha::Straight>(it.in(0)).premultiply_alpha());
   }
+#endif
 }
 
 /* ******** Separate Channels ******** */
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "COM_MultiThreadedOperation.h"
+#include "COM_SIMD.h"
 
 namespace blender::compositor {
 
@@ -61,6 +62,16 @@ class MathBaseOperation : public MultiThreadedOperation {
     }
   }
 
+#ifdef BLI_HAVE_SSE2
+  __m128 clamp_when_enabled_sse(const __m128 values)
+  {
+    if (use_clamp_) {
+      return clamp_sse(values, 0.0f, 1.0f);
+    }
+    return values;
+  }
+#endif
+
  public:
   /**
    * Initialize the execution
@@ -90,15 +101,57 @@ class MathBaseOperation : public MultiThreadedOperation {
   virtual void update_memory_buffer_partial(BuffersIterator<float> &it) = 0;
 };
 
+#ifdef BLI_HAVE_SSE2
+/* SSE equivalents of the functors used by #MathFunctor2Operation. */
+template<typename T> BLI_INLINE __m128 math_functor_sse(std::plus<T>, __m128 a, __m128 b)
+{
+  return _mm_add_ps(a, b);
+}
+template<typename T> BLI_INLINE __m128 math_functor_sse(std::minus<T>, __m128 a, __m128 b)
+{
+  return _mm_sub_ps(a, b);
+}
+template<typename T> BLI_INLINE __m128 math_functor_sse(std::multiplies<T>, __m128 a, __m128 b)
+{
+  return _mm_mul_ps(a, b);
+}
+template<typename T> BLI_INLINE __m128 math_functor_sse(std::less<T>, __m128 a, __m128 b)
+{
+  return _mm_and_ps(_mm_cmplt_ps(a, b), _mm_set1_ps(1.0f));
+}
+template<typename T> BLI_INLINE __m128 math_functor_sse(std::greater<T>, __m128 a, __m128 b)
+{
+  return _mm_and_ps(_mm_cmpgt_ps(a, b), _mm_set1_ps(1.0f));
+}
+#endif
+
 template<template<typename> typename TFunctor>
 class MathFunctor2Operation : public MathBaseOperation {
   void update_memory_buffer_partial(BuffersIterator<float> &it) final
   {
     TFunctor functor;
+#ifdef BLI_HAVE_SSE2
+    BLI_assert(it.get_out_elem_stride() == 1);
+    const int in1_stride = it.get_in_elem_stride(0);
+    const int in2_stride = it.get_in_elem_stride(1);
+    iterate_sse(
+        it,
+        [&]() {
+          const __m128 result = math_functor_sse(functor,
+                                                 load_values_sse(it.in(0), in1_stride),
+                                                 load_values_sse(it.in(1), in2_stride));
+          _mm_storeu_ps(it.out, clamp_when_enabled_sse(result));
+        },
+        [&]() {
+          *it.out = functor(*it.in(0), *it.in(1));
+          clamp_when_enabled(it.out);
+        });
+#else
     for (; !it.is_end(); ++it) {
       *it.out = functor(*it.in(0), *it.in(1));
       clamp_when_enabled(it.out);
     }
+#endif
   }
 };
 
@@ -122,6 +122,17 @@ void MixBaseOperation::update_memory_buffer_partial(MemoryBuffer *output,
 
 void MixBaseOperation::update_memory_buffer_row(PixelCursor &p)
 {
+#ifdef BLI_HAVE_SSE2
+  while (p.out < p.row_end) {
+    const __m128 value = load_value_sse(p);
+    const __m128 value_m = _mm_sub_ps(_mm_set1_ps(1.0f), value);
+    const __m128 color1 = _mm_loadu_ps(p.color1);
+    const __m128 color2 = _mm_loadu_ps(p.color2);
+    const __m128 result = _mm_add_ps(_mm_mul_ps(value_m, color1), _mm_mul_ps(value, color2));
+    _mm_storeu_ps(p.out, with_alpha_sse(result, color1));
+    p.next();
+  }
+#else
   while (p.out < p.row_end) {
     float value = p.value[0];
     if (this->use_value_alpha_multiply()) {
@@ -134,6 +145,7 @@ void MixBaseOperation::update_memory_buffer_row(PixelCursor &p)
     p.out[3] = p.color1[3];
     p.next();
   }
+#endif
 }
 
 /* ******** Mix Add Operation ******** */
@@ -165,6 +177,16 @@ void MixAddOperation::execute_pixel_sampled(float output[4],
 
 void MixAddOperation::update_memory_buffer_row(PixelCursor &p)
 {
+#ifdef BLI_HAVE_SSE2
+  while (p.out < p.row_end) {
+    const __m128 value = load_value_sse(p);
+    const __m128 color1 = _mm_loadu_ps(p.color1);
+    const __m128 color2 = _mm_loadu_ps(p.color2);
+    const __m128 result = _mm_add_ps(color1, _mm_mul_ps(value, color2));
+    _mm_storeu_ps(p.out, clamp_if_needed_sse(with_alpha_sse(result, color1)));
+    p.next();
+  }
+#else
   while (p.out < p.row_end) {
     float value = p.value[0];
     if (this->use_value_alpha_multiply()) {
@@ -178,6 +200,7 @@ void MixAddOperation::update_memory_buffer_row(PixelCursor &p)
     clamp_if_needed(p.out);
     p.next();
   }
+#endif
 }
 
 /* ******** Mix Blend Operation ******** */
@@ -447,6 +470,18 @@ void MixDarkenOperation::execute_pixel_sampled(float output[4],
 
 void MixDarkenOperation::update_memory_buffer_row(PixelCursor &p)
 {
+#ifdef BLI_HAVE_SSE2
+  while (p.out < p.row_end) {
+    const __m128 value = load_value_sse(p);
+    const __m128 value_m = _mm_sub_ps(_mm_set1_ps(1.0f), value);
+    const __m128 color1 = _mm_loadu_ps(p.color1);
+    const __m128 color2 = _mm_loadu_ps(p.color2);
+    const __m128 darkest = _mm_min_ps(color1, color2);
+    const __m128 result = _mm_add_ps(_mm_mul_ps(darkest, value), _mm_mul_ps(color1, value_m));
+    _mm_storeu_ps(p.out, clamp_if_needed_sse(with_alpha_sse(result, color1)));
+    p.next();
+  }
+#else
   while (p.out < p.row_end) {
     float value = p.value[0];
     if (this->use_value_alpha_multiply()) {
@@ -461,6 +496,7 @@ void MixDarkenOperation::update_memory_buffer_row(PixelCursor &p)
     clamp_if_needed(p.out);
     p.next();
   }
+#endif
 }
 
 /* ******** Mix Difference Operation ******** */
@@ -493,6 +529,18 @@ void MixDifferenceOperation::execute_pixel_sampled(float output[4],
 
 void MixDifferenceOperation::update_memory_buffer_row(PixelCursor &p)
 {
+#ifdef BLI_HAVE_SSE2
+  while (p.out < p.row_end) {
+    const __m128 value = load_value_sse(p);
+    const __m128 value_m = _mm_sub_ps(_mm_set1_ps(1.0f), value);
+    const __m128 color1 = _mm_loadu_ps(p.color1);
+    const __m128 color2 = _mm_loadu_ps(p.color2);
+    const __m128 difference = abs_sse(_mm_sub_ps(color1, color2));
+    const __m128 result = _mm_add_ps(_mm_mul_ps(value_m, color1), _mm_mul_ps(value, difference));
+    _mm_storeu_ps(p.out, clamp_if_needed_sse(with_alpha_sse(result, color1)));
+    p.next();
+  }
+#else
   while (p.out < p.row_end) {
     float value = p.value[0];
     if (this->use_value_alpha_multiply()) {
@@ -507,6 +555,7 @@ void MixDifferenceOperation::update_memory_buffer_row(PixelCursor &p)
     clamp_if_needed(p.out);
     p.next();
   }
+#endif
 }
 
 /* ******** Mix Difference Operation ******** */
@@ -910,6 +959,16 @@ void MixLightenOperation::execute_pixel_sampled(float output[4],
 
 void MixLightenOperation::update_memory_buffer_row(PixelCursor &p)
 {
+#ifdef BLI_HAVE_SSE2
+  while (p.out < p.row_end) {
+    const __m128 value = load_value_sse(p);
+    const __m128 color1 = _mm_loadu_ps(p.color1);
+    const __m128 color2 = _mm_loadu_ps(p.color2);
+    const __m128 result = _mm_max_ps(_mm_mul_ps(value, color2), color1);
+    _mm_storeu_ps(p.out, clamp_if_needed_sse(with_alpha_sse(result, color1)));
+    p.next();
+  }
+#else
   while (p.out < p.row_end) {
     float value = p.value[0];
     if (this->use_value_alpha_multiply()) {
@@ -930,6 +989,7 @@ void MixLightenOperation::update_memory_buffer_row(PixelCursor &p)
     clamp_if_needed(p.out);
     p.next();
   }
+#endif
 }
 
 /* ******** Mix Linear Light Operation ******** */
@@ -1038,6 +1098,17 @@ void MixMultiplyOperation::execute_pixel_sampled(float output[4],
 
 void MixMultiplyOperation::update_memory_buffer_row(PixelCursor &p)
 {
+#ifdef BLI_HAVE_SSE2
+  while (p.out < p.row_end) {
+    const __m128 value = load_value_sse(p);
+    const __m128 value_m = _mm_sub_ps(_mm_set1_ps(1.0f), value);
+    const __m128 color1 = _mm_loadu_ps(p.color1);
+    const __m128 color2 = _mm_loadu_ps(p.color2);
+    const __m128 result = _mm_mul_ps(color1, _mm_add_ps(value_m, _mm_mul_ps(value, color2)));
+    _mm_storeu_ps(p.out, clamp_if_needed_sse(with_alpha_sse(result, color1)));
+    p.next();
+  }
+#else
   while (p.out < p.row_end) {
     float value = p.value[0];
     if (this->use_value_alpha_multiply()) {
@@ -1053,6 +1124,7 @@ void MixMultiplyOperation::update_memory_buffer_row(PixelCursor &p)
     clamp_if_needed(p.out);
     p.next();
   }
+#endif
 }
 
 /* ******** Mix Overlay Operation ******** */
@@ -1232,6 +1304,20 @@ void MixScreenOperation::execute_pixel_sampled(float output[4],
 
 void MixScreenOperation::update_memory_buffer_row(PixelCursor &p)
 {
+#ifdef BLI_HAVE_SSE2
+  while (p.out < p.row_end) {
+    const __m128 value = load_value_sse(p);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 value_m = _mm_sub_ps(one, value);
+    const __m128 color1 = _mm_loadu_ps(p.color1);
+    const __m128 color2 = _mm_loadu_ps(p.color2);
+    const __m128 inv_color2 = _mm_sub_ps(one, color2);
+    const __m128 factor = _mm_add_ps(value_m, _mm_mul_ps(value, inv_color2));
+    const __m128 result = _mm_sub_ps(one, _mm_mul_ps(factor, _mm_sub_ps(one, color1)));
+    _mm_storeu_ps(p.out, clamp_if_needed_sse(with_alpha_sse(result, color1)));
+    p.next();
+  }
+#else
   while (p.out < p.row_end) {
     float value = p.value[0];
     if (this->use_value_alpha_multiply()) {
@@ -1247,6 +1333,7 @@ void MixScreenOperation::update_memory_buffer_row(PixelCursor &p)
     clamp_if_needed(p.out);
     p.next();
   }
+#endif
 }
 
 /* ******** Mix Soft Light Operation ******** */
@@ -1347,6 +1434,16 @@ void MixSubtractOperation::execute_pixel_sampled(float output[4],
 
 void MixSubtractOperation::update_memory_buffer_row(PixelCursor &p)
 {
+#ifdef BLI_HAVE_SSE2
+  while (p.out < p.row_end) {
+    const __m128 value = load_value_sse(p);
+    const __m128 color1 = _mm_loadu_ps(p.color1);
+    const __m128 color2 = _mm_loadu_ps(p.color2);
+    const __m128 result = _mm_sub_ps(color1, _mm_mul_ps(value, color2));
+    _mm_storeu_ps(p.out, clamp_if_needed_sse(with_alpha_sse(result, color1)));
+    p.next();
+  }
+#else
   while (p.out < p.row_end) {
     float value = p.value[0];
     if (this->use_value_alpha_multiply()) {
@@ -1360,6 +1457,7 @@ void MixSubtractOperation::update_memory_buffer_row(PixelCursor &p)
     clamp_if_needed(p.out);
     p.next();
   }
+#endif
 }
 
 /* ******** Mix Value Operation ******** */
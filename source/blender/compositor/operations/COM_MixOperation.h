@@ -19,6 +19,7 @@
 #pragma once
 
 #include "COM_MultiThreadedOperation.h"
+#include "COM_SIMD.h"
 
 namespace blender::compositor {
 
@@ -66,6 +67,28 @@ class MixBaseOperation : public MultiThreadedOperation {
     }
   }
 
+#ifdef BLI_HAVE_SSE2
+  /**
+   * Mix factor of the current pixel in all lanes.
+   */
+  inline __m128 load_value_sse(const PixelCursor &p)
+  {
+    float value = p.value[0];
+    if (value_alpha_multiply_) {
+      value *= p.color2[3];
+    }
+    return _mm_set1_ps(value);
+  }
+
+  inline __m128 clamp_if_needed_sse(const __m128 color)
+  {
+    if (use_clamp_) {
+      return clamp_sse(color, 0.0f, 1.0f);
+    }
+    return color;
+  }
+#endif
+
  public:
   /**
    * Default constructor
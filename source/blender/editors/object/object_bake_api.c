@@ -1605,6 +1605,8 @@ cleanup:
     BKE_id_free(NULL, &me_cage_eval->id);
   }
 
+  RE_bake_engine_free(re);
+
   DEG_graph_free(depsgraph);
 
   return op_result;
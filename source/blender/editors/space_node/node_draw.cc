@@ -1696,14 +1696,13 @@ static Vector<NodeExtraInfoRow> node_get_extra_info(const SpaceNode *snode, cons
   }
 
   if (snode->overlay.flag & SN_OVERLAY_SHOW_TIMINGS && snode->edittree->type == NTREE_GEOMETRY &&
-      (ELEM(node->typeinfo->nclass, NODE_CLASS_GEOMETRY, NODE_CLASS_GROUP, NODE_CLASS_ATTRIBUTE) ||
-       ELEM(node->type, NODE_FRAME, NODE_GROUP_OUTPUT))) {
+      !ELEM(node->type, NODE_REROUTE, NODE_GROUP_INPUT)) {
     NodeExtraInfoRow row;
     row.text = node_get_execution_time_label(snode, node);
     if (!row.text.empty()) {
       row.tooltip = TIP_(
-          "The execution time from the node tree's latest evaluation. For frame and group nodes, "
-          "the time for all sub-nodes");
+          "The execution time from the node tree's latest evaluation, including the evaluation of "
+          "fields by the node. For frame and group nodes, the time for all sub-nodes");
       row.icon = ICON_PREVIEW_RANGE;
       rows.append(std::move(row));
     }
@@ -43,6 +43,7 @@
 #include "BKE_node.h"
 #include "BKE_report.h"
 #include "BKE_scene.h"
+#include "BKE_screen.h"
 #include "BKE_workspace.h"
 
 #include "DEG_depsgraph.h"
@@ -320,6 +321,25 @@ static void compo_startjob(void *cjv,
   ntree->progress = nullptr;
 }
 
+/**
+ * Store the part of the viewer image visible in the backdrop of the node editor, so that only
+ * that part is computed. When the viewer is not shown in the backdrop all of it is computed.
+ */
+static void compo_update_viewer_view_border(const bContext *C, bNodeTree *nodetree)
+{
+  SpaceNode *snode = CTX_wm_space_node(C);
+  ScrArea *area = CTX_wm_area(C);
+  const ARegion *region = area ? BKE_area_find_region_type(area, RGN_TYPE_WINDOW) : nullptr;
+  rctf border;
+  if (snode && snode->nodetree == nodetree &&
+      node_backdrop_view_border_get(CTX_data_main(C), snode, region, &border)) {
+    nodetree->viewer_view_border = border;
+  }
+  else {
+    BLI_rctf_init(&nodetree->viewer_view_border, 0.0f, 1.0f, 0.0f, 1.0f);
+  }
+}
+
 /**
  * \param scene_owner: is the owner of the job,
  * we don't use it for anything else currently so could also be a void pointer,
@@ -345,6 +365,10 @@ void ED_node_composite_job(const bContext *C, struct bNodeTree *nodetree, Scene
   BKE_image_backup_render(
       scene, BKE_image_ensure_viewer(bmain, IMA_TYPE_R_RESULT, "Render Result"), false);
 
+  if (nodetree->flag & NTREE_COM_VIEWER_VIEW_BORDER) {
+    compo_update_viewer_view_border(C, nodetree);
+  }
+
   wmJob *wm_job = WM_jobs_get(CTX_wm_manager(C),
                               CTX_wm_window(C),
                               scene_owner,
@@ -2795,8 +2819,8 @@ void NODE_OT_shader_script_update(wmOperatorType *ot)
 
 /* ********************** Viewer border ******************/
 
-static void viewer_border_corner_to_backdrop(SpaceNode *snode,
-                                             ARegion *region,
+static void viewer_border_corner_to_backdrop(const SpaceNode *snode,
+                                             const ARegion *region,
                                              int x,
                                              int y,
                                              int backdrop_width,
@@ -2811,6 +2835,44 @@ static void viewer_border_corner_to_backdrop(SpaceNode *snode,
   *fy = (bufy > 0.0f ? ((float)y - 0.5f * region->winy - snode->yof) / bufy + 0.5f : 0.0f);
 }
 
+/**
+ * Get the part of the viewer image visible in the backdrop, normalized to the image size.
+ * Returns false when the backdrop is hidden or the viewer image doesn't exist yet.
+ */
+bool node_backdrop_view_border_get(Main *bmain,
+                                   const SpaceNode *snode,
+                                   const ARegion *region,
+                                   rctf *r_border)
+{
+  if (!(snode->flag & SNODE_BACKDRAW) || region == nullptr) {
+    return false;
+  }
+
+  void *lock;
+  Image *ima = BKE_image_ensure_viewer(bmain, IMA_TYPE_COMPOSITE, "Viewer Node");
+  ImBuf *ibuf = BKE_image_acquire_ibuf(ima, nullptr, &lock);
+  bool is_visible = false;
+  if (ibuf && ibuf->x > 0 && ibuf->y > 0) {
+    viewer_border_corner_to_backdrop(
+        snode, region, 0, 0, ibuf->x, ibuf->y, &r_border->xmin, &r_border->ymin);
+    viewer_border_corner_to_backdrop(snode,
+                                     region,
+                                     region->winx,
+                                     region->winy,
+                                     ibuf->x,
+                                     ibuf->y,
+                                     &r_border->xmax,
+                                     &r_border->ymax);
+    r_border->xmin = max_ff(r_border->xmin, 0.0f);
+    r_border->ymin = max_ff(r_border->ymin, 0.0f);
+    r_border->xmax = min_ff(r_border->xmax, 1.0f);
+    r_border->ymax = min_ff(r_border->ymax, 1.0f);
+    is_visible = r_border->xmin < r_border->xmax && r_border->ymin < r_border->ymax;
+  }
+  BKE_image_release_ibuf(ima, ibuf, lock);
+  return is_visible;
+}
+
 static int viewer_border_exec(bContext *C, wmOperator *op)
 {
   Main *bmain = CTX_data_main(C);
@@ -250,6 +250,10 @@ void snode_set_context(const bContext *C);
 void snode_update(SpaceNode *snode, bNode *node);
 bool composite_node_active(bContext *C);
 bool composite_node_editable(bContext *C);
+bool node_backdrop_view_border_get(Main *bmain,
+                                   const SpaceNode *snode,
+                                   const ARegion *region,
+                                   rctf *r_border);
 
 bool node_has_hidden_sockets(bNode *node);
 void node_set_hidden_sockets(SpaceNode *snode, bNode *node, int set);
@@ -200,6 +200,25 @@ struct NodeViewMove {
   int xmin, ymin, xmax, ymax;
 };
 
+/**
+ * When the compositor only computes the visible part of the viewer, compute it again when a part
+ * that was not computed becomes visible.
+ */
+static void snode_bg_view_changed(bContext *C)
+{
+  SpaceNode *snode = CTX_wm_space_node(C);
+  const bNodeTree *ntree = snode->nodetree;
+  if (ntree == nullptr || !(ntree->flag & NTREE_COM_VIEWER_VIEW_BORDER)) {
+    return;
+  }
+  rctf border;
+  if (node_backdrop_view_border_get(CTX_data_main(C), snode, CTX_wm_region(C), &border) &&
+      BLI_rctf_inside_rctf(&ntree->viewer_view_border, &border)) {
+    return;
+  }
+  ED_area_tag_refresh(CTX_wm_area(C));
+}
+
 static int snode_bg_viewmove_modal(bContext *C, wmOperator *op, const wmEvent *event)
 {
   SpaceNode *snode = CTX_wm_space_node(C);
@@ -230,6 +249,7 @@ static int snode_bg_viewmove_modal(bContext *C, wmOperator *op, const wmEvent *e
       if (event->val == KM_RELEASE) {
         MEM_freeN(nvm);
         op->customdata = nullptr;
+        snode_bg_view_changed(C);
         return OPERATOR_FINISHED;
       }
       break;
@@ -315,6 +335,7 @@ static int backimage_zoom_exec(bContext *C, wmOperator *op)
   ED_region_tag_redraw(region);
   WM_main_add_notifier(NC_NODE | ND_DISPLAY, nullptr);
   WM_main_add_notifier(NC_SPACE | ND_SPACE_NODE_VIEW, nullptr);
+  snode_bg_view_changed(C);
 
   return OPERATOR_FINISHED;
 }
@@ -380,6 +401,7 @@ static int backimage_fit_exec(bContext *C, wmOperator *UNUSED(op))
   ED_region_tag_redraw(region);
   WM_main_add_notifier(NC_NODE | ND_DISPLAY, nullptr);
   WM_main_add_notifier(NC_SPACE | ND_SPACE_NODE_VIEW, nullptr);
+  snode_bg_view_changed(C);
 
   return OPERATOR_FINISHED;
 }
@@ -294,6 +294,8 @@ class MFProcedure : NonCopyable, NonMovable {
   Span<MFVariable *> variables();
   Span<const MFVariable *> variables() const;
 
+  Span<const MFCallInstruction *> call_instructions() const;
+
   std::string to_dot() const;
 
   bool validate() const;
@@ -550,6 +552,11 @@ inline Span<const MFVariable *> MFProcedure::variables() const
   return variables_;
 }
 
+inline Span<const MFCallInstruction *> MFProcedure::call_instructions() const
+{
+  return call_instructions_;
+}
+
 /** \} */
 
 }  // namespace blender::fn
@@ -18,6 +18,7 @@
 #include "BLI_multi_value_map.hh"
 #include "BLI_set.hh"
 #include "BLI_stack.hh"
+#include "BLI_task.hh"
 #include "BLI_vector_set.hh"
 
 #include "FN_field.hh"
@@ -457,7 +458,10 @@ Vector<GVArray> evaluate_fields(ResourceScope &scope,
       /* Still have to copy over the data in the destination provided by the caller. */
       if (dst_varray.is_span()) {
         /* Materialize into a span. */
-        computed_varray.materialize_to_uninitialized(mask, dst_varray.get_internal_span().data());
+        void *dst = dst_varray.get_internal_span().data();
+        threading::parallel_for(mask.index_range(), 4096, [&](const IndexRange range) {
+          computed_varray.materialize_to_uninitialized(mask.slice(range), dst);
+        });
       }
       else {
         /* Slower materialize into a different structure. */
@@ -1241,6 +1241,16 @@ MultiFunction::ExecutionHints MFProcedureExecutor::get_execution_hints() const
   ExecutionHints hints;
   hints.allocates_array = true;
   hints.min_grain_size = 10000;
+
+  /* The procedure is as expensive as the functions it calls. Use the smallest grain size of those,
+   * so that procedures which do expensive work (e.g. noise) are split up into multiple tasks even
+   * for fewer elements. Procedures with only cheap functions keep the large grain size, to avoid
+   * the threading overhead for small masks. */
+  for (const MFCallInstruction *instruction : procedure_.call_instructions()) {
+    const ExecutionHints fn_hints = instruction->fn().execution_hints();
+    hints.min_grain_size = std::min(hints.min_grain_size, fn_hints.min_grain_size);
+    hints.uniform_execution_time &= fn_hints.uniform_execution_time;
+  }
   return hints;
 }
 
@@ -289,4 +289,34 @@ TEST(field, IgnoredOutput)
   EXPECT_EQ(results.get(3), 5);
 }
 
+TEST(field, LargeMask)
+{
+  /* Large enough to be split up into multiple chunks that are evaluated in parallel. */
+  const int size = 100000;
+
+  GField index_field{std::make_shared<IndexFieldInput>()};
+
+  std::unique_ptr<MultiFunction> add_fn = std::make_unique<CustomMF_SI_SI_SO<int, int, int>>(
+      "add", [](int a, int b) { return a + b; });
+  GField output_field{std::make_shared<FieldOperation>(
+                          FieldOperation(std::move(add_fn), {index_field, index_field})),
+                      0};
+
+  Vector<int64_t> indices;
+  for (int i = 1; i < size; i += 3) {
+    indices.append(i);
+  }
+  const IndexMask mask{indices};
+
+  Array<int> result(size, -1);
+
+  FieldContext context;
+  FieldEvaluator evaluator{context, &mask};
+  evaluator.add_with_destination(output_field, result.as_mutable_span());
+  evaluator.evaluate();
+  for (const int i : IndexRange(size)) {
+    EXPECT_EQ(result[i], (i % 3 == 1) ? i * 2 : -1);
+  }
+}
+
 }  // namespace blender::fn::tests
@@ -378,4 +378,88 @@ TEST(multi_function_procedure, BufferReuse)
   EXPECT_EQ(results[4], 53);
 }
 
+class ExpensiveAddFunction : public MultiFunction {
+ public:
+  ExpensiveAddFunction()
+  {
+    static MFSignature signature = create_signature();
+    this->set_signature(&signature);
+  }
+
+  static MFSignature create_signature()
+  {
+    MFSignatureBuilder signature{"Expensive Add"};
+    signature.single_input<int>("A");
+    signature.single_input<int>("B");
+    signature.single_output<int>("Result");
+    return signature.build();
+  }
+
+  void call(IndexMask mask, MFParams params, MFContext UNUSED(context)) const override
+  {
+    const VArray<int> &a = params.readonly_single_input<int>(0, "A");
+    const VArray<int> &b = params.readonly_single_input<int>(1, "B");
+    MutableSpan<int> result = params.uninitialized_single_output<int>(2, "Result");
+    mask.foreach_index([&](const int64_t i) { result[i] = a[i] + b[i]; });
+  }
+
+  ExecutionHints get_execution_hints() const override
+  {
+    ExecutionHints hints;
+    hints.min_grain_size = 100;
+    hints.uniform_execution_time = false;
+    return hints;
+  }
+};
+
+TEST(multi_function_procedure, ExecutionHints)
+{
+  /**
+   * procedure(int var1, int *var3) {
+   *   var2 = var1 + var1;
+   *   var3 = var2 + var2;
+   * }
+   */
+
+  CustomMF_SI_SI_SO<int, int, int> add_fn{"add", [](int a, int b) { return a + b; }};
+  ExpensiveAddFunction expensive_add_fn;
+
+  MFProcedure procedure;
+  MFProcedureBuilder builder{procedure};
+
+  MFVariable *var1 = &builder.add_single_input_parameter<int>();
+  auto [var2] = builder.add_call<1>(add_fn, {var1, var1});
+  builder.add_destruct(*var1);
+  auto [var3] = builder.add_call<1>(expensive_add_fn, {var2, var2});
+  builder.add_destruct(*var2);
+  builder.add_return();
+  builder.add_output_parameter(*var3);
+
+  EXPECT_TRUE(procedure.validate());
+
+  MFProcedureExecutor executor{procedure};
+  const MultiFunction::ExecutionHints hints = executor.execution_hints();
+  EXPECT_EQ(hints.min_grain_size, 100);
+  EXPECT_FALSE(hints.uniform_execution_time);
+  EXPECT_TRUE(hints.allocates_array);
+
+  const int size = 10000;
+  Array<int> inputs(size);
+  for (const int i : inputs.index_range()) {
+    inputs[i] = i;
+  }
+  Array<int> results(size, -1);
+
+  MFParamsBuilder params{executor, size};
+  params.add_readonly_single_input(inputs.as_span());
+  params.add_uninitialized_single_output(results.as_mutable_span());
+
+  MFContextBuilder context;
+  executor.call_auto(IndexRange(size), params, context);
+
+  for (const int i : IndexRange(size)) {
+    EXPECT_EQ(results[i], i * 4);
+  }
+}
+
 }  // namespace blender::fn::tests
@@ -0,0 +1,218 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <numeric>
+
+#include "BLI_array.hh"
+#include "BLI_hash.hh"
+#include "BLI_map.hh"
+#include "BLI_noise.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "GEO_point_elimination.hh"
+
+namespace blender::geometry {
+
+/** A cell of the grid used to find close points. The size of the cells is the minimum distance. */
+struct GridCell {
+  int x;
+  int y;
+  int z;
+
+  uint64_t hash() const
+  {
+    return get_default_hash_3(x, y, z);
+  }
+
+  friend bool operator==(const GridCell &a, const GridCell &b)
+  {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+  }
+};
+
+static GridCell position_to_grid_cell(const float3 &position, const float cell_size_inv)
+{
+  /* Clamp to avoid overflow, far away points end up in the same cell, which is still correct. */
+  const float limit = float(1 << 30);
+  return {int(std::clamp(std::floor(position.x * cell_size_inv), -limit, limit)),
+          int(std::clamp(std::floor(position.y * cell_size_inv), -limit, limit)),
+          int(std::clamp(std::floor(position.z * cell_size_inv), -limit, limit))};
+}
+
+enum class PointState : int8_t {
+  Undecided,
+  Kept,
+  Eliminated,
+};
+
+/**
+ * A point is kept when all points within the minimum distance that have a lower priority value
+ * are eliminated, and it is eliminated when one of them is kept.
+ */
+static PointState decide_point_state(const int point,
+                                     const Span<IndexRange> neighbor_ranges,
+                                     const Span<float3> positions,
+                                     const Span<uint64_t> priorities,
+                                     const Span<PointState> states,
+                                     const float minimum_distance_sq)
+{
+  const float3 position = positions[point];
+  const uint64_t priority = priorities[point];
+  bool has_undecided_neighbor = false;
+  for (const IndexRange range : neighbor_ranges) {
+    for (const int other : range) {
+      if (priorities[other] >= priority || states[other] == PointState::Eliminated) {
+        continue;
+      }
+      if (float3::distance_squared(position, positions[other]) > minimum_distance_sq) {
+        continue;
+      }
+      if (states[other] == PointState::Kept) {
+        return PointState::Eliminated;
+      }
+      has_undecided_neighbor = true;
+    }
+  }
+  return has_undecided_neighbor ? PointState::Undecided : PointState::Kept;
+}
+
+/**
+ * The result is the same as keeping points one after another in the order of a random priority,
+ * unless a close point was kept before. Instead of processing the points one after another, all
+ * points whose closer points with a lower priority are decided already are processed in parallel,
+ * which only takes a few rounds for a random order. The priorities only depend on the positions,
+ * so the result does not depend on the number of threads.
+ */
+void eliminate_close_points(const Span<float3> positions,
+                            const float minimum_distance,
+                            MutableSpan<bool> elimination_mask)
+{
+  if (minimum_distance <= 0.0f) {
+    return;
+  }
+
+  const float cell_size_inv = 1.0f / minimum_distance;
+  Array<GridCell> point_cells(positions.size());
+  threading::parallel_for(positions.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      point_cells[i] = position_to_grid_cell(positions[i], cell_size_inv);
+    }
+  });
+
+  /* Sort the points by cell, so that the points in every cell are stored contiguously. */
+  Map<GridCell, int> cell_indices;
+  Vector<GridCell> cells;
+  Vector<int> cell_offsets;
+  Array<int> point_cell_indices(positions.size());
+  for (const int i : positions.index_range()) {
+    const int cell_index = cell_indices.lookup_or_add_cb(point_cells[i], [&]() {
+      cells.append(point_cells[i]);
+      cell_offsets.append(0);
+      return cells.size() - 1;
+    });
+    point_cell_indices[i] = cell_index;
+    cell_offsets[cell_index]++;
+  }
+  int offset = 0;
+  for (int &cell_offset : cell_offsets) {
+    const int cell_size = cell_offset;
+    cell_offset = offset;
+    offset += cell_size;
+  }
+  cell_offsets.append(offset);
+
+  Array<int> sorted_points(positions.size());
+  {
+    Array<int> cell_fill(cell_offsets.as_span().drop_back(1));
+    for (const int i : positions.index_range()) {
+      sorted_points[cell_fill[point_cell_indices[i]]++] = i;
+    }
+  }
+
+  Array<float3> sorted_positions(positions.size());
+  Array<uint64_t> priorities(positions.size());
+  Array<PointState> states(positions.size());
+  threading::parallel_for(sorted_points.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const int point = sorted_points[i];
+      sorted_positions[i] = positions[point];
+      /* Use the index to make the priorities unique. */
+      priorities[i] = (uint64_t(noise::hash_float(positions[point])) << 32) | uint64_t(point);
+      states[i] = elimination_mask[point] ? PointState::Eliminated : PointState::Undecided;
+    }
+  });
+
+  const float minimum_distance_sq = minimum_distance * minimum_distance;
+  Array<PointState> new_states(states);
+  Vector<int> active_cells(cells.size());
+  std::iota(active_cells.begin(), active_cells.end(), 0);
+  while (!active_cells.is_empty()) {
+    /* New states are only used in the next round, so the result does not depend on the order in
+     * which the points are processed. */
+    threading::parallel_for(active_cells.index_range(), 64, [&](IndexRange range) {
+      for (const int cell_index : active_cells.as_span().slice(range)) {
+        const GridCell cell = cells[cell_index];
+        Vector<IndexRange, 27> neighbor_ranges;
+        /* Cell coordinates can be negative, so #IndexRange can't be used here. */
+        for (int z = cell.z - 1; z <= cell.z + 1; z++) {
+          for (int y = cell.y - 1; y <= cell.y + 1; y++) {
+            for (int x = cell.x - 1; x <= cell.x + 1; x++) {
+              const int *neighbor_index = cell_indices.lookup_ptr({x, y, z});
+              if (neighbor_index != nullptr) {
+                neighbor_ranges.append(IndexRange(cell_offsets[*neighbor_index],
+                                                  cell_offsets[*neighbor_index + 1] -
+                                                      cell_offsets[*neighbor_index]));
+              }
+            }
+          }
+        }
+        const IndexRange cell_points(cell_offsets[cell_index],
+                                     cell_offsets[cell_index + 1] - cell_offsets[cell_index]);
+        for (const int point : cell_points) {
+          if (states[point] == PointState::Undecided) {
+            new_states[point] = decide_point_state(
+                point, neighbor_ranges, sorted_positions, priorities, states, minimum_distance_sq);
+          }
+        }
+      }
+    });
+
+    /* The undecided point with the lowest priority is always decided, so this terminates. */
+    Vector<int> next_active_cells;
+    for (const int cell_index : active_cells) {
+      bool has_undecided_point = false;
+      for (const int point : IndexRange(cell_offsets[cell_index],
+                                        cell_offsets[cell_index + 1] - cell_offsets[cell_index])) {
+        states[point] = new_states[point];
+        has_undecided_point |= states[point] == PointState::Undecided;
+      }
+      if (has_undecided_point) {
+        next_active_cells.append(cell_index);
+      }
+    }
+    active_cells = std::move(next_active_cells);
+  }
+
+  threading::parallel_for(sorted_points.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      elimination_mask[sorted_points[i]] = states[i] == PointState::Eliminated;
+    }
+  });
+}
+
+}  // namespace blender::geometry
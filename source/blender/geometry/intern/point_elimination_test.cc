@@ -0,0 +1,103 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_rand.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "GEO_point_elimination.hh"
+
+namespace blender::geometry::tests {
+
+/** Random points in a cube centered at the origin, so that many coordinates are negative. */
+static Vector<float3> create_random_points(const int size, const float radius)
+{
+  RandomNumberGenerator rng(0);
+  Vector<float3> positions;
+  for ([[maybe_unused]] const int i : IndexRange(size)) {
+    positions.append(float3(rng.get_float(), rng.get_float(), rng.get_float()) * 2.0f * radius -
+                     float3(radius));
+  }
+  return positions;
+}
+
+TEST(point_elimination, EliminateClosePoints)
+{
+  const float minimum_distance = 0.1f;
+  const Vector<float3> positions = create_random_points(5000, 1.0f);
+  Array<bool> elimination_mask(positions.size(), false);
+  eliminate_close_points(positions, minimum_distance, elimination_mask);
+
+  Vector<float3> kept_positions;
+  for (const int i : positions.index_range()) {
+    if (!elimination_mask[i]) {
+      kept_positions.append(positions[i]);
+    }
+  }
+  EXPECT_GT(kept_positions.size(), 0);
+  EXPECT_LT(kept_positions.size(), positions.size());
+
+  /* No two kept points are close, and every eliminated point is close to a kept point. */
+  for (const int i : kept_positions.index_range()) {
+    for (int j = i + 1; j < kept_positions.size(); j++) {
+      EXPECT_GT(float3::distance(kept_positions[i], kept_positions[j]), minimum_distance);
+    }
+  }
+  for (const int i : positions.index_range()) {
+    if (!elimination_mask[i]) {
+      continue;
+    }
+    bool has_close_point = false;
+    for (const float3 &kept_position : kept_positions) {
+      has_close_point |= float3::distance(positions[i], kept_position) <= minimum_distance;
+    }
+    EXPECT_TRUE(has_close_point);
+  }
+}
+
+TEST(point_elimination, AlreadyEliminatedPoints)
+{
+  const Vector<float3> positions = {float3(-0.05f), float3(0.0f), float3(-1.0f)};
+  Array<bool> elimination_mask = {true, false, false};
+  eliminate_close_points(positions, 0.1f, elimination_mask);
+  EXPECT_TRUE(elimination_mask[0]);
+  EXPECT_FALSE(elimination_mask[1]);
+  EXPECT_FALSE(elimination_mask[2]);
+}
+
+TEST(point_elimination, IndependentOfThreadCount)
+{
+  const Vector<float3> positions = create_random_points(20000, 2.0f);
+
+  Array<bool> multi_threaded_mask(positions.size(), false);
+  eliminate_close_points(positions, 0.05f, multi_threaded_mask);
+
+  Array<bool> single_threaded_mask(positions.size(), false);
+#ifdef WITH_TBB
+  tbb::task_arena arena(1);
+  arena.execute([&]() { eliminate_close_points(positions, 0.05f, single_threaded_mask); });
+#else
+  eliminate_close_points(positions, 0.05f, single_threaded_mask);
+#endif
+
+  EXPECT_EQ_ARRAY(multi_threaded_mask.data(), single_threaded_mask.data(), positions.size());
+}
+
+}  // namespace blender::geometry::tests
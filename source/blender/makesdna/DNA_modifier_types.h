@@ -2274,8 +2274,23 @@ typedef struct NodesModifierData {
    * debug a node tree. */
   void *runtime_eval_log;
   void *_pad1;
+
+  /**
+   * Directory with a baked geometry for every frame. When the file for the current frame exists,
+   * it is used instead of evaluating the node group. 1024 = FILE_MAX.
+   */
+  char bake_directory[1024];
+  /** #NodesModifierFlag. */
+  int flag;
+  char _pad2[4];
 } NodesModifierData;
 
+/** #NodesModifierData.flag */
+typedef enum NodesModifierFlag {
+  /** Evaluate the node group and write the result to the bake directory. */
+  NODES_MODIFIER_BAKE_WRITE = (1 << 0),
+} NodesModifierFlag;
+
 typedef struct MeshToVolumeModifierData {
   ModifierData modifier;
 
@@ -536,6 +536,11 @@ typedef struct bNodeTree {
   int execution_mode;
 
   rctf viewer_border;
+  /**
+   * Part of the viewer image that is visible in the node editor backdrop, normalized. Set by the
+   * node editor when #NTREE_COM_VIEWER_VIEW_BORDER is used.
+   */
+  rctf viewer_view_border;
 
   /* Lists of bNodeSocket to hold default values and own_index.
    * Warning! Don't make links to these sockets, input/output nodes are used for that.
@@ -598,6 +603,12 @@ typedef struct bNodeTree {
 
 /* tree is localized copy, free when deleting node groups */
 /* #define NTREE_IS_LOCALIZED           (1 << 5) */
+/* store buffers waiting to be read with half float precision (full frame compositor) */
+#define NTREE_COM_HALF_BUFFERS (1 << 6)
+/* keep results between executions to only recompute what changed (full frame compositor) */
+#define NTREE_COM_RESULT_CACHE (1 << 7)
+/* only compute the part of viewer nodes visible in the backdrop (full frame compositor) */
+#define NTREE_COM_VIEWER_VIEW_BORDER (1 << 8)
 
 /* ntree->update */
 typedef enum eNodeTreeUpdate {
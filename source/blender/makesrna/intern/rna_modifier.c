@@ -1615,6 +1615,24 @@ static void rna_NodesModifier_node_group_update(Main *bmain, Scene *scene, Point
   MOD_nodes_update_interface(object, nmd);
 }
 
+static void rna_NodesModifier_node_statistics(NodesModifierData *nmd,
+                                              const char *node_path,
+                                              bool *r_found,
+                                              float *r_execution_time,
+                                              int *r_execution_count,
+                                              int *r_execution_thread,
+                                              int *r_input_elements,
+                                              int *r_output_elements)
+{
+  NodesModifierNodeStatistics statistics = {0};
+  *r_found = MOD_nodes_node_statistics(nmd, node_path, &statistics);
+  *r_execution_time = statistics.execution_time;
+  *r_execution_count = statistics.execution_count;
+  *r_execution_thread = statistics.execution_thread;
+  *r_input_elements = statistics.input_elements_num;
+  *r_output_elements = statistics.output_elements_num;
+}
+
 static IDProperty **rna_NodesModifier_properties(PointerRNA *ptr)
 {
   NodesModifierData *nmd = ptr->data;
@@ -6928,6 +6946,8 @@ static void rna_def_modifier_nodes(BlenderRNA *brna)
 {
   StructRNA *srna;
   PropertyRNA *prop;
+  FunctionRNA *func;
+  PropertyRNA *parm;
 
   srna = RNA_def_struct(brna, "NodesModifier", "Modifier");
   RNA_def_struct_ui_text(srna, "Nodes Modifier", "");
@@ -6943,7 +6963,89 @@ static void rna_def_modifier_nodes(BlenderRNA *brna)
   RNA_def_property_flag(prop, PROP_EDITABLE);
   RNA_def_property_update(prop, 0, "rna_NodesModifier_node_group_update");
 
+  prop = RNA_def_property(srna, "bake_directory", PROP_STRING, PROP_DIRPATH);
+  RNA_def_property_ui_text(prop,
+                           "Bake Directory",
+                           "Directory with a baked geometry file for every frame, which is used "
+                           "instead of evaluating the node group when it exists");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
+  prop = RNA_def_property(srna, "use_bake_write", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NODES_MODIFIER_BAKE_WRITE);
+  RNA_def_property_ui_text(
+      prop,
+      "Write Bake",
+      "Evaluate the node group and write the result of every evaluated frame to the bake "
+      "directory, replacing existing files");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
   RNA_define_lib_overridable(false);
+
+  func = RNA_def_function(srna, "node_statistics", "rna_NodesModifier_node_statistics");
+  RNA_def_function_ui_description(
+      func,
+      "Get the execution statistics of a node from the latest evaluation in the active "
+      "depsgraph");
+  parm = RNA_def_string(func,
+                        "node_path",
+                        NULL,
+                        0,
+                        "",
+                        "Name of the node, nodes in groups are prefixed with the names of the "
+                        "group nodes, separated by '/'");
+  RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+  parm = RNA_def_boolean(func, "found", false, "", "Whether the node was executed");
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_float(func,
+                       "execution_time",
+                       0.0f,
+                       0.0f,
+                       FLT_MAX,
+                       "",
+                       "Total time of all executions of the node in milliseconds",
+                       0.0f,
+                       FLT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_int(func,
+                     "execution_count",
+                     0,
+                     0,
+                     INT_MAX,
+                     "",
+                     "Number of times the node was executed",
+                     0,
+                     INT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_int(func,
+                     "execution_thread",
+                     -1,
+                     -1,
+                     INT_MAX,
+                     "",
+                     "Index of the thread that ran the longest execution of the node",
+                     -1,
+                     INT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_int(func,
+                     "input_elements",
+                     0,
+                     0,
+                     INT_MAX,
+                     "",
+                     "Number of geometry elements passed to the node's inputs",
+                     0,
+                     INT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_int(func,
+                     "output_elements",
+                     0,
+                     0,
+                     INT_MAX,
+                     "",
+                     "Number of geometry elements in the node's outputs",
+                     0,
+                     INT_MAX);
+  RNA_def_function_output(func, parm);
 }
 
 static void rna_def_modifier_mesh_to_volume(BlenderRNA *brna)
@@ -12956,6 +12956,30 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_GROUPNODE_BUFFER);
   RNA_def_property_ui_text(prop, "Buffer Groups", "Enable buffering of group nodes");
 
+  prop = RNA_def_property(srna, "use_half_precision_buffers", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_HALF_BUFFERS);
+  RNA_def_property_ui_text(prop,
+                           "Half Precision Buffers",
+                           "Store intermediate results with half float precision while they "
+                           "wait to be used, reducing memory usage at the cost of precision "
+                           "(Full Frame execution mode only)");
+
+  prop = RNA_def_property(srna, "use_result_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_RESULT_CACHE);
+  RNA_def_property_ui_text(prop,
+                           "Cache Results",
+                           "Keep the results of operations between executions, so that only "
+                           "nodes affected by a change are computed again "
+                           "(Full Frame execution mode only)");
+
+  prop = RNA_def_property(srna, "use_viewer_view_border", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_VIEWER_VIEW_BORDER);
+  RNA_def_property_ui_text(prop,
+                           "Limit Viewer to View",
+                           "Only compute the part of viewer nodes that is visible in the "
+                           "backdrop (Full Frame execution mode only)");
+  RNA_def_property_update(prop, NC_NODE | ND_DISPLAY, "rna_NodeTree_update");
+
   prop = RNA_def_property(srna, "use_two_pass", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_TWO_PASS);
   RNA_def_property_ui_text(prop,
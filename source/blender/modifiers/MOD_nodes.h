@@ -28,6 +28,29 @@ void MOD_nodes_update_interface(struct Object *object, struct NodesModifierData
 
 void MOD_nodes_init(struct Main *bmain, struct NodesModifierData *nmd);
 
+/** Free the node outputs that are kept between evaluations of geometry nodes modifiers. */
+void MOD_nodes_free_cache(void);
+
+typedef struct NodesModifierNodeStatistics {
+  /** Total time of all executions of the node, in milliseconds. */
+  float execution_time;
+  int execution_count;
+  int execution_thread;
+  int input_elements_num;
+  int output_elements_num;
+} NodesModifierNodeStatistics;
+
+/**
+ * Get the statistics logged for a node in the latest evaluation of the modifier. Nodes in nested
+ * groups are found with the names of the group nodes, separated by '/'. Only evaluations of the
+ * active depsgraph are logged.
+ *
+ * \return False if no statistics were logged for the node.
+ */
+bool MOD_nodes_node_statistics(const struct NodesModifierData *nmd,
+                               const char *node_path,
+                               NodesModifierNodeStatistics *r_statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,9 +28,11 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_array.hh"
+#include "BLI_fileops.h"
 #include "BLI_float3.hh"
 #include "BLI_listbase.h"
 #include "BLI_multi_value_map.hh"
+#include "BLI_path_util.h"
 #include "BLI_set.hh"
 #include "BLI_string.h"
 #include "BLI_string_search.h"
@@ -52,6 +54,7 @@
 
 #include "BKE_attribute_math.hh"
 #include "BKE_customdata.h"
+#include "BKE_geometry_set_bake.hh"
 #include "BKE_geometry_set_instances.hh"
 #include "BKE_global.h"
 #include "BKE_idprop.h"
@@ -239,6 +242,8 @@ static void updateDepsgraph(ModifierData *md, const ModifierUpdateDepsgraphConte
   if (nmd->node_group != nullptr) {
     DEG_add_node_tree_relation(ctx->node, nmd->node_group, "Nodes Modifier");
 
+    /* Baked geometry only references objects and collections from this set, see
+     * #try_read_baked_geometry, so the relations below also cover reading a bake. */
     Set<ID *> used_ids;
     find_used_ids_from_settings(nmd->settings, used_ids);
     find_used_ids_from_nodes(*nmd->node_group, used_ids);
@@ -268,6 +273,14 @@ static void updateDepsgraph(ModifierData *md, const ModifierUpdateDepsgraphConte
   }
 }
 
+static bool dependsOnTime(struct Scene *UNUSED(scene),
+                          ModifierData *md,
+                          const int UNUSED(dag_eval_mode))
+{
+  const NodesModifierData *nmd = reinterpret_cast<NodesModifierData *>(md);
+  return nmd->bake_directory[0] != '\0';
+}
+
 static void foreachIDLink(ModifierData *md, Object *ob, IDWalkFunc walk, void *userData)
 {
   NodesModifierData *nmd = reinterpret_cast<NodesModifierData *>(md);
@@ -673,6 +686,42 @@ void MOD_nodes_update_interface(Object *object, NodesModifierData *nmd)
   DEG_id_tag_update(&object->id, ID_RECALC_GEOMETRY);
 }
 
+bool MOD_nodes_node_statistics(const NodesModifierData *nmd,
+                               const char *node_path,
+                               NodesModifierNodeStatistics *r_statistics)
+{
+  if (nmd->runtime_eval_log == nullptr) {
+    return false;
+  }
+  const geo_log::ModifierLog &log = *static_cast<geo_log::ModifierLog *>(nmd->runtime_eval_log);
+
+  const geo_log::TreeLog *tree_log = &log.root_tree();
+  StringRef path = node_path;
+  int64_t separator = path.find('/');
+  while (separator != StringRef::not_found) {
+    tree_log = tree_log->lookup_child_log(path.substr(0, separator));
+    if (tree_log == nullptr) {
+      return false;
+    }
+    path = path.drop_prefix(separator + 1);
+    separator = path.find('/');
+  }
+
+  const geo_log::NodeLog *node_log = tree_log->lookup_node_log(path);
+  if (node_log == nullptr || node_log->execution_count() == 0) {
+    return false;
+  }
+
+  r_statistics->execution_time = node_log->execution_time().count() / 1000.0f;
+  r_statistics->execution_count = node_log->execution_count();
+  r_statistics->execution_thread = node_log->execution_thread();
+  r_statistics->input_elements_num = (int)std::min<int64_t>(
+      node_log->geometry_elements_num(SOCK_IN), INT_MAX);
+  r_statistics->output_elements_num = (int)std::min<int64_t>(
+      node_log->geometry_elements_num(SOCK_OUT), INT_MAX);
+  return true;
+}
+
 void MOD_nodes_init(Main *bmain, NodesModifierData *nmd)
 {
   bNodeTree *ntree = ntreeAddTree(bmain, "Geometry Nodes", ntreeType_Geometry->idname);
@@ -1075,6 +1124,80 @@ static void check_property_socket_sync(const Object *ob, ModifierData *md)
   }
 }
 
+/**
+ * The path of the baked geometry for the current frame, or an empty string when the modifier does
+ * not use baking.
+ */
+static std::string get_bake_filepath(const NodesModifierData &nmd, const ModifierEvalContext &ctx)
+{
+  if (nmd.bake_directory[0] == '\0') {
+    return {};
+  }
+  char directory[FILE_MAX];
+  BLI_strncpy(directory, nmd.bake_directory, sizeof(directory));
+  BLI_path_abs(directory, ID_BLEND_PATH_FROM_GLOBAL(&ctx.object->id));
+
+  char filename[FILE_MAXFILE];
+  const int frame = round_fl_to_int(DEG_get_ctime(ctx.depsgraph));
+  BLI_snprintf(filename, sizeof(filename), "frame_%06d.bgeo", frame);
+
+  char filepath[FILE_MAX];
+  BLI_join_dirfile(filepath, sizeof(filepath), directory, filename);
+  return filepath;
+}
+
+static bool id_matches_bake_reference(const ID &id,
+                                      const short id_code,
+                                      const StringRef name,
+                                      const StringRef library_path)
+{
+  const StringRef id_library_path = id.lib == nullptr ? "" : id.lib->filepath;
+  return GS(id.name) == id_code && name == id.name + 2 && library_path == id_library_path;
+}
+
+static bool try_read_baked_geometry(const NodesModifierData &nmd,
+                                    const ModifierEvalContext &ctx,
+                                    const std::string &filepath,
+                                    GeometrySet &geometry_set)
+{
+  if (!BLI_exists(filepath.c_str())) {
+    return false;
+  }
+
+  /* Only objects and collections used by the node tree have depsgraph relations, instances of
+   * other IDs are not evaluated reliably and are skipped. Materials are only used as handles and
+   * are looked up in the whole file, like they don't have relations either. */
+  Set<ID *> used_ids;
+  find_used_ids_from_settings(nmd.settings, used_ids);
+  find_used_ids_from_nodes(*nmd.node_group, used_ids);
+
+  Main *bmain = DEG_get_bmain(ctx.depsgraph);
+  std::optional<GeometrySet> baked_geometry = blender::bke::geometry_set_bake_read(
+      filepath.c_str(),
+      [&](const short id_code, const StringRef name, const StringRef library_path) -> ID * {
+        if (id_code == ID_MA) {
+          LISTBASE_FOREACH (ID *, id, which_libbase(bmain, ID_MA)) {
+            if (id_matches_bake_reference(*id, id_code, name, library_path)) {
+              return DEG_get_evaluated_id(ctx.depsgraph, id);
+            }
+          }
+          return nullptr;
+        }
+        for (ID *id : used_ids) {
+          ID *id_orig = DEG_get_original_id(id);
+          if (id_matches_bake_reference(*id_orig, id_code, name, library_path)) {
+            return DEG_get_evaluated_id(ctx.depsgraph, id_orig);
+          }
+        }
+        return nullptr;
+      });
+  if (!baked_geometry) {
+    return false;
+  }
+  geometry_set = std::move(*baked_geometry);
+  return true;
+}
+
 static void modifyGeometry(ModifierData *md,
                            const ModifierEvalContext *ctx,
                            GeometrySet &geometry_set)
@@ -1084,6 +1207,18 @@ static void modifyGeometry(ModifierData *md,
     return;
   }
 
+  const std::string bake_filepath = get_bake_filepath(*nmd, *ctx);
+  const bool write_bake = !bake_filepath.empty() && (nmd->flag & NODES_MODIFIER_BAKE_WRITE) &&
+                          DEG_is_active(ctx->depsgraph);
+  if (!bake_filepath.empty() && !write_bake) {
+    if (try_read_baked_geometry(*nmd, *ctx, bake_filepath, geometry_set)) {
+      return;
+    }
+    if (BLI_exists(bake_filepath.c_str())) {
+      BKE_modifier_set_error(ctx->object, md, "Could not read baked geometry");
+    }
+  }
+
   check_property_socket_sync(ctx->object, md);
 
   NodeTreeRefMap tree_refs;
@@ -1121,6 +1256,13 @@ static void modifyGeometry(ModifierData *md,
 
   geometry_set = compute_geometry(
       tree, input_nodes, output_node, std::move(geometry_set), nmd, ctx);
+
+  if (write_bake) {
+    BLI_make_existing_file(bake_filepath.c_str());
+    if (!blender::bke::geometry_set_bake_write(geometry_set, bake_filepath.c_str())) {
+      BKE_modifier_set_error(ctx->object, md, "Could not write baked geometry");
+    }
+  }
 }
 
 static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *mesh)
@@ -1503,6 +1645,21 @@ static void output_attribute_panel_draw(const bContext *C, Panel *panel)
   }
 }
 
+static void bake_panel_draw(const bContext *UNUSED(C), Panel *panel)
+{
+  uiLayout *layout = panel->layout;
+
+  PointerRNA *ptr = modifier_panel_get_property_pointers(panel, nullptr);
+
+  uiLayoutSetPropSep(layout, true);
+  uiLayoutSetPropDecorate(layout, false);
+
+  uiItemR(layout, ptr, "bake_directory", 0, nullptr, ICON_NONE);
+  uiLayout *row = uiLayoutRow(layout, false);
+  uiLayoutSetActive(row, RNA_string_length(ptr, "bake_directory") > 0);
+  uiItemR(row, ptr, "use_bake_write", 0, nullptr, ICON_NONE);
+}
+
 static void panelRegister(ARegionType *region_type)
 {
   PanelType *panel_type = modifier_panel_register(region_type, eModifierType_Nodes, panel_draw);
@@ -1512,6 +1669,8 @@ static void panelRegister(ARegionType *region_type)
                              nullptr,
                              output_attribute_panel_draw,
                              panel_type);
+  modifier_subpanel_register(
+      region_type, "bake", N_("Bake"), nullptr, bake_panel_draw, panel_type);
 }
 
 static void blendWrite(BlendWriter *writer, const ModifierData *md)
@@ -1595,7 +1754,7 @@ ModifierTypeInfo modifierType_Nodes = {
     /* freeData */ freeData,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
-    /* dependsOnTime */ nullptr,
+    /* dependsOnTime */ dependsOnTime,
     /* dependsOnNormals */ nullptr,
     /* foreachIDLink */ foreachIDLink,
     /* foreachTexLink */ foreachTexLink,
@@ -0,0 +1,242 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "MOD_nodes.h"
+#include "MOD_nodes_cache.hh"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_float4x4.hh"
+
+#include "DNA_color_types.h"
+#include "DNA_genfile.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_node_types.h"
+#include "DNA_sdna_types.h"
+
+#include "BKE_node.h"
+
+#include "BKE_geometry_set.hh"
+
+namespace blender::modifiers::geometry_nodes {
+
+/** The cache is cleared by removing the oldest entries when it becomes larger than this. */
+static constexpr int64_t node_output_cache_memory_limit = int64_t(512) * 1024 * 1024;
+
+static void append_cache_key_curve_mapping(Vector<char> &buffer, const CurveMapping &curve_mapping)
+{
+  /* Pointers and evaluation tables change for every copy of the node tree, only add the points. */
+  append_cache_key_value(buffer, curve_mapping.flag);
+  append_cache_key_value(buffer, curve_mapping.preset);
+  append_cache_key_value(buffer, curve_mapping.clipr);
+  append_cache_key_value(buffer, curve_mapping.black);
+  append_cache_key_value(buffer, curve_mapping.white);
+  append_cache_key_value(buffer, curve_mapping.tone);
+  for (const CurveMap &curve_map : curve_mapping.cm) {
+    append_cache_key_value(buffer, curve_map.totpoint);
+    append_cache_key_value(buffer, curve_map.ext_in);
+    append_cache_key_value(buffer, curve_map.ext_out);
+    if (curve_map.curve != nullptr) {
+      append_cache_key_bytes(buffer, curve_map.curve, sizeof(CurveMapPoint) * curve_map.totpoint);
+    }
+  }
+}
+
+/** Whether the struct or any struct embedded in it has pointer members. */
+static bool dna_struct_has_pointers(const SDNA &sdna, const int struct_nr)
+{
+  const SDNA_Struct &struct_info = *sdna.structs[struct_nr];
+  for (const int i : IndexRange(struct_info.members_len)) {
+    const SDNA_StructMember &member = struct_info.members[i];
+    const char *name = sdna.names[member.name];
+    /* Pointers and function pointers. */
+    if (ELEM(name[0], '*', '(')) {
+      return true;
+    }
+    const int member_struct_nr = DNA_struct_find_nr(&sdna, sdna.types[member.type]);
+    if (member_struct_nr != -1 && dna_struct_has_pointers(sdna, member_struct_nr)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool append_cache_key_node_storage(Vector<char> &buffer, const bNode &node)
+{
+  if (node.storage == nullptr) {
+    return true;
+  }
+  const char *storagename = node.typeinfo->storagename;
+  if (STREQ(storagename, "NodeInputString")) {
+    const char *string = static_cast<const NodeInputString *>(node.storage)->string;
+    const StringRef string_ref = string == nullptr ? "" : string;
+    append_cache_key_value(buffer, string_ref.size());
+    append_cache_key_bytes(buffer, string_ref.data(), string_ref.size());
+    return true;
+  }
+  if (STREQ(storagename, "CurveMapping")) {
+    append_cache_key_curve_mapping(buffer, *static_cast<const CurveMapping *>(node.storage));
+    return true;
+  }
+
+  const SDNA &sdna = *DNA_sdna_current_get();
+  const int struct_nr = DNA_struct_find_nr(&sdna, storagename);
+  if (struct_nr == -1 || dna_struct_has_pointers(sdna, struct_nr)) {
+    return false;
+  }
+  append_cache_key_bytes(buffer, node.storage, MEM_allocN_len(node.storage));
+  return true;
+}
+
+static int64_t estimate_geometry_memory_size(const GeometrySet &geometry_set)
+{
+  int64_t size = 0;
+  for (const GeometryComponent *component : geometry_set.get_components_for_read()) {
+    component->attribute_foreach(
+        [&](const bke::AttributeIDRef &UNUSED(attribute_id), const AttributeMetaData &meta_data) {
+          const fn::CPPType *type = bke::custom_data_type_to_cpp_type(meta_data.data_type);
+          if (type != nullptr) {
+            size += type->size() * component->attribute_domain_size(meta_data.domain);
+          }
+          return true;
+        });
+    if (component->type() == GEO_COMPONENT_TYPE_MESH) {
+      /* The topology of meshes is not stored in attributes. */
+      const Mesh *mesh = static_cast<const MeshComponent *>(component)->get_for_read();
+      if (mesh != nullptr) {
+        size += sizeof(MEdge) * mesh->totedge + sizeof(MLoop) * mesh->totloop +
+                sizeof(MPoly) * mesh->totpoly;
+      }
+    }
+    else if (component->type() == GEO_COMPONENT_TYPE_INSTANCES) {
+      const InstancesComponent &instances = *static_cast<const InstancesComponent *>(component);
+      size += (sizeof(float4x4) + sizeof(int)) * instances.instances_amount();
+    }
+  }
+  return size;
+}
+
+CachedNodeOutputs::CachedNodeOutputs(const int outputs_num) : values_(outputs_num)
+{
+}
+
+CachedNodeOutputs::~CachedNodeOutputs()
+{
+  for (GMutablePointer &value : values_) {
+    if (value.get() != nullptr) {
+      value.destruct();
+      MEM_freeN(value.get());
+    }
+  }
+}
+
+void CachedNodeOutputs::store_copy(const int index, const GPointer value)
+{
+  BLI_assert(values_[index].get() == nullptr);
+  const fn::CPPType &type = *value.type();
+  void *buffer = MEM_mallocN_aligned(type.size(), type.alignment(), __func__);
+  type.copy_construct(value.get(), buffer);
+  values_[index] = {type, buffer};
+
+  memory_size_ += type.size();
+  if (type.is<GeometrySet>()) {
+    GeometrySet &geometry_set = *static_cast<GeometrySet *>(buffer);
+    geometry_set.ensure_owns_direct_data();
+    memory_size_ += estimate_geometry_memory_size(geometry_set);
+  }
+}
+
+GPointer CachedNodeOutputs::lookup(const int index) const
+{
+  return values_[index];
+}
+
+NodeOutputCache::NodeOutputCache(const int64_t memory_limit) : memory_limit_(memory_limit)
+{
+}
+
+std::shared_ptr<const CachedNodeOutputs> NodeOutputCache::lookup(const NodeOutputCacheKey &key)
+{
+  std::lock_guard lock{mutex_};
+  Entry *entry = entries_.lookup_ptr(key);
+  if (entry == nullptr) {
+    return {};
+  }
+  entry->last_use = ++use_counter_;
+  return entry->outputs;
+}
+
+void NodeOutputCache::add(const NodeOutputCacheKey &key,
+                          std::shared_ptr<const CachedNodeOutputs> outputs)
+{
+  const int64_t memory_size = outputs->memory_size();
+  if (memory_size > memory_limit_) {
+    return;
+  }
+
+  std::lock_guard lock{mutex_};
+  Entry new_entry{std::move(outputs), ++use_counter_};
+  entries_.add_or_modify(
+      key,
+      [&](Entry *entry) {
+        new (entry) Entry(std::move(new_entry));
+        memory_size_ += memory_size;
+      },
+      [&](Entry *entry) {
+        memory_size_ += memory_size - entry->outputs->memory_size();
+        *entry = std::move(new_entry);
+      });
+  while (memory_size_ > memory_limit_) {
+    this->remove_least_recently_used();
+  }
+}
+
+void NodeOutputCache::clear()
+{
+  std::lock_guard lock{mutex_};
+  entries_.clear();
+  memory_size_ = 0;
+}
+
+void NodeOutputCache::remove_least_recently_used()
+{
+  BLI_assert(!entries_.is_empty());
+  const NodeOutputCacheKey *oldest_key = nullptr;
+  uint64_t oldest_use = UINT64_MAX;
+  for (auto item : entries_.items()) {
+    if (item.value.last_use < oldest_use) {
+      oldest_key = &item.key;
+      oldest_use = item.value.last_use;
+    }
+  }
+  const NodeOutputCacheKey key = *oldest_key;
+  memory_size_ -= entries_.lookup(key).outputs->memory_size();
+  entries_.remove(key);
+}
+
+NodeOutputCache &get_node_output_cache()
+{
+  static NodeOutputCache cache{node_output_cache_memory_limit};
+  return cache;
+}
+
+}  // namespace blender::modifiers::geometry_nodes
+
+void MOD_nodes_free_cache(void)
+{
+  blender::modifiers::geometry_nodes::get_node_output_cache().clear();
+}
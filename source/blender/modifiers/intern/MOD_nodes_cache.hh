@@ -0,0 +1,126 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "BLI_array.hh"
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
+
+#include "FN_generic_pointer.hh"
+
+struct bNode;
+
+namespace blender::modifiers::geometry_nodes {
+
+using fn::GMutablePointer;
+using fn::GPointer;
+
+/**
+ * Identifies the outputs of a node. It is a digest of the node's settings and of everything the
+ * node depends on, so nodes in different node trees or evaluations with the same key compute the
+ * same values.
+ */
+struct NodeOutputCacheKey {
+  uint64_t digest[2] = {0, 0};
+
+  uint64_t hash() const
+  {
+    return digest[0];
+  }
+
+  friend bool operator==(const NodeOutputCacheKey &a, const NodeOutputCacheKey &b)
+  {
+    return a.digest[0] == b.digest[0] && a.digest[1] == b.digest[1];
+  }
+};
+
+inline void append_cache_key_bytes(Vector<char> &buffer, const void *data, const int64_t size)
+{
+  buffer.extend(Span<char>(static_cast<const char *>(data), size));
+}
+
+template<typename T> inline void append_cache_key_value(Vector<char> &buffer, const T &value)
+{
+  append_cache_key_bytes(buffer, &value, sizeof(T));
+}
+
+/**
+ * Add the settings in the storage of the node to the data the key is computed from. Storage with
+ * pointers is added by content for known types. Returns false for other storage with pointers,
+ * since their address does not identify the settings.
+ */
+bool append_cache_key_node_storage(Vector<char> &buffer, const bNode &node);
+
+/** Owned copies of the output values of a node, indexed by the output socket index. */
+class CachedNodeOutputs : NonCopyable, NonMovable {
+ private:
+  Array<GMutablePointer> values_;
+  int64_t memory_size_ = 0;
+
+ public:
+  CachedNodeOutputs(int outputs_num);
+  ~CachedNodeOutputs();
+
+  /** Store a copy of the value. Geometries are copied so that they own all of their data. */
+  void store_copy(int index, GPointer value);
+
+  /** The stored value, or a null pointer if the output has not been stored. */
+  GPointer lookup(int index) const;
+
+  /** Approximate number of bytes used by the stored values. */
+  int64_t memory_size() const
+  {
+    return memory_size_;
+  }
+};
+
+/**
+ * Keeps node outputs between evaluations, so that parts of a node tree that did not change do
+ * not have to be executed again, for example when only the end of the tree depends on an
+ * animated value. When the memory limit is exceeded, the least recently used entries are removed.
+ */
+class NodeOutputCache {
+ private:
+  struct Entry {
+    std::shared_ptr<const CachedNodeOutputs> outputs;
+    uint64_t last_use;
+  };
+
+  std::mutex mutex_;
+  Map<NodeOutputCacheKey, Entry> entries_;
+  uint64_t use_counter_ = 0;
+  int64_t memory_size_ = 0;
+  int64_t memory_limit_;
+
+ public:
+  NodeOutputCache(int64_t memory_limit);
+
+  /** The shared pointer keeps the values alive even when the entry is removed. */
+  std::shared_ptr<const CachedNodeOutputs> lookup(const NodeOutputCacheKey &key);
+  void add(const NodeOutputCacheKey &key, std::shared_ptr<const CachedNodeOutputs> outputs);
+  void clear();
+
+ private:
+  void remove_least_recently_used();
+};
+
+NodeOutputCache &get_node_output_cache();
+
+}  // namespace blender::modifiers::geometry_nodes
@@ -0,0 +1,59 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BLI_string.h"
+
+#include "DNA_node_types.h"
+
+#include "BKE_node.h"
+
+#include "MOD_nodes_cache.hh"
+
+namespace blender::modifiers::geometry_nodes::tests {
+
+static Vector<char> node_storage_key(const bNode &node)
+{
+  Vector<char> buffer;
+  EXPECT_TRUE(append_cache_key_node_storage(buffer, node));
+  return buffer;
+}
+
+TEST(node_output_cache, StringStorage)
+{
+  bNodeType type = {};
+  STRNCPY(type.storagename, "NodeInputString");
+  char string[16] = "Hello";
+  NodeInputString storage = {string};
+  bNode node = {};
+  node.typeinfo = &type;
+  node.storage = &storage;
+
+  const Vector<char> key = node_storage_key(node);
+
+  /* A changed string at the same address must give a different key. */
+  STRNCPY(string, "World");
+  EXPECT_NE(node_storage_key(node), key);
+
+  /* The same string at a different address must give the same key. */
+  char other_string[16] = "Hello";
+  storage.string = other_string;
+  EXPECT_EQ(node_storage_key(node), key);
+}
+
+}  // namespace blender::modifiers::geometry_nodes::tests
@@ -14,8 +14,11 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "MOD_nodes_cache.hh"
 #include "MOD_nodes_evaluator.hh"
 
+#include "MEM_guardedalloc.h"
+
 #include "NOD_geometry_exec.hh"
 #include "NOD_socket_declarations.hh"
 #include "NOD_type_conversions.hh"
@@ -30,12 +33,14 @@
 #include "BLT_translation.h"
 
 #include "BLI_enumerable_thread_specific.hh"
+#include "BLI_hash_md5.h"
 #include "BLI_stack.hh"
 #include "BLI_task.h"
 #include "BLI_task.hh"
 #include "BLI_vector_set.hh"
 
 #include <chrono>
+#include <optional>
 
 namespace blender::modifiers::geometry_nodes {
 
@@ -238,6 +243,43 @@ struct NodeState {
    * not run twice at the same time accidentally.
    */
   NodeScheduleState schedule_state = NodeScheduleState::NotScheduled;
+
+  /**
+   * Execution time of the node that is expected based on previous evaluations of nodes with the
+   * same type. This does not change during evaluation, so it can be read without locking.
+   */
+  float estimated_cost_us = 0.0f;
+
+  /**
+   * Estimated cost of the most expensive path from this node to the outputs, including the node
+   * itself. When multiple nodes are scheduled at the same time, the ones with the highest cost are
+   * started first. This does not change during evaluation, so it can be read without locking.
+   */
+  float critical_path_cost_us = -1.0f;
+
+  /**
+   * Total time spent executing this node. Only accessed by the thread that is running the node.
+   */
+  std::chrono::microseconds execution_time{0};
+
+  /**
+   * True when the outputs of the node only depend on the node tree and on modifier inputs that
+   * can be hashed. Then `cache_key` identifies the outputs in the #NodeOutputCache.
+   */
+  bool is_cacheable = false;
+  NodeOutputCacheKey cache_key;
+
+  /**
+   * Outputs computed by a previous evaluation. When this is set, copies of the outputs are
+   * forwarded instead of executing the node, and the node's inputs are not used.
+   */
+  std::shared_ptr<const CachedNodeOutputs> cached_outputs;
+
+  /**
+   * Copies of the computed outputs, which are added to the cache after the evaluation. Only
+   * accessed by the thread that is running the node.
+   */
+  std::unique_ptr<CachedNodeOutputs> outputs_to_cache;
 };
 
 /**
@@ -386,11 +428,139 @@ static bool node_supports_laziness(const DNode node)
   return node->typeinfo()->geometry_node_execute_supports_laziness;
 }
 
+/**
+ * Nodes that use data from outside of the node tree, like other objects, images or the evaluation
+ * mode, can't be cached, because their outputs can change without any change in the node tree.
+ */
+static bool node_supports_output_caching(const DNode node)
+{
+  if (node->is_group_input_node() || node->is_group_output_node() || node->is_undefined()) {
+    return false;
+  }
+  const bNode &bnode = *node->bnode();
+  if (bnode.id != nullptr || bnode.type == GEO_NODE_IS_VIEWPORT) {
+    return false;
+  }
+  for (const InputSocketRef *socket : node->inputs()) {
+    if (socket->is_available() &&
+        ELEM(socket->bsocket()->type,
+             SOCK_OBJECT,
+             SOCK_COLLECTION,
+             SOCK_IMAGE,
+             SOCK_TEXTURE,
+             SOCK_MATERIAL)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void append_cache_key_socket_value(Vector<char> &buffer, const bNodeSocket &socket)
+{
+  if (socket.default_value != nullptr) {
+    append_cache_key_bytes(buffer, socket.default_value, MEM_allocN_len(socket.default_value));
+  }
+}
+
+/** Returns false when the value can't be part of a cache key, like geometries and fields. */
+static bool append_cache_key_group_input(Vector<char> &buffer, const GPointer value)
+{
+  const CPPType *type = value.type();
+  const void *data = value.get();
+  if (const ValueOrFieldCPPType *value_or_field_type = dynamic_cast<const ValueOrFieldCPPType *>(
+          type)) {
+    if (value_or_field_type->is_field(data)) {
+      return false;
+    }
+    type = &value_or_field_type->base_type();
+    data = value_or_field_type->get_value_ptr(data);
+  }
+  if (type->is_trivial()) {
+    append_cache_key_bytes(buffer, data, type->size());
+    return true;
+  }
+  if (type->is_hashable()) {
+    append_cache_key_value(buffer, type->hash(data));
+    return true;
+  }
+  return false;
+}
+
 struct NodeTaskRunState {
   /** The node that should be run on the same thread after the current node finished. */
   DNode next_node_to_run;
+  /**
+   * Nodes that are so cheap to compute, including everything that depends on them, that running
+   * them on the current thread after #next_node_to_run is faster than sending them through the
+   * task pool.
+   */
+  Vector<DNode> cheap_nodes_to_run;
+};
+
+/**
+ * Cost that is assumed for node types that have not been executed before. Unknown nodes are
+ * never run inline.
+ */
+static constexpr float unknown_node_cost_us = 1000.0f;
+
+/**
+ * When all the work that depends on a scheduled node is estimated to take less time than this,
+ * it is run on the same thread instead of being added to the task pool.
+ */
+static constexpr float inline_node_cost_threshold_us = 50.0f;
+
+/**
+ * Outputs of cacheable nodes are only kept when computing them is estimated to take longer than
+ * this. Sharing values with the cache means that later nodes have to copy geometries that they
+ * could have modified in place otherwise.
+ */
+static constexpr float min_cached_outputs_cost_us = 1000.0f;
+
+/**
+ * Keeps track of the average execution time of every node type across evaluations, so that the
+ * cost of a node can be estimated before it runs. The statistics are only accessed once at the
+ * beginning and once at the end of an evaluation, to avoid locking while nodes are running.
+ */
+class NodeCostStatistics {
+ private:
+  std::mutex mutex_;
+  Map<std::string, float> average_cost_us_;
+
+ public:
+  void estimate_costs(Span<NodeWithState> node_states)
+  {
+    std::lock_guard lock{mutex_};
+    for (const NodeWithState &item : node_states) {
+      item.state->estimated_cost_us = average_cost_us_.lookup_default_as(item.node->idname(),
+                                                                         unknown_node_cost_us);
+    }
+  }
+
+  void add_measurements(Span<NodeWithState> node_states)
+  {
+    std::lock_guard lock{mutex_};
+    for (const NodeWithState &item : node_states) {
+      if (!item.state->has_been_executed || item.state->cached_outputs) {
+        continue;
+      }
+      const float cost_us = item.state->execution_time.count();
+      average_cost_us_.add_or_modify(
+          item.node->idname(),
+          [&](float *average) { *average = cost_us; },
+          [&](float *average) {
+            /* Use a moving average so the estimate adapts when the input data changes. */
+            *average = *average * 0.75f + cost_us * 0.25f;
+          });
+    }
+  }
 };
 
+static NodeCostStatistics &get_node_cost_statistics()
+{
+  static NodeCostStatistics statistics;
+  return statistics;
+}
+
 /** Implements the callbacks that might be called when a node is executed. */
 class NodeParamsProvider : public nodes::GeoNodeExecParamsProvider {
  private:
@@ -443,6 +613,12 @@ class GeometryNodesEvaluator {
    */
   VectorSet<NodeWithState> node_states_;
 
+  /**
+   * Keys of the outputs of nodes in the #NodeOutputCache, or nothing for nodes whose outputs
+   * can't be cached. Only used while the node states are created.
+   */
+  Map<DNode, std::optional<NodeOutputCacheKey>> node_cache_keys_;
+
   /**
    * Contains all the tasks for the nodes that are currently scheduled.
    */
@@ -473,6 +649,9 @@ class GeometryNodesEvaluator {
     BLI_task_pool_work_and_wait(task_pool_);
     BLI_task_pool_free(task_pool_);
 
+    get_node_cost_statistics().add_measurements(node_states_);
+    this->add_outputs_to_cache();
+
     this->extract_group_outputs();
     this->destruct_node_states();
   }
@@ -501,6 +680,11 @@ class GeometryNodesEvaluator {
       NodeState &node_state = *allocator.construct<NodeState>().release();
       node_states_.add_new({node, &node_state});
 
+      if (this->try_use_cached_outputs(node, node_state)) {
+        /* The inputs of the node are not used, so the nodes they depend on are not needed. */
+        continue;
+      }
+
       /* Push all linked origins on the stack. */
       for (const InputSocketRef *input_ref : node->inputs()) {
         const DInputSocket input{node.context(), input_ref};
@@ -527,6 +711,277 @@ class GeometryNodesEvaluator {
         node_state.inputs[socket->index()].force_compute = true;
       }
     }
+
+    get_node_cost_statistics().estimate_costs(node_states_);
+    this->compute_critical_path_costs();
+    this->prepare_outputs_to_cache();
+  }
+
+  /**
+   * Find the outputs of the node in the cache. This only succeeds when all outputs that may be
+   * used have been cached, and when no input of the node has to be computed for logging.
+   */
+  bool try_use_cached_outputs(const DNode node, NodeState &node_state)
+  {
+    const std::optional<NodeOutputCacheKey> key = this->get_cache_key(node);
+    if (!key) {
+      return false;
+    }
+    node_state.is_cacheable = true;
+    node_state.cache_key = *key;
+
+    for (const DSocket &socket : params_.force_compute_sockets) {
+      if (socket.node() == node && socket->is_input()) {
+        return false;
+      }
+    }
+
+    std::shared_ptr<const CachedNodeOutputs> cached_outputs = get_node_output_cache().lookup(*key);
+    if (!cached_outputs) {
+      return false;
+    }
+    for (const OutputSocketRef *output_ref : node->outputs()) {
+      if (!output_ref->is_available() || get_socket_cpp_type(*output_ref) == nullptr) {
+        continue;
+      }
+      if (cached_outputs->lookup(output_ref->index()).get() != nullptr) {
+        continue;
+      }
+      bool is_linked = false;
+      const DOutputSocket output{node.context(), output_ref};
+      output.foreach_target_socket(
+          [&](const DInputSocket UNUSED(target_socket),
+              const DOutputSocket::TargetSocketPathInfo &UNUSED(path_info)) { is_linked = true; });
+      if (is_linked) {
+        return false;
+      }
+    }
+    node_state.cached_outputs = std::move(cached_outputs);
+    return true;
+  }
+
+  /**
+   * The key identifies the outputs of the node. It contains the settings of the node and of all
+   * nodes it depends on, and the values of the modifier inputs that are used. Returns nothing when
+   * the outputs can't be cached.
+   */
+  std::optional<NodeOutputCacheKey> get_cache_key(const DNode node)
+  {
+    /* Compute the keys of the nodes this node depends on first, without recursion. */
+    Stack<DNode> nodes_to_check;
+    nodes_to_check.push(node);
+    while (!nodes_to_check.is_empty()) {
+      const DNode node_to_check = nodes_to_check.peek();
+      if (node_cache_keys_.contains(node_to_check)) {
+        nodes_to_check.pop();
+        continue;
+      }
+      if (!node_supports_output_caching(node_to_check)) {
+        node_cache_keys_.add_new(node_to_check, std::nullopt);
+        nodes_to_check.pop();
+        continue;
+      }
+      bool all_origins_handled = true;
+      for (const InputSocketRef *input_ref : node_to_check->inputs()) {
+        if (!input_ref->is_available()) {
+          continue;
+        }
+        const DInputSocket input{node_to_check.context(), input_ref};
+        input.foreach_origin_socket([&](const DSocket origin) {
+          const DNode origin_node = origin.node();
+          if (origin->is_output() && !origin_node->is_group_input_node() &&
+              !node_cache_keys_.contains(origin_node)) {
+            nodes_to_check.push(origin_node);
+            all_origins_handled = false;
+          }
+        });
+      }
+      if (all_origins_handled) {
+        node_cache_keys_.add_new(node_to_check, this->compute_cache_key(node_to_check));
+        nodes_to_check.pop();
+      }
+    }
+    return node_cache_keys_.lookup(node);
+  }
+
+  /** Expects that the keys of all nodes this node depends on have been computed already. */
+  std::optional<NodeOutputCacheKey> compute_cache_key(const DNode node)
+  {
+    const bNode &bnode = *node->bnode();
+    Vector<char> buffer;
+    append_cache_key_bytes(buffer, bnode.idname, strlen(bnode.idname));
+    append_cache_key_value(buffer, bnode.custom1);
+    append_cache_key_value(buffer, bnode.custom2);
+    append_cache_key_value(buffer, bnode.custom3);
+    append_cache_key_value(buffer, bnode.custom4);
+    if (!append_cache_key_node_storage(buffer, bnode)) {
+      return std::nullopt;
+    }
+
+    for (const InputSocketRef *input_ref : node->inputs()) {
+      if (!input_ref->is_available() || get_socket_cpp_type(*input_ref) == nullptr) {
+        continue;
+      }
+      append_cache_key_value(buffer, input_ref->index());
+      bool is_linked = false;
+      bool is_cacheable = true;
+      const DInputSocket input{node.context(), input_ref};
+      input.foreach_origin_socket([&](const DSocket origin) {
+        is_linked = true;
+        if (origin->is_input()) {
+          /* An unlinked input of a group node. */
+          append_cache_key_socket_value(buffer, *origin->bsocket());
+        }
+        else if (origin.node()->is_group_input_node()) {
+          const GMutablePointer *value = params_.input_values.lookup_ptr(DOutputSocket(origin));
+          if (value == nullptr || !append_cache_key_group_input(buffer, *value)) {
+            is_cacheable = false;
+          }
+        }
+        else {
+          const std::optional<NodeOutputCacheKey> &origin_key = node_cache_keys_.lookup(
+              origin.node());
+          if (origin_key) {
+            append_cache_key_value(buffer, *origin_key);
+            append_cache_key_value(buffer, origin->index());
+          }
+          else {
+            is_cacheable = false;
+          }
+        }
+      });
+      if (!is_cacheable) {
+        return std::nullopt;
+      }
+      if (!is_linked) {
+        append_cache_key_socket_value(buffer, *input_ref->bsocket());
+      }
+    }
+
+    NodeOutputCacheKey key;
+    BLI_hash_md5_buffer(buffer.data(), buffer.size(), key.digest);
+    return key;
+  }
+
+  /**
+   * Cacheable nodes whose outputs are used by nodes that can't be cached keep copies of their
+   * outputs, so that later evaluations only have to execute the nodes that can't be cached.
+   */
+  void prepare_outputs_to_cache()
+  {
+    for (const NodeWithState &item : node_states_) {
+      NodeState &node_state = *item.state;
+      if (!node_state.is_cacheable || node_state.cached_outputs) {
+        continue;
+      }
+      if (!this->has_uncacheable_target(item.node)) {
+        continue;
+      }
+      if (this->estimate_cost_with_dependencies(item.node) < min_cached_outputs_cost_us) {
+        continue;
+      }
+      node_state.outputs_to_cache = std::make_unique<CachedNodeOutputs>(
+          item.node->outputs().size());
+    }
+  }
+
+  bool has_uncacheable_target(const DNode node)
+  {
+    bool found = false;
+    for (const OutputSocketRef *output_ref : node->outputs()) {
+      const DOutputSocket output{node.context(), output_ref};
+      output.foreach_target_socket(
+          [&](const DInputSocket target_socket,
+              const DOutputSocket::TargetSocketPathInfo &UNUSED(path_info)) {
+            const NodeWithState *target = node_states_.lookup_key_ptr_as(target_socket.node());
+            if (target != nullptr && !target->state->is_cacheable) {
+              found = true;
+            }
+          });
+    }
+    return found;
+  }
+
+  /** Sum of the estimated costs of the node and of all the nodes it depends on. */
+  float estimate_cost_with_dependencies(const DNode node)
+  {
+    float cost_us = 0.0f;
+    Set<DNode> handled_nodes;
+    Stack<DNode> nodes_to_check;
+    nodes_to_check.push(node);
+    while (!nodes_to_check.is_empty()) {
+      const DNode node_to_check = nodes_to_check.pop();
+      if (!handled_nodes.add(node_to_check)) {
+        continue;
+      }
+      cost_us += this->get_node_state(node_to_check).estimated_cost_us;
+      for (const InputSocketRef *input_ref : node_to_check->inputs()) {
+        const DInputSocket input{node_to_check.context(), input_ref};
+        input.foreach_origin_socket([&](const DSocket origin) {
+          const DNode origin_node = origin.node();
+          if (origin->is_output() && !origin_node->is_group_input_node() &&
+              node_states_.contains_as(origin_node)) {
+            nodes_to_check.push(origin_node);
+          }
+        });
+      }
+    }
+    return cost_us;
+  }
+
+  void add_outputs_to_cache()
+  {
+    NodeOutputCache &cache = get_node_output_cache();
+    for (const NodeWithState &item : node_states_) {
+      NodeState &node_state = *item.state;
+      if (node_state.outputs_to_cache) {
+        cache.add(node_state.cache_key, std::move(node_state.outputs_to_cache));
+      }
+    }
+  }
+
+  /**
+   * Compute the cost of the most expensive path from every node to the outputs. A node's cost
+   * only depends on the nodes that use its outputs, so those are handled first.
+   */
+  void compute_critical_path_costs()
+  {
+    Stack<DNode> nodes_to_check;
+    for (const NodeWithState &item : node_states_) {
+      nodes_to_check.push(item.node);
+      while (!nodes_to_check.is_empty()) {
+        const DNode node = nodes_to_check.peek();
+        NodeState &node_state = this->get_node_state(node);
+        if (node_state.critical_path_cost_us >= 0.0f) {
+          nodes_to_check.pop();
+          continue;
+        }
+        bool all_targets_computed = true;
+        float max_target_cost_us = 0.0f;
+        for (const OutputSocketRef *output_ref : node->outputs()) {
+          const DOutputSocket output{node.context(), output_ref};
+          output.foreach_target_socket(
+              [&](const DInputSocket target_socket,
+                  const DOutputSocket::TargetSocketPathInfo &UNUSED(path_info)) {
+                const NodeWithState *target = node_states_.lookup_key_ptr_as(target_socket.node());
+                if (target == nullptr) {
+                  return;
+                }
+                if (target->state->critical_path_cost_us < 0.0f) {
+                  nodes_to_check.push(target->node);
+                  all_targets_computed = false;
+                  return;
+                }
+                max_target_cost_us = std::max(max_target_cost_us,
+                                              target->state->critical_path_cost_us);
+              });
+        }
+        if (all_targets_computed) {
+          node_state.critical_path_cost_us = node_state.estimated_cost_us + max_target_cost_us;
+          nodes_to_check.pop();
+        }
+      }
+    }
   }
 
   void initialize_node_state(const DNode node, NodeState &node_state, LinearAllocator<> &allocator)
@@ -539,6 +994,12 @@ class GeometryNodesEvaluator {
     for (const int i : node->inputs().index_range()) {
       InputState &input_state = node_state.inputs[i];
       const DInputSocket socket = node.input(i);
+      if (node_state.cached_outputs) {
+        /* The outputs are copied from the cache, so the inputs are never used. */
+        input_state.type = nullptr;
+        input_state.usage = ValueUsage::Unused;
+        continue;
+      }
       if (!socket->is_available()) {
         /* Unavailable sockets should never be used. */
         input_state.type = nullptr;
@@ -587,10 +1048,15 @@ class GeometryNodesEvaluator {
           [&, this](const DInputSocket target_socket,
                     const DOutputSocket::TargetSocketPathInfo &UNUSED(path_info)) {
             const DNode target_node = target_socket.node();
-            if (!this->node_states_.contains_as(target_node)) {
+            const NodeWithState *target = this->node_states_.lookup_key_ptr_as(target_node);
+            if (target == nullptr) {
               /* The target node is not computed because it is not computed to the output. */
               return;
             }
+            if (target->state->cached_outputs) {
+              /* The target node does not use its inputs. */
+              return;
+            }
             output_state.potential_users += 1;
           });
       if (output_state.potential_users == 0) {
@@ -721,17 +1187,26 @@ class GeometryNodesEvaluator {
     const NodeWithState *root_node_with_state = (const NodeWithState *)task_data;
 
     /* First, the node provided by the task pool is executed. During the execution other nodes
-     * might be scheduled. One of those nodes is not added to the task pool but is executed in the
-     * loop below directly. This has two main benefits:
+     * might be scheduled. Some of those nodes are not added to the task pool but are executed in
+     * the loop below directly. This has two main benefits:
      * - Fewer round trips through the task pool which add threading overhead.
      * - Helps with cpu cache efficiency, because a thread is more likely to process data that it
      *   has processed shortly before.
      */
-    DNode next_node_to_run = root_node_with_state->node;
-    while (next_node_to_run) {
-      NodeTaskRunState run_state;
-      evaluator.node_task_run(next_node_to_run, &run_state);
-      next_node_to_run = run_state.next_node_to_run;
+    NodeTaskRunState run_state;
+    run_state.next_node_to_run = root_node_with_state->node;
+    while (true) {
+      DNode node_to_run = run_state.next_node_to_run;
+      if (node_to_run) {
+        run_state.next_node_to_run = {};
+      }
+      else if (!run_state.cheap_nodes_to_run.is_empty()) {
+        node_to_run = run_state.cheap_nodes_to_run.pop_last();
+      }
+      else {
+        break;
+      }
+      evaluator.node_task_run(node_to_run, &run_state);
     }
   }
 
@@ -932,20 +1407,34 @@ class GeometryNodesEvaluator {
     }
     node_state.has_been_executed = true;
 
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point begin = Clock::now();
+
+    if (node_state.cached_outputs) {
+      this->execute_cached_node(node, node_state, run_state);
+    }
     /* Use the geometry node execute callback if it exists. */
-    if (bnode.typeinfo->geometry_node_execute != nullptr) {
+    else if (bnode.typeinfo->geometry_node_execute != nullptr) {
       this->execute_geometry_node(node, node_state, run_state);
-      return;
     }
-
-    /* Use the multi-function implementation if it exists. */
-    const nodes::NodeMultiFunctions::Item &fn_item = params_.mf_by_node->try_get(node);
-    if (fn_item.fn != nullptr) {
-      this->execute_multi_function_node(node, fn_item, node_state, run_state);
-      return;
+    else {
+      /* Use the multi-function implementation if it exists. */
+      const nodes::NodeMultiFunctions::Item &fn_item = params_.mf_by_node->try_get(node);
+      if (fn_item.fn != nullptr) {
+        this->execute_multi_function_node(node, fn_item, node_state, run_state);
+      }
+      else {
+        this->execute_unknown_node(node, node_state, run_state);
+      }
     }
 
-    this->execute_unknown_node(node, node_state, run_state);
+    Clock::time_point end = Clock::now();
+    const std::chrono::microseconds duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+    node_state.execution_time += duration;
+    if (params_.geo_logger != nullptr) {
+      params_.geo_logger->local().log_execution_time(node, duration);
+    }
   }
 
   void execute_geometry_node(const DNode node, NodeState &node_state, NodeTaskRunState *run_state)
@@ -958,15 +1447,7 @@ class GeometryNodesEvaluator {
       params.error_message_add(geo_log::NodeWarningType::Legacy,
                                TIP_("Legacy node will be removed before Blender 4.0"));
     }
-    using Clock = std::chrono::steady_clock;
-    Clock::time_point begin = Clock::now();
     bnode.typeinfo->geometry_node_execute(params);
-    Clock::time_point end = Clock::now();
-    const std::chrono::microseconds duration =
-        std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    if (params_.geo_logger != nullptr) {
-      params_.geo_logger->local().log_execution_time(node, duration);
-    }
   }
 
   void execute_multi_function_node(const DNode node,
@@ -1110,6 +1591,28 @@ class GeometryNodesEvaluator {
     }
   }
 
+  /** Forward copies of the outputs that have been computed by a previous evaluation. */
+  void execute_cached_node(const DNode node, NodeState &node_state, NodeTaskRunState *run_state)
+  {
+    LinearAllocator<> &allocator = local_allocators_.local();
+    for (const int i : node->outputs().index_range()) {
+      OutputState &output_state = node_state.outputs[i];
+      if (output_state.has_been_computed ||
+          output_state.output_usage_for_execution == ValueUsage::Unused) {
+        continue;
+      }
+      const GPointer cached_value = node_state.cached_outputs->lookup(i);
+      if (cached_value.get() == nullptr) {
+        continue;
+      }
+      const CPPType &type = *cached_value.type();
+      void *buffer = allocator.allocate(type.size(), type.alignment());
+      type.copy_construct(cached_value.get(), buffer);
+      output_state.has_been_computed = true;
+      this->forward_output(node.output(i), {type, buffer}, run_state);
+    }
+  }
+
   void execute_unknown_node(const DNode node, NodeState &node_state, NodeTaskRunState *run_state)
   {
     LinearAllocator<> &allocator = local_allocators_.local();
@@ -1381,6 +1884,11 @@ class GeometryNodesEvaluator {
   {
     BLI_assert(value_to_forward.get() != nullptr);
 
+    NodeState &from_node_state = this->get_node_state(from_socket.node());
+    if (from_node_state.outputs_to_cache) {
+      from_node_state.outputs_to_cache->store_copy(from_socket->index(), value_to_forward);
+    }
+
     LinearAllocator<> &allocator = local_allocators_.local();
 
     Vector<DSocket> log_original_value_sockets;
@@ -1707,16 +2215,33 @@ class GeometryNodesEvaluator {
     for (const DOutputSocket &socket : locked_node.delayed_unused_outputs) {
       this->send_output_unused_notification(socket, run_state);
     }
+    if (locked_node.delayed_scheduled_nodes.size() > 1) {
+      /* Start the nodes with the most expensive work depending on them first. The sort is stable,
+       * so when the costs are equal, the first scheduled node is still run on the same thread.
+       * That is usually best, because the geometry socket which carries the most data usually
+       * comes first in nodes. */
+      std::stable_sort(locked_node.delayed_scheduled_nodes.begin(),
+                       locked_node.delayed_scheduled_nodes.end(),
+                       [&](const DNode a, const DNode b) {
+                         return this->get_node_state(a).critical_path_cost_us >
+                                this->get_node_state(b).critical_path_cost_us;
+                       });
+    }
     for (const DNode &node_to_schedule : locked_node.delayed_scheduled_nodes) {
       if (run_state != nullptr && !run_state->next_node_to_run) {
         /* Execute the node on the same thread after the current node finished. */
-        /* Currently, this assumes that it is always best to run the first node that is scheduled
-         * on the same thread. That is usually correct, because the geometry socket which carries
-         * the most data usually comes first in nodes. */
         run_state->next_node_to_run = node_to_schedule;
       }
+      else if (run_state != nullptr &&
+               this->get_node_state(node_to_schedule).critical_path_cost_us <
+                   inline_node_cost_threshold_us) {
+        /* Not worth the overhead of the task pool, run the node on this thread afterwards. */
+        run_state->cheap_nodes_to_run.append(node_to_schedule);
+      }
       else {
-        /* Push the node to the task pool so that another thread can start working on it. */
+        /* Push the node to the task pool so that another thread can start working on it. Nodes
+         * with more expensive work depending on them are pushed first, so they are more likely
+         * to be picked up by other threads earlier. */
         this->add_node_to_task_pool(node_to_schedule);
       }
     }
@@ -291,7 +291,10 @@ class NodeLog {
   Vector<SocketLog> output_logs_;
   Vector<NodeWarning, 0> warnings_;
   Vector<std::string, 0> debug_messages_;
-  std::chrono::microseconds exec_time_;
+  std::chrono::microseconds exec_time_{0};
+  std::chrono::microseconds longest_exec_time_{0};
+  int exec_count_ = 0;
+  int exec_thread_ = -1;
 
   friend ModifierLog;
 
@@ -320,11 +323,34 @@ class NodeLog {
     return debug_messages_;
   }
 
+  /** The total time of all executions of the node, including fields evaluated by the node. */
   std::chrono::microseconds execution_time() const
   {
     return exec_time_;
   }
 
+  /** Nodes that support laziness can be executed more than once in one evaluation. */
+  int execution_count() const
+  {
+    return exec_count_;
+  }
+
+  /**
+   * Index of the thread that ran the longest execution of the node, or -1 if the node was not
+   * executed. The indices are only meaningful within a single evaluation.
+   */
+  int execution_thread() const
+  {
+    return exec_thread_;
+  }
+
+  /**
+   * The number of mesh vertices, edges and faces, curve splines, points and instances in all
+   * geometries passed to the node's input or output sockets. Values of multi-input sockets are
+   * not logged, so they are not counted.
+   */
+  int64_t geometry_elements_num(eNodeSocketInOut in_out) const;
+
   Vector<const GeometryAttributeInfo *> lookup_available_attributes() const;
 };
 
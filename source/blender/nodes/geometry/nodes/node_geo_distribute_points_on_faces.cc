@@ -14,7 +14,6 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
-#include "BLI_kdtree.h"
 #include "BLI_noise.hh"
 #include "BLI_rand.hh"
 #include "BLI_task.hh"
@@ -34,6 +33,8 @@
 #include "UI_interface.h"
 #include "UI_resources.h"
 
+#include "GEO_point_elimination.hh"
+
 #include "node_geometry_util.hh"
 
 namespace blender::nodes::node_geo_distribute_points_on_faces_cc {
@@ -93,6 +94,18 @@ static float3 normal_to_euler_rotation(const float3 normal)
   return rotation;
 }
 
+static float3 sample_looptri_point(const Mesh &mesh,
+                                   const MLoopTri &looptri,
+                                   const float3 &bary_coord)
+{
+  const float3 v0_pos = float3(mesh.mvert[mesh.mloop[looptri.tri[0]].v].co);
+  const float3 v1_pos = float3(mesh.mvert[mesh.mloop[looptri.tri[1]].v].co);
+  const float3 v2_pos = float3(mesh.mvert[mesh.mloop[looptri.tri[2]].v].co);
+  float3 point_pos;
+  interp_v3_v3v3v3(point_pos, v0_pos, v1_pos, v2_pos, bary_coord);
+  return point_pos;
+}
+
 static void sample_mesh_surface(const Mesh &mesh,
                                 const float base_density,
                                 const Span<float> density_factors,
@@ -104,94 +117,75 @@ static void sample_mesh_surface(const Mesh &mesh,
   const Span<MLoopTri> looptris{BKE_mesh_runtime_looptri_ensure(&mesh),
                                 BKE_mesh_runtime_looptri_len(&mesh)};
 
-  for (const int looptri_index : looptris.index_range()) {
-    const MLoopTri &looptri = looptris[looptri_index];
-    const int v0_loop = looptri.tri[0];
-    const int v1_loop = looptri.tri[1];
-    const int v2_loop = looptri.tri[2];
-    const int v0_index = mesh.mloop[v0_loop].v;
-    const int v1_index = mesh.mloop[v1_loop].v;
-    const int v2_index = mesh.mloop[v2_loop].v;
-    const float3 v0_pos = float3(mesh.mvert[v0_index].co);
-    const float3 v1_pos = float3(mesh.mvert[v1_index].co);
-    const float3 v2_pos = float3(mesh.mvert[v2_index].co);
-
-    float looptri_density_factor = 1.0f;
-    if (!density_factors.is_empty()) {
-      const float v0_density_factor = std::max(0.0f, density_factors[v0_loop]);
-      const float v1_density_factor = std::max(0.0f, density_factors[v1_loop]);
-      const float v2_density_factor = std::max(0.0f, density_factors[v2_loop]);
-      looptri_density_factor = (v0_density_factor + v1_density_factor + v2_density_factor) / 3.0f;
-    }
-    const float area = area_tri_v3(v0_pos, v1_pos, v2_pos);
-
-    const int looptri_seed = noise::hash(looptri_index, seed);
-    RandomNumberGenerator looptri_rng(looptri_seed);
-
-    const float points_amount_fl = area * base_density * looptri_density_factor;
-    const float add_point_probability = fractf(points_amount_fl);
-    const bool add_point = add_point_probability > looptri_rng.get_float();
-    const int point_amount = (int)points_amount_fl + (int)add_point;
-
-    for (int i = 0; i < point_amount; i++) {
-      const float3 bary_coord = looptri_rng.get_barycentric_coordinates();
-      float3 point_pos;
-      interp_v3_v3v3v3(point_pos, v0_pos, v1_pos, v2_pos, bary_coord);
-      r_positions.append(point_pos);
-      r_bary_coords.append(bary_coord);
-      r_looptri_indices.append(looptri_index);
+  /* Every triangle has its own random number generator, so the number of points in every triangle
+   * can be computed first, and the points can then be added in parallel in the same order as when
+   * the triangles are processed one after another. */
+  Array<int> offsets(looptris.size() + 1);
+  threading::parallel_for(looptris.index_range(), 1024, [&](IndexRange range) {
+    for (const int looptri_index : range) {
+      const MLoopTri &looptri = looptris[looptri_index];
+      const int v0_loop = looptri.tri[0];
+      const int v1_loop = looptri.tri[1];
+      const int v2_loop = looptri.tri[2];
+      const int v0_index = mesh.mloop[v0_loop].v;
+      const int v1_index = mesh.mloop[v1_loop].v;
+      const int v2_index = mesh.mloop[v2_loop].v;
+      const float3 v0_pos = float3(mesh.mvert[v0_index].co);
+      const float3 v1_pos = float3(mesh.mvert[v1_index].co);
+      const float3 v2_pos = float3(mesh.mvert[v2_index].co);
+
+      float looptri_density_factor = 1.0f;
+      if (!density_factors.is_empty()) {
+        const float v0_density_factor = std::max(0.0f, density_factors[v0_loop]);
+        const float v1_density_factor = std::max(0.0f, density_factors[v1_loop]);
+        const float v2_density_factor = std::max(0.0f, density_factors[v2_loop]);
+        looptri_density_factor = (v0_density_factor + v1_density_factor + v2_density_factor) /
+                                 3.0f;
+      }
+      const float area = area_tri_v3(v0_pos, v1_pos, v2_pos);
+
+      const int looptri_seed = noise::hash(looptri_index, seed);
+      RandomNumberGenerator looptri_rng(looptri_seed);
+
+      const float points_amount_fl = area * base_density * looptri_density_factor;
+      const float add_point_probability = fractf(points_amount_fl);
+      const bool add_point = add_point_probability > looptri_rng.get_float();
+      offsets[looptri_index] = (int)points_amount_fl + (int)add_point;
     }
-  }
-}
-
-BLI_NOINLINE static KDTree_3d *build_kdtree(Span<float3> positions)
-{
-  KDTree_3d *kdtree = BLI_kdtree_3d_new(positions.size());
-
-  int i_point = 0;
-  for (const float3 position : positions) {
-    BLI_kdtree_3d_insert(kdtree, i_point, position);
-    i_point++;
-  }
-
-  BLI_kdtree_3d_balance(kdtree);
-  return kdtree;
-}
+  });
 
-BLI_NOINLINE static void update_elimination_mask_for_close_points(
-    Span<float3> positions, const float minimum_distance, MutableSpan<bool> elimination_mask)
-{
-  if (minimum_distance <= 0.0f) {
-    return;
+  int total_points = 0;
+  for (const int looptri_index : looptris.index_range()) {
+    const int point_amount = offsets[looptri_index];
+    offsets[looptri_index] = total_points;
+    total_points += point_amount;
   }
-
-  KDTree_3d *kdtree = build_kdtree(positions);
-
-  for (const int i : positions.index_range()) {
-    if (elimination_mask[i]) {
-      continue;
+  offsets.last() = total_points;
+
+  r_positions.resize(total_points);
+  r_bary_coords.resize(total_points);
+  r_looptri_indices.resize(total_points);
+
+  threading::parallel_for(looptris.index_range(), 1024, [&](IndexRange range) {
+    for (const int looptri_index : range) {
+      const IndexRange points_range(offsets[looptri_index],
+                                    offsets[looptri_index + 1] - offsets[looptri_index]);
+      if (points_range.size() == 0) {
+        continue;
+      }
+      const int looptri_seed = noise::hash(looptri_index, seed);
+      RandomNumberGenerator looptri_rng(looptri_seed);
+      /* Skip the random value used to compute the number of points above. */
+      looptri_rng.skip(1);
+
+      for (const int i : points_range) {
+        const float3 bary_coord = looptri_rng.get_barycentric_coordinates();
+        r_positions[i] = sample_looptri_point(mesh, looptris[looptri_index], bary_coord);
+        r_bary_coords[i] = bary_coord;
+        r_looptri_indices[i] = looptri_index;
+      }
     }
-
-    struct CallbackData {
-      int index;
-      MutableSpan<bool> elimination_mask;
-    } callback_data = {i, elimination_mask};
-
-    BLI_kdtree_3d_range_search_cb(
-        kdtree,
-        positions[i],
-        minimum_distance,
-        [](void *user_data, int index, const float *UNUSED(co), float UNUSED(dist_sq)) {
-          CallbackData &callback_data = *static_cast<CallbackData *>(user_data);
-          if (index != callback_data.index) {
-            callback_data.elimination_mask[index] = true;
-          }
-          return true;
-        },
-        &callback_data);
-  }
-
-  BLI_kdtree_3d_free(kdtree);
+  });
 }
 
 BLI_NOINLINE static void update_elimination_mask_based_on_density_factors(
@@ -203,30 +197,33 @@ BLI_NOINLINE static void update_elimination_mask_based_on_density_factors(
 {
   const Span<MLoopTri> looptris{BKE_mesh_runtime_looptri_ensure(&mesh),
                                 BKE_mesh_runtime_looptri_len(&mesh)};
-  for (const int i : bary_coords.index_range()) {
-    if (elimination_mask[i]) {
-      continue;
-    }
+  threading::parallel_for(bary_coords.index_range(), 2048, [&](IndexRange range) {
+    for (const int i : range) {
+      if (elimination_mask[i]) {
+        continue;
+      }
 
-    const MLoopTri &looptri = looptris[looptri_indices[i]];
-    const float3 bary_coord = bary_coords[i];
+      const MLoopTri &looptri = looptris[looptri_indices[i]];
+      const float3 bary_coord = bary_coords[i];
 
-    const int v0_loop = looptri.tri[0];
-    const int v1_loop = looptri.tri[1];
-    const int v2_loop = looptri.tri[2];
+      const int v0_loop = looptri.tri[0];
+      const int v1_loop = looptri.tri[1];
+      const int v2_loop = looptri.tri[2];
 
-    const float v0_density_factor = std::max(0.0f, density_factors[v0_loop]);
-    const float v1_density_factor = std::max(0.0f, density_factors[v1_loop]);
-    const float v2_density_factor = std::max(0.0f, density_factors[v2_loop]);
+      const float v0_density_factor = std::max(0.0f, density_factors[v0_loop]);
+      const float v1_density_factor = std::max(0.0f, density_factors[v1_loop]);
+      const float v2_density_factor = std::max(0.0f, density_factors[v2_loop]);
 
-    const float probablity = v0_density_factor * bary_coord.x + v1_density_factor * bary_coord.y +
-                             v2_density_factor * bary_coord.z;
+      const float probablity = v0_density_factor * bary_coord.x +
+                               v1_density_factor * bary_coord.y +
+                               v2_density_factor * bary_coord.z;
 
-    const float hash = noise::hash_float_to_float(bary_coord);
-    if (hash > probablity) {
-      elimination_mask[i] = true;
+      const float hash = noise::hash_float_to_float(bary_coord);
+      if (hash > probablity) {
+        elimination_mask[i] = true;
+      }
     }
-  }
+  });
 }
 
 BLI_NOINLINE static void eliminate_points_based_on_mask(const Span<bool> elimination_mask,
@@ -355,31 +352,33 @@ BLI_NOINLINE static void compute_attribute_outputs(const MeshComponent &mesh_com
   const Span<MLoopTri> looptris{BKE_mesh_runtime_looptri_ensure(&mesh),
                                 BKE_mesh_runtime_looptri_len(&mesh)};
 
-  for (const int i : bary_coords.index_range()) {
-    const int looptri_index = looptri_indices[i];
-    const MLoopTri &looptri = looptris[looptri_index];
-    const float3 &bary_coord = bary_coords[i];
-
-    const int v0_index = mesh.mloop[looptri.tri[0]].v;
-    const int v1_index = mesh.mloop[looptri.tri[1]].v;
-    const int v2_index = mesh.mloop[looptri.tri[2]].v;
-    const float3 v0_pos = float3(mesh.mvert[v0_index].co);
-    const float3 v1_pos = float3(mesh.mvert[v1_index].co);
-    const float3 v2_pos = float3(mesh.mvert[v2_index].co);
-
-    ids[i] = noise::hash(noise::hash_float(bary_coord), looptri_index);
-
-    float3 normal;
-    if (!normals.is_empty() || !rotations.is_empty()) {
-      normal_tri_v3(normal, v0_pos, v1_pos, v2_pos);
-    }
-    if (!normals.is_empty()) {
-      normals[i] = normal;
-    }
-    if (!rotations.is_empty()) {
-      rotations[i] = normal_to_euler_rotation(normal);
+  threading::parallel_for(bary_coords.index_range(), 2048, [&](IndexRange range) {
+    for (const int i : range) {
+      const int looptri_index = looptri_indices[i];
+      const MLoopTri &looptri = looptris[looptri_index];
+      const float3 &bary_coord = bary_coords[i];
+
+      const int v0_index = mesh.mloop[looptri.tri[0]].v;
+      const int v1_index = mesh.mloop[looptri.tri[1]].v;
+      const int v2_index = mesh.mloop[looptri.tri[2]].v;
+      const float3 v0_pos = float3(mesh.mvert[v0_index].co);
+      const float3 v1_pos = float3(mesh.mvert[v1_index].co);
+      const float3 v2_pos = float3(mesh.mvert[v2_index].co);
+
+      ids[i] = noise::hash(noise::hash_float(bary_coord), looptri_index);
+
+      float3 normal;
+      if (!normals.is_empty() || !rotations.is_empty()) {
+        normal_tri_v3(normal, v0_pos, v1_pos, v2_pos);
+      }
+      if (!normals.is_empty()) {
+        normals[i] = normal;
+      }
+      if (!rotations.is_empty()) {
+        rotations[i] = normal_to_euler_rotation(normal);
+      }
     }
-  }
+  });
 
   id_attribute.save();
 
@@ -440,7 +439,7 @@ static void distribute_points_poisson_disk(const MeshComponent &mesh_component,
   sample_mesh_surface(mesh, max_density, {}, seed, positions, bary_coords, looptri_indices);
 
   Array<bool> elimination_mask(positions.size(), false);
-  update_elimination_mask_for_close_points(positions, minimum_distance, elimination_mask);
+  geometry::eliminate_close_points(positions, minimum_distance, elimination_mask);
 
   const Array<float> density_factors = calc_full_density_factors_with_selection(
       mesh_component, density_factor_field, selection_field);
@@ -44,6 +44,7 @@ ModifierLog::ModifierLog(GeoLogger &logger)
   LogByTreeContext log_by_tree_context;
 
   /* Combine all the local loggers that have been used by separate threads. */
+  int thread_index = 0;
   for (LocalGeoLogger &local_logger : logger) {
     /* Take ownership of the allocator. */
     logger_allocators_.append(std::move(local_logger.allocator_));
@@ -70,13 +71,21 @@ ModifierLog::ModifierLog(GeoLogger &logger)
     for (NodeWithExecutionTime &node_with_exec_time : local_logger.node_exec_times_) {
       NodeLog &node_log = this->lookup_or_add_node_log(log_by_tree_context,
                                                        node_with_exec_time.node);
-      node_log.exec_time_ = node_with_exec_time.exec_time;
+      node_log.exec_time_ += node_with_exec_time.exec_time;
+      node_log.exec_count_++;
+      if (node_log.exec_thread_ == -1 ||
+          node_with_exec_time.exec_time > node_log.longest_exec_time_) {
+        node_log.longest_exec_time_ = node_with_exec_time.exec_time;
+        node_log.exec_thread_ = thread_index;
+      }
     }
 
     for (NodeWithDebugMessage &debug_message : local_logger.node_debug_messages_) {
       NodeLog &node_log = this->lookup_or_add_node_log(log_by_tree_context, debug_message.node);
       node_log.debug_messages_.append(debug_message.message);
     }
+
+    thread_index++;
   }
 }
 
@@ -189,6 +198,33 @@ const SocketLog *NodeLog::lookup_socket_log(const bNode &node, const bNodeSocket
   return this->lookup_socket_log((eNodeSocketInOut)socket.in_out, index);
 }
 
+int64_t NodeLog::geometry_elements_num(eNodeSocketInOut in_out) const
+{
+  int64_t elements_num = 0;
+  for (const SocketLog &socket_log : (in_out == SOCK_IN) ? input_logs_ : output_logs_) {
+    const GeometryValueLog *geo_value_log = dynamic_cast<const GeometryValueLog *>(
+        socket_log.value());
+    if (geo_value_log == nullptr) {
+      continue;
+    }
+    if (geo_value_log->mesh_info) {
+      elements_num += geo_value_log->mesh_info->tot_verts;
+      elements_num += geo_value_log->mesh_info->tot_edges;
+      elements_num += geo_value_log->mesh_info->tot_faces;
+    }
+    if (geo_value_log->curve_info) {
+      elements_num += geo_value_log->curve_info->tot_splines;
+    }
+    if (geo_value_log->pointcloud_info) {
+      elements_num += geo_value_log->pointcloud_info->tot_points;
+    }
+    if (geo_value_log->instances_info) {
+      elements_num += geo_value_log->instances_info->tot_instances;
+    }
+  }
+  return elements_num;
+}
+
 GFieldValueLog::GFieldValueLog(fn::GField field, bool log_full_field) : type_(field.cpp_type())
 {
   Set<std::reference_wrapper<const FieldInput>> field_inputs_set;
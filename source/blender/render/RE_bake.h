@@ -87,6 +87,11 @@ bool RE_bake_engine(struct Render *re,
                     const eScenePassType pass_type,
                     const int pass_filter,
                     float result[]);
+/**
+ * Free the engine kept alive by #RE_bake_engine, must be called before the depsgraph that was
+ * used for baking is freed.
+ */
+void RE_bake_engine_free(struct Render *re);
 
 /* bake.c */
 int RE_pass_depth(const eScenePassType pass_type);
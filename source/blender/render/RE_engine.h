@@ -77,6 +77,7 @@ extern "C" {
 #define RE_ENGINE_RENDERING 16
 #define RE_ENGINE_HIGHLIGHT_TILES 32
 #define RE_ENGINE_CAN_DRAW 64
+#define RE_ENGINE_BAKING 128
 
 extern ListBase R_engines;
 
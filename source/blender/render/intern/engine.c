@@ -817,6 +817,11 @@ bool RE_bake_engine(Render *re,
   /* render */
   engine = re->engine;
 
+  if (engine && (engine->flag & RE_ENGINE_BAKING) && engine->depsgraph != depsgraph) {
+    RE_bake_engine_free(re);
+    engine = NULL;
+  }
+
   if (!engine) {
     engine = RE_engine_create(type);
     re->engine = engine;
@@ -831,11 +836,17 @@ bool RE_bake_engine(Render *re,
   engine->resolution_y = re->winy;
 
   if (type->bake) {
-    engine->depsgraph = depsgraph;
-
-    /* update is only called so we create the engine.session */
-    if (type->update) {
-      type->update(engine, re->main, engine->depsgraph);
+    /* The engine is kept alive for following bakes with the same depsgraph, for example of other
+     * selected objects or images, so the scene is only synchronized once and the engine can reuse
+     * its acceleration structures. */
+    if (!(engine->flag & RE_ENGINE_BAKING)) {
+      engine->flag |= RE_ENGINE_BAKING;
+      engine->depsgraph = depsgraph;
+
+      /* update is only called so we create the engine.session */
+      if (type->update) {
+        type->update(engine, re->main, engine->depsgraph);
+      }
     }
 
     for (int i = 0; i < targets->num_images; i++) {
@@ -853,16 +864,16 @@ bool RE_bake_engine(Render *re,
 
       memset(&engine->bake, 0, sizeof(engine->bake));
     }
-
-    engine->depsgraph = NULL;
   }
 
   engine->flag &= ~RE_ENGINE_RENDERING;
 
-  engine_depsgraph_free(engine);
+  if (!(engine->flag & RE_ENGINE_BAKING)) {
+    engine_depsgraph_free(engine);
 
-  RE_engine_free(engine);
-  re->engine = NULL;
+    RE_engine_free(engine);
+    re->engine = NULL;
+  }
 
   if (BKE_reports_contain(re->reports, RPT_ERROR)) {
     G.is_break = true;
@@ -871,6 +882,21 @@ bool RE_bake_engine(Render *re,
   return true;
 }
 
+void RE_bake_engine_free(Render *re)
+{
+  RenderEngine *engine = re->engine;
+
+  if (engine == NULL || !(engine->flag & RE_ENGINE_BAKING)) {
+    return;
+  }
+
+  /* The depsgraph is owned by the caller. */
+  engine->depsgraph = NULL;
+
+  RE_engine_free(engine);
+  re->engine = NULL;
+}
+
 /* Render */
 
 static void engine_render_view_layer(Render *re,